@@ -1,10 +1,20 @@
 #include <rapidio.hpp>
+#include <DelimitedReader.hpp>
+#include <ExternalSort.hpp>
+#include <PackFile.hpp>
+#include <SortedTable.hpp>
+#include <WindowCache.hpp>
 
+#include "testutils/PerfCounters.h"
 #include "testutils/UniqueDirectory.h"
 
+#include <atomic>
 #include <numeric>
 #include <chrono>
 #include <fstream>
+#include <map>
+#include <random>
+#include <thread>
 #include <vector>
 
 static int NR_ITERATIONS = 100;
@@ -15,6 +25,9 @@ static constexpr std::string_view ALPHABET = "abcdefghijklmnopqrstuvwxyz";
 
 using Clock = std::chrono::steady_clock;
 
+// Enabled by passing --counters, sampled around every run of the benchmark cases below
+static PerfCounters Counters{ false };
+
 uint64_t GetAverageTime(std::vector<uint64_t>&& vec)
 {
 	std::sort(vec.begin(), vec.end());
@@ -36,12 +49,15 @@ uint64_t BenchmarkWriteTests(std::function<void(fs::path, std::string)> Func)
 	BigFileData += std::string(BIG_FILE_SIZE, ALPHABET[rand() % ALPHABET.size()]);
 
 	UniqueDirectory Dir{ "rapidioperformance" };
+	Counters.Reset();
 
 	for (int i{}; i < NR_ITERATIONS; ++i)
 	{
+		Counters.Start();
 		Clock::time_point start = Clock::now();
 		Func(Dir.GetPath(), BigFileData);
 		Times.push_back(std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count());
+		Counters.Stop();
 
 		for (const auto& entry : fs::directory_iterator(Dir.GetPath()))
 		{
@@ -69,20 +85,81 @@ uint64_t BenchmarkReadTests(std::function<void(fs::path)> func)
 		view.Write(BigFileData);
 	}
 
+	Counters.Reset();
+
 	for (int i{}; i < NR_ITERATIONS; ++i)
 	{
+		Counters.Start();
 		Clock::time_point start = Clock::now();
 		func(Dir.GetPath());
 		times.push_back(std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count());
+		Counters.Stop();
+	}
+
+	return GetAverageTime(std::move(times));
+}
+
+uint64_t BenchmarkCopyKernel(rapidio::CopyKernel kernel, const std::string& source, char* destination)
+{
+	std::vector<uint64_t> times;
+	times.reserve(NR_ITERATIONS);
+
+	Counters.Reset();
+
+	for (int i{}; i < NR_ITERATIONS; ++i)
+	{
+		Counters.Start();
+		Clock::time_point start = Clock::now();
+		rapidio::StreamingCopy(destination, source.data(), source.size(), kernel);
+		times.push_back(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count());
+		Counters.Stop();
 	}
 
 	return GetAverageTime(std::move(times));
 }
 
-int main()
+// Returns how many passes over a cache-resident working set a second thread completes per millisecond, while 'kernel' copies 'source'
+uint64_t BenchmarkCachePollution(rapidio::CopyKernel kernel, const std::string& source, char* destination)
+{
+	constexpr size_t HotSetSize = 1024 * 1024; // 1 MB, fits in the last-level cache
+	std::vector<uint64_t> hotSet(HotSetSize / sizeof(uint64_t), 1);
+
+	std::atomic<bool> stop{ false };
+	std::atomic<uint64_t> passes{ 0 };
+
+	std::thread hotLoop([&hotSet, &stop, &passes]()
+		{
+			uint64_t checksum{};
+			while (!stop.load(std::memory_order_relaxed))
+			{
+				checksum += std::accumulate(hotSet.cbegin(), hotSet.cend(), uint64_t{ 0 });
+				passes.fetch_add(1, std::memory_order_relaxed);
+			}
+
+			// Keep the loop from being optimised away
+			hotSet[0] = checksum;
+		});
+
+	const Clock::time_point start = Clock::now();
+	for (int i{}; i < NR_ITERATIONS / 10; ++i)
+	{
+		rapidio::StreamingCopy(destination, source.data(), source.size(), kernel);
+	}
+
+	const uint64_t elapsed = std::max<uint64_t>(1, std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count());
+	stop = true;
+	hotLoop.join();
+
+	return passes / elapsed;
+}
+
+int main(int argc, char* argv[])
 {
 	using namespace rapidio;
 
+	Counters = PerfCounters{ argc > 1 && std::string_view(argv[1]) == "--counters" };
+	const uint64_t BytesProcessed = static_cast<uint64_t>(NR_ITERATIONS) * BIG_FILE_SIZE;
+
 	uint64_t RapidIOWriteNewFileTime{ BenchmarkWriteTests([](const fs::path& Path, const std::string& Data)
 		{
 			FileView View = FileView::CreateViewForNewFile(Path / NEW_BIG_FILE, BIG_FILE_SIZE).value();
@@ -91,6 +168,7 @@ int main()
 		}) };
 
 	std::cout << "Average RapidIO Time of creating new file of 100 MB over " << NR_ITERATIONS << " iterations: " << RapidIOWriteNewFileTime << "ms \n";
+	std::cout << Counters.Report(BytesProcessed);
 
 	uint64_t STLWriteNewFileTime{ BenchmarkWriteTests([](const fs::path& Path, const std::string& Data)
 		{
@@ -100,6 +178,7 @@ int main()
 		}) };
 
 	std::cout << "Average STL Time of creating new file of 100 MB over " << NR_ITERATIONS << " iterations: " << STLWriteNewFileTime << "ms \n";
+	std::cout << Counters.Report(BytesProcessed);
 
 	uint64_t RapidIOReadFileTime{ BenchmarkReadTests([](const fs::path& Path)
 		{
@@ -109,6 +188,7 @@ int main()
 		}) };
 
 	std::cout << "Average RapidIO Time of reading an existing file of 100 MB over " << NR_ITERATIONS << " iterations: " << RapidIOReadFileTime << "ms \n";
+	std::cout << Counters.Report(BytesProcessed);
 
 	uint64_t STLReadFileTime{ BenchmarkReadTests([](const fs::path& Path)
 		{
@@ -118,4 +198,591 @@ int main()
 		}) };
 
 	std::cout << "Average STL Time of reading an existing file of 100 MB over " << NR_ITERATIONS << " iterations: " << STLReadFileTime << "ms \n";
+	std::cout << Counters.Report(BytesProcessed);
+
+	for (const size_t NrOfThreads : { size_t{ 1 }, size_t{ 2 }, size_t{ 4 }, GetThreadCount(0) })
+	{
+		uint64_t RapidIOParallelWriteTime{ BenchmarkWriteTests([NrOfThreads](const fs::path& Path, const std::string& Data)
+			{
+				// Start from an empty file, so the parallel write has to extend the file and fault in every page itself
+				FileView View = FileView::CreateViewForNewFile(Path / NEW_BIG_FILE, 1).value();
+
+				View.ParallelWrite(Data, 0, NrOfThreads);
+			}) };
+
+		std::cout << "Average RapidIO Time of writing a new file of 100 MB on " << NrOfThreads << " threads over " << NR_ITERATIONS << " iterations: "
+			<< RapidIOParallelWriteTime << "ms \n";
+		std::cout << Counters.Report(BytesProcessed);
+	}
+
+	{
+		const std::string Source(BIG_FILE_SIZE, ALPHABET[rand() % ALPHABET.size()]);
+
+		UniqueDirectory Dir{ "rapidioperformance" };
+		FileView View = FileView::CreateViewForNewFile(Dir.GetPath() / NEW_BIG_FILE, BIG_FILE_SIZE).value();
+
+		for (const CopyKernel Kernel : { CopyKernel::Memcpy, CopyKernel::SSE2, CopyKernel::AVX2, CopyKernel::AVX512 })
+		{
+			if (!IsCopyKernelSupported(Kernel))
+			{
+				continue;
+			}
+
+			const uint64_t CopyTime{ std::max<uint64_t>(1, BenchmarkCopyKernel(Kernel, Source, View.GetData())) };
+			std::cout << "Average " << GetCopyKernelName(Kernel) << " Time of copying 100 MB into a mapped file over " << NR_ITERATIONS << " iterations: "
+				<< CopyTime << "us (" << BIG_FILE_SIZE / CopyTime << " MB/s) \n";
+			std::cout << Counters.Report(BytesProcessed);
+
+			const uint64_t HotLoopRate{ BenchmarkCachePollution(Kernel, Source, View.GetData()) };
+			std::cout << "Hot loop passes per ms over a 1 MB working set while copying with " << GetCopyKernelName(Kernel) << ": " << HotLoopRate << "\n";
+		}
+	}
+
+	{
+		std::string Csv;
+		Csv.reserve(BIG_FILE_SIZE + 64);
+		for (size_t Row{}; Csv.size() < BIG_FILE_SIZE; ++Row)
+		{
+			Csv += std::to_string(Row) + ",some name,\"a quoted, field\",12.5,2024-01-01\n";
+		}
+
+		std::vector<uint64_t> Times;
+		for (int i{}; i < NR_ITERATIONS / 10; ++i)
+		{
+			Clock::time_point Start = Clock::now();
+			DelimitedReader Reader{ Csv, DelimitedReader::Options{} };
+			Times.push_back(std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - Start).count());
+		}
+
+		const uint64_t IndexTime{ std::max<uint64_t>(1, GetAverageTime(std::move(Times))) };
+		std::cout << "Average RapidIO Time of indexing a CSV of " << Csv.size() / (1024 * 1024) << " MB over " << NR_ITERATIONS / 10 << " iterations: "
+			<< IndexTime << "ms (" << Csv.size() / 1000 / IndexTime << " MB/s) \n";
+
+		// Splitting rows one by one, as a consumer of the index does
+		const DelimitedReader Reader{ Csv, DelimitedReader::Options{} };
+		std::vector<std::string_view> Fields;
+		Times.clear();
+		for (int i{}; i < NR_ITERATIONS / 10; ++i)
+		{
+			Clock::time_point Start = Clock::now();
+			for (size_t Row{}; Row < Reader.GetNrOfRows(); ++Row)
+			{
+				Reader.GetRow(Row, Fields);
+			}
+			Times.push_back(std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - Start).count());
+		}
+
+		const uint64_t SplitTime{ std::max<uint64_t>(1, GetAverageTime(std::move(Times))) };
+		std::cout << "Average RapidIO Time of splitting every row of a CSV of " << Csv.size() / (1024 * 1024) << " MB over " << NR_ITERATIONS / 10
+			<< " iterations: " << SplitTime << "ms (" << Csv.size() / 1000 / SplitTime << " MB/s) \n";
+	}
+
+	for (const bool ReserveAddressSpace : { false, true })
+	{
+		// Appending in 64 KB pieces grows the mapped view on every write, which re-maps the entire file unless address space is reserved
+		const uint64_t AppendTime{ BenchmarkWriteTests([ReserveAddressSpace](const fs::path& Path, const std::string& Data)
+			{
+				constexpr size_t PieceSize = 1024 * 64;
+
+				FileView View = FileView::CreateViewForNewFile(Path / NEW_BIG_FILE, PieceSize).value();
+				if (ReserveAddressSpace)
+				{
+					View.ReserveAddressSpace(BIG_FILE_SIZE);
+				}
+
+				for (size_t Offset{}; Offset < Data.size(); Offset += PieceSize)
+				{
+					View.Write(Data.substr(Offset, PieceSize), Offset);
+				}
+			}) };
+
+		std::cout << "Average RapidIO Time of appending 100 MB in 64 KB pieces " << (ReserveAddressSpace ? "with" : "without")
+			<< " reserved address space over " << NR_ITERATIONS << " iterations: " << AppendTime << "ms \n";
+		std::cout << Counters.Report(BytesProcessed);
+	}
+
+	{
+		// Small files make the cost of opening, re-mapping and closing views stand out, which is mostly handle bookkeeping
+		UniqueDirectory Dir{ "rapidioperformance" };
+		FileView::CreateViewForNewFile(Dir.GetPath() / BIG_FILE, 1024 * 1024).value().Write(std::string(1024 * 1024, 'a'));
+
+		const int NrOfOpens = NR_ITERATIONS * 100;
+		Clock::time_point Start = Clock::now();
+
+		for (int i{}; i < NrOfOpens; ++i)
+		{
+			FileView View = FileView::CreateViewFromExistingFile(Dir.GetPath() / BIG_FILE, FileAccessMode::ReadOnly, FileOpenMode::OpenExisting, 4096).value();
+			View.Read(8192);
+		}
+
+		const uint64_t OpenTime = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - Start).count() / NrOfOpens;
+		std::cout << "Average RapidIO Time of opening, re-mapping and closing a 1 MB file over " << NrOfOpens << " iterations: " << OpenTime
+			<< "ns (sizeof(FileView) = " << sizeof(FileView) << ") \n";
+	}
+
+	{
+		// Small reads are dominated by the checks around the copy, a ReadOnlyFileView folds away everything that only applies to writable views
+		UniqueDirectory Dir{ "rapidioperformance" };
+		FileView::CreateViewForNewFile(Dir.GetPath() / BIG_FILE, 1024 * 1024).value().Write(std::string(1024 * 1024, 'a'));
+
+		constexpr size_t ReadSize = 16;
+		const size_t NrOfReads = static_cast<size_t>(NR_ITERATIONS) * 1024 * 1024;
+
+		auto BenchmarkSmallReads = [NrOfReads](auto& View)
+			{
+				size_t Checksum{};
+				Clock::time_point Start = Clock::now();
+
+				for (size_t i{}; i < NrOfReads; ++i)
+				{
+					if (i % (1024 * 1024 / ReadSize) == 0)
+					{
+						View.Seek(0);
+					}
+
+					Checksum += View.ReadView(ReadSize).size();
+				}
+
+				const uint64_t ReadTime = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - Start).count() * 1000 / NrOfReads;
+				return Checksum == NrOfReads * ReadSize ? ReadTime : 0;
+			};
+
+		// Views open their file exclusively, so only one of them can exist at a time
+		uint64_t ReadTime{};
+		{
+			FileView View = FileView::CreateViewFromExistingFile(Dir.GetPath() / BIG_FILE, FileAccessMode::ReadOnly, FileOpenMode::OpenExisting).value();
+			ReadTime = BenchmarkSmallReads(View);
+		}
+
+		uint64_t ReadOnlyTime{};
+		{
+			ReadOnlyFileView View = ReadOnlyFileView::CreateViewFromExistingFile(Dir.GetPath() / BIG_FILE, FileOpenMode::OpenExisting).value();
+			ReadOnlyTime = BenchmarkSmallReads(View);
+		}
+
+		std::cout << "Average RapidIO Time of a " << ReadSize << " byte read through a FileView over " << NrOfReads << " iterations: " << ReadTime << "ps \n";
+		std::cout << "Average RapidIO Time of a " << ReadSize << " byte read through a ReadOnlyFileView over " << NrOfReads << " iterations: "
+			<< ReadOnlyTime << "ps \n";
+	}
+
+	{
+		// Lookups in a static table: opening a SortedTableReader only maps the file, the alternative is loading every entry into a std::map
+		UniqueDirectory Dir{ "rapidioperformance" };
+		const fs::path TablePath = Dir.GetPath() / "table.rio";
+
+		constexpr int NrOfEntries = 1024 * 1024;
+		auto MakeKey = [](int i)
+			{
+				std::string Key = std::to_string(i);
+				return "key" + std::string(8 - Key.size(), '0') + Key;
+			};
+
+		{
+			SortedTableWriter Writer = SortedTableWriter::Create(TablePath).value();
+			for (int i{}; i < NrOfEntries; ++i)
+			{
+				Writer.Add(MakeKey(i), std::string(32, static_cast<char>('a' + i % 26)));
+			}
+
+			Writer.Finish();
+		}
+
+		std::mt19937 Random{ 42 };
+		std::uniform_int_distribution<int> Distribution{ 0, NrOfEntries * 2 - 1 }; // Half of the lookups miss
+		std::vector<std::string> Keys;
+		for (int i{}; i < NR_ITERATIONS * 1000; ++i)
+		{
+			Keys.push_back(MakeKey(Distribution(Random)));
+		}
+
+		Clock::time_point Start = Clock::now();
+		const SortedTableReader Reader = SortedTableReader::Open(TablePath).value();
+		const uint64_t OpenTime = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - Start).count();
+
+		size_t NrOfHits{};
+		Start = Clock::now();
+		for (const std::string& Key : Keys)
+		{
+			NrOfHits += Reader.Get(Key).has_value();
+		}
+
+		const uint64_t GetTime = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - Start).count() / Keys.size();
+
+		Start = Clock::now();
+		std::map<std::string, std::string, std::less<>> Map;
+		for (const SortedTableEntry& Entry : Reader)
+		{
+			Map.emplace_hint(Map.end(), Entry.key, Entry.value);
+		}
+
+		const uint64_t LoadTime = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - Start).count();
+
+		size_t NrOfMapHits{};
+		Start = Clock::now();
+		for (const std::string& Key : Keys)
+		{
+			NrOfMapHits += Map.contains(Key);
+		}
+
+		const uint64_t MapGetTime = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - Start).count() / Keys.size();
+
+		std::cout << "RapidIO Time of opening a sorted table of " << NrOfEntries << " entries: " << OpenTime << "us \n";
+		std::cout << "STL Time of loading a sorted table of " << NrOfEntries << " entries into a std::map: " << LoadTime << "us \n";
+		std::cout << "Average RapidIO Time of a sorted table lookup over " << Keys.size() << " iterations: " << GetTime << "ns ("
+			<< NrOfHits << " hits) \n";
+		std::cout << "Average STL Time of a std::map lookup over " << Keys.size() << " iterations: " << MapGetTime << "ns ("
+			<< NrOfMapHits << " hits) \n";
+	}
+
+	{
+		// Copying a multi-GB file: through std::strings, mapped view to mapped view, and block cloned where the volume supports it (ReFS, Dev Drive)
+		UniqueDirectory Dir{ "rapidioperformance" };
+		constexpr size_t CopyFileSize = 1024ull * 1024 * 1024 * 2; // 2 GB
+		constexpr size_t ChunkSize = 1024 * 1024 * 64; // 64 MB
+
+		{
+			FileView View = FileView::CreateViewForNewFile(Dir.GetPath() / BIG_FILE, CopyFileSize).value();
+			const std::string Chunk(ChunkSize, 'a');
+			for (size_t Offset{}; Offset < CopyFileSize; Offset += ChunkSize)
+			{
+				View.Write(Chunk, Offset);
+			}
+		}
+
+		const int NrOfCopies = std::max(1, NR_ITERATIONS / 20);
+		auto BenchmarkCopy = [&Dir, NrOfCopies](const std::function<void(ReadOnlyFileView&, FileView&)>& Copy)
+			{
+				std::vector<uint64_t> Times;
+				for (int i{}; i < NrOfCopies; ++i)
+				{
+					{
+						ReadOnlyFileView Source = ReadOnlyFileView::CreateViewFromExistingFile(Dir.GetPath() / BIG_FILE, FileOpenMode::OpenExisting).value();
+						// Pre-size the destination, so no variant pays for growing it inside the timed copy
+						FileView Destination = FileView::CreateViewForNewFile(Dir.GetPath() / NEW_BIG_FILE, CopyFileSize).value();
+
+						Clock::time_point Start = Clock::now();
+						Copy(Source, Destination);
+						Times.push_back(std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - Start).count());
+					}
+
+					fs::remove(Dir.GetPath() / NEW_BIG_FILE);
+				}
+
+				return std::accumulate(Times.cbegin(), Times.cend(), 0ULL) / Times.size();
+			};
+
+		const uint64_t ReadWriteTime = BenchmarkCopy([](ReadOnlyFileView& Source, FileView& Destination)
+			{
+				for (size_t Offset{}; Offset < CopyFileSize; Offset += ChunkSize)
+				{
+					Destination.Write(Source.Read(ChunkSize), Offset);
+				}
+			});
+
+		const uint64_t MappedCopyTime = BenchmarkCopy([](ReadOnlyFileView& Source, FileView& Destination) { Source.CopyTo(Destination, false); });
+		const uint64_t CopyToTime = BenchmarkCopy([](ReadOnlyFileView& Source, FileView& Destination) { Source.CopyTo(Destination); });
+
+		std::cout << "Average RapidIO Time of copying 2 GB with Read() and Write() over " << NrOfCopies << " iterations: " << ReadWriteTime << "ms \n";
+		std::cout << "Average RapidIO Time of copying 2 GB from mapped view to mapped view over " << NrOfCopies << " iterations: " << MappedCopyTime << "ms \n";
+		std::cout << "Average RapidIO Time of copying 2 GB with CopyTo() (block cloned if supported) over " << NrOfCopies << " iterations: "
+			<< CopyToTime << "ms \n";
+	}
+
+	{
+		// Random 4 KB reads across many files: opening a view for every read, against a bounded cache of mapped windows
+		UniqueDirectory Dir{ "rapidioperformance" };
+		constexpr int NrOfFiles = 64;
+		constexpr size_t FileSize = 1024 * 1024 * 16; // 16 MB
+		constexpr size_t ReadSize = 1024 * 4;
+
+		for (int i{}; i < NrOfFiles; ++i)
+		{
+			FileView::CreateViewForNewFile(Dir.GetPath() / (std::to_string(i) + ".txt"), FileSize).value().Write(std::string(FileSize, ALPHABET[i % ALPHABET.size()]));
+		}
+
+		// Like most query loads, 90% of the reads go to a hot eighth of every file
+		std::mt19937 Random{ 42 };
+		std::vector<std::pair<int, size_t>> Reads;
+		for (int i{}; i < NR_ITERATIONS * 1000; ++i)
+		{
+			const size_t Range = Random() % 10 == 0 ? FileSize - ReadSize : FileSize / 8 - ReadSize;
+			Reads.emplace_back(static_cast<int>(Random() % NrOfFiles), Random() % Range);
+		}
+
+		std::string Buffer(ReadSize, '\0');
+		size_t Checksum{};
+
+		Clock::time_point Start = Clock::now();
+		for (const auto& [File, Offset] : Reads)
+		{
+			ReadOnlyFileView View = ReadOnlyFileView::CreateViewFromExistingFile(Dir.GetPath() / (std::to_string(File) + ".txt"), FileOpenMode::OpenExisting).value();
+			View.Seek(Offset);
+			Checksum += View.ReadView(ReadSize).size();
+		}
+
+		const uint64_t ViewTime = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - Start).count() / Reads.size();
+
+		// A quarter of the data fits in the budget, with fewer files open than there are files
+		WindowCache Cache{ { .windowSize = 1024 * 1024, .maxMappedBytes = NrOfFiles * FileSize / 4, .maxWindows = 1024, .maxOpenFiles = NrOfFiles / 4 } };
+		std::vector<uint32_t> FileIds;
+		for (int i{}; i < NrOfFiles; ++i)
+		{
+			FileIds.push_back(Cache.AddFile(Dir.GetPath() / (std::to_string(i) + ".txt")).value());
+		}
+
+		Start = Clock::now();
+		for (const auto& [File, Offset] : Reads)
+		{
+			Checksum += Cache.Read(FileIds[File], Offset, Buffer.data(), ReadSize) ? ReadSize : 0;
+		}
+
+		const uint64_t CacheTime = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - Start).count() / Reads.size();
+
+		std::cout << "Average RapidIO Time of a random " << ReadSize << " byte read across " << NrOfFiles << " files, opening a view per read, over "
+			<< Reads.size() << " iterations: " << ViewTime << "ns \n";
+		std::cout << "Average RapidIO Time of a random " << ReadSize << " byte read across " << NrOfFiles << " files through a WindowCache over "
+			<< Reads.size() << " iterations: " << CacheTime << "ns (" << Checksum / ReadSize << " reads) \n";
+	}
+
+	{
+		// Sequential scans in 5 MB chunks: a new string per chunk with Read(), against spans from Chunks() that release what has been scanned
+		constexpr size_t ChunkSize = 1024 * 1024 * 5;
+		double ReadResidentFraction{};
+		double ChunksResidentFraction{};
+		size_t Checksum{}; // Makes sure every chunk is actually read
+
+		const uint64_t ReadScanTime{ BenchmarkReadTests([&ReadResidentFraction, &Checksum](const fs::path& Path)
+			{
+				ReadOnlyFileView View = ReadOnlyFileView::CreateViewFromExistingFile(Path / BIG_FILE, FileOpenMode::OpenExisting).value();
+
+				for (std::string Data = View.Read(ChunkSize); !Data.empty(); Data = View.Read(ChunkSize))
+				{
+					Checksum += static_cast<unsigned char>(Data.back());
+				}
+
+				ReadResidentFraction = View.ResidentFraction();
+			}) };
+
+		const uint64_t ChunksScanTime{ BenchmarkReadTests([&ChunksResidentFraction, &Checksum](const fs::path& Path)
+			{
+				ReadOnlyFileView View = ReadOnlyFileView::CreateViewFromExistingFile(Path / BIG_FILE, FileOpenMode::OpenExisting).value();
+
+				for (const std::span<const char> Chunk : View.Chunks(ChunkSize))
+				{
+					Checksum += static_cast<unsigned char>(Chunk.back());
+				}
+
+				ChunksResidentFraction = View.ResidentFraction();
+			}) };
+
+		std::cout << "Average RapidIO Time of scanning 100 MB in 5 MB chunks with Read() over " << NR_ITERATIONS << " iterations: " << ReadScanTime
+			<< "ms (" << ReadResidentFraction * 100 << "% still resident) \n";
+		std::cout << "Average RapidIO Time of scanning 100 MB in 5 MB chunks with Chunks() over " << NR_ITERATIONS << " iterations: " << ChunksScanTime
+			<< "ms (" << ChunksResidentFraction * 100 << "% still resident) \n";
+	}
+
+	{
+		// Sorting 1 GB of 16 byte records with a 256 MB budget, on one thread and on every hardware thread, against sorting all of it in memory
+		UniqueDirectory Dir{ "rapidioperformance" };
+		constexpr size_t NrOfRecords = 1024 * 1024 * 64;
+		constexpr size_t RecordSize = sizeof(uint64_t) * 2;
+		constexpr size_t MemoryBudget = 1024 * 1024 * 256; // 256 MB
+
+		{
+			FileView View = FileView::CreateViewForNewFile(Dir.GetPath() / BIG_FILE, NrOfRecords * RecordSize).value();
+			uint64_t* Records = reinterpret_cast<uint64_t*>(View.GetData());
+
+			std::mt19937_64 Random{ 42 };
+			for (size_t i{}; i < NrOfRecords; ++i)
+			{
+				Records[i * 2] = Random();
+				Records[i * 2 + 1] = i;
+			}
+		}
+
+		auto GetKey = [](std::span<const char> Record)
+			{
+				uint64_t Key;
+				std::memcpy(&Key, Record.data(), sizeof(Key));
+				return Key;
+			};
+
+		const int NrOfSorts = std::max(1, NR_ITERATIONS / 20);
+		auto BenchmarkSort = [&Dir, NrOfSorts](const std::function<void(const fs::path&, const fs::path&)>& Sort)
+			{
+				std::vector<uint64_t> Times;
+				for (int i{}; i < NrOfSorts; ++i)
+				{
+					Clock::time_point Start = Clock::now();
+					Sort(Dir.GetPath() / BIG_FILE, Dir.GetPath() / NEW_BIG_FILE);
+					Times.push_back(std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - Start).count());
+
+					fs::remove(Dir.GetPath() / NEW_BIG_FILE);
+				}
+
+				return std::accumulate(Times.cbegin(), Times.cend(), 0ULL) / Times.size();
+			};
+
+		const uint64_t InMemoryTime = BenchmarkSort([](const fs::path& Input, const fs::path& Output)
+			{
+				struct Record
+				{
+					uint64_t Key;
+					uint64_t Sequence;
+				};
+
+				std::vector<Record> Records(NrOfRecords);
+				{
+					std::ifstream File{ Input, std::ios::binary };
+					File.read(reinterpret_cast<char*>(Records.data()), NrOfRecords * RecordSize);
+				}
+
+				std::stable_sort(Records.begin(), Records.end(), [](const Record& Lhs, const Record& Rhs) { return Lhs.Key < Rhs.Key; });
+
+				std::ofstream File{ Output, std::ios::binary };
+				File.write(reinterpret_cast<const char*>(Records.data()), NrOfRecords * RecordSize);
+			});
+
+		const uint64_t SingleThreadTime = BenchmarkSort([&GetKey](const fs::path& Input, const fs::path& Output)
+			{
+				ExternalSort(Input, RecordSize, GetKey, MemoryBudget, { .outputPath = Output, .nrOfThreads = 1 });
+			});
+
+		const uint64_t MultiThreadTime = BenchmarkSort([&GetKey](const fs::path& Input, const fs::path& Output)
+			{
+				ExternalSort(Input, RecordSize, GetKey, MemoryBudget, { .outputPath = Output });
+			});
+
+		std::cout << "Average STL Time of sorting 1 GB of records in memory over " << NrOfSorts << " iterations: " << InMemoryTime << "ms \n";
+		std::cout << "Average RapidIO Time of sorting 1 GB of records in 256 MB on 1 thread over " << NrOfSorts << " iterations: " << SingleThreadTime << "ms \n";
+		std::cout << "Average RapidIO Time of sorting 1 GB of records in 256 MB on " << GetThreadCount(0) << " threads over " << NrOfSorts << " iterations: "
+			<< MultiThreadTime << "ms \n";
+	}
+
+	{
+		// Loading thousands of small files at startup: a view per file, against a single pack mapped once
+		UniqueDirectory Dir{ "rapidioperformance" };
+		constexpr int NrOfFiles = 4096;
+		constexpr size_t FileSize = 1024 * 2;
+
+		{
+			PackWriter Writer = PackWriter::Create(Dir.GetPath() / "assets.pack").value();
+			for (int i{}; i < NrOfFiles; ++i)
+			{
+				const std::string Data(FileSize, ALPHABET[i % ALPHABET.size()]);
+				FileView::CreateViewForNewFile(Dir.GetPath() / (std::to_string(i) + ".json"), FileSize).value().Write(Data);
+				Writer.Add(std::to_string(i) + ".json", Data);
+			}
+
+			Writer.Finish();
+		}
+
+		std::vector<std::string> Names;
+		for (int i{}; i < NrOfFiles; ++i)
+		{
+			Names.push_back(std::to_string(i) + ".json");
+		}
+
+		const int NrOfLoads = std::max(1, NR_ITERATIONS / 10);
+		size_t Checksum{}; // Makes sure every file is actually read
+		std::vector<uint64_t> ViewTimes;
+		std::vector<uint64_t> PackTimes;
+
+		for (int i{}; i < NrOfLoads; ++i)
+		{
+			Clock::time_point Start = Clock::now();
+			for (const std::string& Name : Names)
+			{
+				const ReadOnlyFileView View = ReadOnlyFileView::CreateViewFromExistingFile(Dir.GetPath() / Name, FileOpenMode::OpenExisting).value();
+				Checksum += static_cast<unsigned char>(View.GetData()[View.GetMappedSize() - 1]);
+			}
+
+			ViewTimes.push_back(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - Start).count());
+
+			Start = Clock::now();
+			const PackReader Reader = PackReader::Open(Dir.GetPath() / "assets.pack").value();
+			for (const std::string& Name : Names)
+			{
+				Checksum += static_cast<unsigned char>(Reader.Get(Name)->back());
+			}
+
+			PackTimes.push_back(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - Start).count());
+		}
+
+		std::cout << "Average RapidIO Time of opening " << NrOfFiles << " files of 2 KB with a view per file over " << NrOfLoads << " iterations: "
+			<< GetAverageTime(std::move(ViewTimes)) << "us \n";
+		std::cout << "Average RapidIO Time of opening a pack of " << NrOfFiles << " files of 2 KB and finding every file over " << NrOfLoads << " iterations: "
+			<< GetAverageTime(std::move(PackTimes)) << "us (" << Checksum << ") \n";
+	}
+
+	{
+		// Ingesting 100 MB of UTF-8 text with CRLF line endings: a scalar pass over a copy from Read(), against validating and normalizing the mapped bytes
+		UniqueDirectory Dir{ "rapidioperformance" };
+
+		{
+			std::string Text;
+			Text.reserve(BIG_FILE_SIZE + 64);
+			for (int i{}; Text.size() < BIG_FILE_SIZE; ++i)
+			{
+				Text += "Line " + std::to_string(i) + ": caf\xC3\xA9, 10\xE2\x82\xAC, \xF0\x9F\x98\x80 and some ASCII to go with it\r\n";
+			}
+
+			FileView::CreateViewForNewFile(Dir.GetPath() / BIG_FILE, Text.size()).value().Write(Text);
+		}
+
+		size_t Checksum{}; // Makes sure nothing is optimized away
+		std::vector<uint64_t> ScalarTimes;
+		std::vector<uint64_t> ValidateTimes;
+		std::vector<uint64_t> NormalizeTimes;
+
+		for (int i{}; i < NR_ITERATIONS / 10; ++i)
+		{
+			ReadOnlyFileView View = ReadOnlyFileView::CreateViewFromExistingFile(Dir.GetPath() / BIG_FILE, FileOpenMode::OpenExisting).value();
+
+			Clock::time_point Start = Clock::now();
+			{
+				const std::string Text = View.Read(View.GetMappedSize());
+
+				std::string Normalized;
+				Normalized.reserve(Text.size());
+				for (size_t Position{}; Position < Text.size(); ++Position)
+				{
+					// Lead bytes are only checked for being a valid lead, enough to compare against
+					const unsigned char Byte = static_cast<unsigned char>(Text[Position]);
+					Checksum += (Byte >= 0x80 && Byte < 0xC2) || Byte > 0xF4;
+
+					if (Text[Position] != '\r' || Position + 1 == Text.size() || Text[Position + 1] != '\n')
+					{
+						Normalized += Text[Position];
+					}
+				}
+
+				Checksum += Normalized.size();
+			}
+
+			ScalarTimes.push_back(std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - Start).count());
+
+			Start = Clock::now();
+			Checksum += View.ValidateUtf8().value_or(0);
+			ValidateTimes.push_back(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - Start).count());
+
+			{
+				FileView Destination = FileView::CreateViewForNewFile(Dir.GetPath() / NEW_BIG_FILE, 1).value();
+
+				Start = Clock::now();
+				Checksum += View.NormalizeLineEndings(Destination).value_or(0);
+				NormalizeTimes.push_back(std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - Start).count());
+			}
+
+			fs::remove(Dir.GetPath() / NEW_BIG_FILE);
+		}
+
+		const uint64_t ValidateTime = GetAverageTime(std::move(ValidateTimes));
+		std::cout << "Average STL Time of validating and normalizing 100 MB of text through a std::string over " << NR_ITERATIONS / 10 << " iterations: "
+			<< GetAverageTime(std::move(ScalarTimes)) << "ms \n";
+		std::cout << "Average RapidIO Time of validating 100 MB of UTF-8 with ValidateUtf8() over " << NR_ITERATIONS / 10 << " iterations: " << ValidateTime
+			<< "us (" << BIG_FILE_SIZE / std::max<uint64_t>(1, ValidateTime) << " MB/s) \n";
+		std::cout << "Average RapidIO Time of normalizing 100 MB of CRLF text with NormalizeLineEndings() over " << NR_ITERATIONS / 10 << " iterations: "
+			<< GetAverageTime(std::move(NormalizeTimes)) << "ms (" << Checksum % 10 << ") \n";
+	}
 }
\ No newline at end of file
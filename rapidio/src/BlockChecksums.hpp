@@ -0,0 +1,335 @@
+#pragma once
+
+#include "rapidio.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <optional>
+
+namespace rapidio
+{
+	namespace detail
+	{
+		constexpr char BlockChecksumsMagic[8] = { 'R', 'I', 'O', 'B', 'L', 'C', 'R', 'C' };
+		constexpr uint32_t BlockChecksumsVersion = 1;
+
+		struct BlockChecksumsHeader
+		{
+			char magic[8];
+			uint32_t version;
+			uint32_t blockSize;
+			uint64_t dataSize; // Number of bytes of the mapped view covered by the checksums
+		};
+	} // namespace detail
+
+	/// <summary>
+	/// Per-block CRC32C checksums of a mapped view, stored in a sidecar file. A read can verify only the blocks it touches with 'Verify()',
+	/// and a write only has to re-checksum the blocks it dirtied with 'Update()'. The sidecar is mapped, so updates are persisted in place
+	/// </summary>
+	class BlockChecksums final
+	{
+	public:
+		static constexpr size_t DefaultBlockSize = 1024 * 64; // 64 KB
+
+		/// <summary>
+		/// Checksums every block of 'view' and stores the checksums in a new sidecar file. An existing sidecar file is overwritten
+		/// </summary>
+		/// <param name="view">View to checksum</param>
+		/// <param name="sidecarPath">Path to the sidecar file</param>
+		/// <param name="blockSize">Number of bytes covered by a single checksum</param>
+		/// <param name="nrOfThreads">Number of threads to checksum with, 0 means every hardware thread</param>
+		/// <returns>std::nullopt if the sidecar file could not be created</returns>
+		template<FileAccessMode Access>
+		static std::optional<BlockChecksums> Create(const BasicFileView<Access>& view, const std::filesystem::path& sidecarPath, size_t blockSize = DefaultBlockSize,
+			size_t nrOfThreads = 0);
+
+		/// <summary>
+		/// Opens a sidecar file created by 'Create()'
+		/// </summary>
+		/// <returns>std::nullopt if the file is missing or is not a checksum sidecar file</returns>
+		static std::optional<BlockChecksums> Open(const std::filesystem::path& sidecarPath);
+
+		/// <summary>
+		/// Checks the blocks of 'view' overlapping 'range' against their stored checksums
+		/// </summary>
+		/// <param name="view">View the checksums were created for</param>
+		/// <param name="range">Range of the mapped view to verify</param>
+		/// <param name="nrOfThreads">Number of threads to verify with, 0 means every hardware thread</param>
+		/// <returns>Returns true if every touched block matches its checksum</returns>
+		template<FileAccessMode Access>
+		bool Verify(const BasicFileView<Access>& view, FileRange range = {}, size_t nrOfThreads = 1) const;
+
+		/// <summary>
+		/// Re-checksums the blocks of 'view' overlapping 'range', growing the sidecar if the view has grown past the checksummed data
+		/// </summary>
+		/// <param name="view">View the checksums were created for</param>
+		/// <param name="range">Range of the mapped view that was written to</param>
+		/// <param name="nrOfThreads">Number of threads to checksum with, 0 means every hardware thread</param>
+		/// <returns>Returns true if the checksums were updated</returns>
+		template<FileAccessMode Access>
+		bool Update(const BasicFileView<Access>& view, FileRange range, size_t nrOfThreads = 1);
+
+		/// <summary>
+		/// Writes 'data' to 'view' at 'offset' and updates the checksums of the blocks it touched
+		/// </summary>
+		template<IsBufferLike T>
+		bool Write(FileView& view, T&& data, size_t offset = 0);
+
+		size_t GetBlockSize() const;
+		size_t GetNrOfBlocks() const;
+
+		// Returns the number of bytes covered by the checksums
+		size_t GetDataSize() const;
+
+	private:
+		explicit BlockChecksums(FileView sidecar);
+
+		detail::BlockChecksumsHeader& GetHeader();
+		const detail::BlockChecksumsHeader& GetHeader() const;
+		uint32_t* GetChecksums();
+		const uint32_t* GetChecksums() const;
+
+		static size_t GetSidecarSize(size_t dataSize, size_t blockSize);
+		template<FileAccessMode Access>
+		void ComputeBlocks(const BasicFileView<Access>& view, size_t firstBlock, size_t lastBlock, size_t nrOfThreads);
+
+		FileView m_sidecar;
+	};
+
+	BlockChecksums::BlockChecksums(FileView sidecar)
+		: m_sidecar(std::move(sidecar))
+	{
+	}
+
+	template<FileAccessMode Access>
+	std::optional<BlockChecksums> BlockChecksums::Create(const BasicFileView<Access>& view, const std::filesystem::path& sidecarPath,
+		size_t blockSize /* = DefaultBlockSize */, size_t nrOfThreads /* = 0 */)
+	{
+		if (blockSize == 0 || blockSize > std::numeric_limits<uint32_t>::max())
+		{
+			std::cerr << "BlockChecksums::Create > Invalid block size " << blockSize << "\n";
+			return std::nullopt;
+		}
+
+		const size_t dataSize = view.GetMappedSize();
+
+		if (PathUtils::DoesFileExist(sidecarPath))
+		{
+			std::filesystem::remove(sidecarPath);
+		}
+
+		std::optional<FileView> sidecar = FileView::CreateViewForNewFile(sidecarPath, GetSidecarSize(dataSize, blockSize));
+		if (!sidecar)
+		{
+			return std::nullopt;
+		}
+
+		BlockChecksums checksums{ std::move(*sidecar) };
+
+		detail::BlockChecksumsHeader& header = checksums.GetHeader();
+		std::memcpy(header.magic, detail::BlockChecksumsMagic, sizeof(header.magic));
+		header.version = detail::BlockChecksumsVersion;
+		header.blockSize = static_cast<uint32_t>(blockSize);
+		header.dataSize = dataSize;
+
+		checksums.ComputeBlocks(view, 0, checksums.GetNrOfBlocks(), nrOfThreads);
+		return checksums;
+	}
+
+	std::optional<BlockChecksums> BlockChecksums::Open(const std::filesystem::path& sidecarPath)
+	{
+		std::optional<FileView> sidecar = FileView::CreateViewFromExistingFile(sidecarPath, FileAccessMode::ReadWrite, FileOpenMode::OpenExisting);
+		if (!sidecar)
+		{
+			return std::nullopt;
+		}
+
+		if (sidecar->GetMappedSize() < sizeof(detail::BlockChecksumsHeader))
+		{
+			std::cerr << "BlockChecksums::Open > " << sidecarPath << " is not a checksum sidecar file\n";
+			return std::nullopt;
+		}
+
+		BlockChecksums checksums{ std::move(*sidecar) };
+		const detail::BlockChecksumsHeader& header = checksums.GetHeader();
+
+		if (std::memcmp(header.magic, detail::BlockChecksumsMagic, sizeof(header.magic)) != 0 || header.version != detail::BlockChecksumsVersion ||
+			header.blockSize == 0)
+		{
+			std::cerr << "BlockChecksums::Open > " << sidecarPath << " is not a checksum sidecar file\n";
+			return std::nullopt;
+		}
+
+		if (checksums.m_sidecar.GetMappedSize() < GetSidecarSize(header.dataSize, header.blockSize))
+		{
+			std::cerr << "BlockChecksums::Open > " << sidecarPath << " is truncated\n";
+			return std::nullopt;
+		}
+
+		return checksums;
+	}
+
+	template<FileAccessMode Access>
+	bool BlockChecksums::Verify(const BasicFileView<Access>& view, FileRange range /* = {} */, size_t nrOfThreads /* = 1 */) const
+	{
+		if (range.size == 0)
+		{
+			return true;
+		}
+
+		if (range.offset >= view.GetMappedSize())
+		{
+			std::cerr << "BlockChecksums::Verify > Range starts past end of Mapped View\n";
+			return false;
+		}
+
+		const size_t end = std::min(view.GetMappedSize(), range.offset + std::min(range.size, view.GetMappedSize()));
+
+		if (end > GetDataSize())
+		{
+			std::cerr << "BlockChecksums::Verify > Range ends past the checksummed data\n";
+			return false;
+		}
+
+		const size_t blockSize = GetBlockSize();
+		const size_t firstBlock = range.offset / blockSize;
+		const size_t lastBlock = (end + blockSize - 1) / blockSize;
+
+		if (std::min(lastBlock * blockSize, GetDataSize()) > view.GetMappedSize())
+		{
+			std::cerr << "BlockChecksums::Verify > Mapped View is smaller than the checksummed data\n";
+			return false;
+		}
+
+		const uint32_t* const checksums = GetChecksums();
+		const char* const data = view.GetData();
+		const size_t dataSize = GetDataSize();
+
+		std::atomic<bool> isValid{ true };
+		ParallelFor(lastBlock - firstBlock, nrOfThreads, [&](size_t i)
+			{
+				const size_t block = firstBlock + i;
+				const size_t offset = block * blockSize;
+
+				if (Crc32c(data + offset, std::min(blockSize, dataSize - offset)) != checksums[block])
+				{
+					isValid.store(false, std::memory_order_relaxed);
+				}
+			});
+
+		return isValid;
+	}
+
+	template<FileAccessMode Access>
+	bool BlockChecksums::Update(const BasicFileView<Access>& view, FileRange range, size_t nrOfThreads /* = 1 */)
+	{
+		if (range.size == 0)
+		{
+			return true;
+		}
+
+		if (range.offset >= view.GetMappedSize())
+		{
+			std::cerr << "BlockChecksums::Update > Range starts past end of Mapped View\n";
+			return false;
+		}
+
+		const size_t end = std::min(view.GetMappedSize(), range.offset + std::min(range.size, view.GetMappedSize()));
+		const size_t blockSize = GetBlockSize();
+		size_t firstBlock = range.offset / blockSize;
+
+		if (end > GetDataSize())
+		{
+			// The old last block might have been partial, so it has to be re-checksummed with its new contents as well
+			firstBlock = std::min(firstBlock, GetNrOfBlocks() > 0 ? GetNrOfBlocks() - 1 : 0);
+
+			if (!m_sidecar.Reserve(GetSidecarSize(end, blockSize)))
+			{
+				return false;
+			}
+
+			GetHeader().dataSize = end;
+		}
+
+		const size_t lastBlock = (end + blockSize - 1) / blockSize;
+
+		if (std::min(lastBlock * blockSize, GetDataSize()) > view.GetMappedSize())
+		{
+			std::cerr << "BlockChecksums::Update > Mapped View is smaller than the checksummed data\n";
+			return false;
+		}
+
+		ComputeBlocks(view, firstBlock, lastBlock, nrOfThreads);
+		return true;
+	}
+
+	template<IsBufferLike T>
+	bool BlockChecksums::Write(FileView& view, T&& data, size_t offset /* = 0 */)
+	{
+		const size_t size = data.size();
+		if (!view.Write(std::forward<T>(data), offset))
+		{
+			return false;
+		}
+
+		return Update(view, { offset, size });
+	}
+
+	size_t BlockChecksums::GetBlockSize() const
+	{
+		return GetHeader().blockSize;
+	}
+
+	size_t BlockChecksums::GetNrOfBlocks() const
+	{
+		return (GetDataSize() + GetBlockSize() - 1) / GetBlockSize();
+	}
+
+	size_t BlockChecksums::GetDataSize() const
+	{
+		return static_cast<size_t>(GetHeader().dataSize);
+	}
+
+	detail::BlockChecksumsHeader& BlockChecksums::GetHeader()
+	{
+		return *reinterpret_cast<detail::BlockChecksumsHeader*>(m_sidecar.GetData());
+	}
+
+	const detail::BlockChecksumsHeader& BlockChecksums::GetHeader() const
+	{
+		return *reinterpret_cast<const detail::BlockChecksumsHeader*>(m_sidecar.GetData());
+	}
+
+	uint32_t* BlockChecksums::GetChecksums()
+	{
+		return reinterpret_cast<uint32_t*>(m_sidecar.GetData() + sizeof(detail::BlockChecksumsHeader));
+	}
+
+	const uint32_t* BlockChecksums::GetChecksums() const
+	{
+		return reinterpret_cast<const uint32_t*>(m_sidecar.GetData() + sizeof(detail::BlockChecksumsHeader));
+	}
+
+	size_t BlockChecksums::GetSidecarSize(size_t dataSize, size_t blockSize)
+	{
+		return sizeof(detail::BlockChecksumsHeader) + (dataSize + blockSize - 1) / blockSize * sizeof(uint32_t);
+	}
+
+	template<FileAccessMode Access>
+	void BlockChecksums::ComputeBlocks(const BasicFileView<Access>& view, size_t firstBlock, size_t lastBlock, size_t nrOfThreads)
+	{
+		const size_t blockSize = GetBlockSize();
+		const size_t dataSize = GetDataSize();
+		uint32_t* const checksums = GetChecksums();
+		const char* const data = view.GetData();
+
+		ParallelFor(lastBlock - firstBlock, nrOfThreads, [=](size_t i)
+			{
+				const size_t offset = (firstBlock + i) * blockSize;
+				checksums[firstBlock + i] = Crc32c(data + offset, std::min(blockSize, dataSize - offset));
+			});
+	}
+} // namespace rapidio
@@ -0,0 +1,155 @@
+#pragma once
+
+#include "CopyUtils.hpp"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+#if defined(RAPIDIO_X86) && !defined(_MSC_VER)
+#	include <nmmintrin.h>
+#endif
+
+namespace rapidio
+{
+	namespace detail
+	{
+		// CRC32C (Castagnoli) polynomial, bit-reversed
+		constexpr uint32_t Crc32cPolynomial = 0x82F63B78;
+
+		constexpr std::array<uint32_t, 256> MakeCrc32cTable()
+		{
+			std::array<uint32_t, 256> table{};
+			for (uint32_t i{}; i < 256; ++i)
+			{
+				uint32_t crc = i;
+				for (int bit{}; bit < 8; ++bit)
+				{
+					crc = (crc & 1) ? (crc >> 1) ^ Crc32cPolynomial : crc >> 1;
+				}
+
+				table[i] = crc;
+			}
+
+			return table;
+		}
+
+		inline constexpr std::array<uint32_t, 256> Crc32cTable = MakeCrc32cTable();
+
+		uint32_t Crc32cSoftware(uint32_t crc, const unsigned char* data, size_t size)
+		{
+			for (size_t i{}; i < size; ++i)
+			{
+				crc = Crc32cTable[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+			}
+
+			return crc;
+		}
+
+		#ifdef RAPIDIO_X86
+		bool HasHardwareCrc32c()
+		{
+			static const bool HasSSE42 = []()
+			{
+				int registers[4]{};
+				CpuId(1, 0, registers);
+				return (registers[2] & (1 << 20)) != 0;
+			}();
+
+			return HasSSE42;
+		}
+
+		RAPIDIO_TARGET("sse4.2")
+		uint32_t Crc32cHardware(uint32_t crc, const unsigned char* data, size_t size)
+		{
+			#if defined(_M_X64) || defined(__x86_64__)
+			uint64_t crc64 = crc;
+			for (; size >= 8; size -= 8, data += 8)
+			{
+				uint64_t value;
+				std::memcpy(&value, data, sizeof(value));
+				crc64 = _mm_crc32_u64(crc64, value);
+			}
+
+			crc = static_cast<uint32_t>(crc64);
+			#endif
+
+			for (; size >= 4; size -= 4, data += 4)
+			{
+				uint32_t value;
+				std::memcpy(&value, data, sizeof(value));
+				crc = _mm_crc32_u32(crc, value);
+			}
+
+			for (; size > 0; --size, ++data)
+			{
+				crc = _mm_crc32_u8(crc, *data);
+			}
+
+			return crc;
+		}
+		#endif // RAPIDIO_X86
+
+		// Multiplies two polynomials modulo the CRC polynomial
+		uint32_t MultiplyModCrc32c(uint32_t a, uint32_t b)
+		{
+			uint32_t product{};
+			for (uint32_t mask = 1u << 31; mask != 0; mask >>= 1)
+			{
+				if (a & mask)
+				{
+					product ^= b;
+				}
+
+				b = (b & 1) ? (b >> 1) ^ Crc32cPolynomial : b >> 1;
+			}
+
+			return product;
+		}
+	} // namespace detail
+
+	inline namespace ChecksumUtils
+	{
+		/// <summary>
+		/// Computes the CRC32C of 'size' bytes, using the SSE4.2 crc32 instruction when the CPU supports it.
+		/// Pass the result of a previous call as 'crc' to continue a checksum over multiple buffers
+		/// </summary>
+		uint32_t Crc32c(const void* data, size_t size, uint32_t crc = 0)
+		{
+			const unsigned char* const bytes = static_cast<const unsigned char*>(data);
+			crc = ~crc;
+
+			#ifdef RAPIDIO_X86
+			if (detail::HasHardwareCrc32c())
+			{
+				return ~detail::Crc32cHardware(crc, bytes, size);
+			}
+			#endif // RAPIDIO_X86
+
+			return ~detail::Crc32cSoftware(crc, bytes, size);
+		}
+
+		/// <summary>
+		/// Returns the CRC32C of two buffers back to back, given the CRC32C of both buffers and the size of the second one.
+		/// This allows checksumming blocks of a buffer in parallel
+		/// </summary>
+		uint32_t Crc32cCombine(uint32_t crc1, uint32_t crc2, size_t size2)
+		{
+			// Shift 'crc1' over 'size2' zero bytes by multiplying it with x^(8 * size2), built from repeated squares of x^8
+			uint32_t shift = 1u << 31; // x^0
+			uint32_t square = 1u << 23; // x^8
+
+			for (; size2 > 0; size2 >>= 1)
+			{
+				if (size2 & 1)
+				{
+					shift = detail::MultiplyModCrc32c(square, shift);
+				}
+
+				square = detail::MultiplyModCrc32c(square, square);
+			}
+
+			return detail::MultiplyModCrc32c(shift, crc1) ^ crc2;
+		}
+	} // inline namespace ChecksumUtils
+} // namespace rapidio
@@ -0,0 +1,294 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#	define RAPIDIO_X86
+#	include <immintrin.h>
+#	ifdef _MSC_VER
+#		include <intrin.h>
+#	else
+#		include <cpuid.h>
+#	endif // _MSC_VER
+#endif
+
+// MSVC allows intrinsics of any instruction set everywhere, GCC and Clang need the function to opt in to them
+#if defined(RAPIDIO_X86) && (defined(__GNUC__) || defined(__clang__))
+#	define RAPIDIO_TARGET(isa) __attribute__((target(isa)))
+#else
+#	define RAPIDIO_TARGET(isa)
+#endif
+
+namespace rapidio
+{
+	enum class CopyKernel
+	{
+		Memcpy, // Regular cached copy
+		SSE2,
+		AVX2,
+		AVX512
+	};
+
+	namespace detail
+	{
+		// Copies smaller than this are always done with a regular memcpy, non-temporal stores only pay off for large transfers
+		constexpr size_t MinStreamingCopySize = 1024 * 4; // 4 KB
+
+		inline std::atomic<size_t> StreamingCopyThreshold{ 1024 * 1024 * 4 }; // 4 MB
+
+		#ifdef RAPIDIO_X86
+		void CpuId(int leaf, int subleaf, int (&registers)[4])
+		{
+			#ifdef _MSC_VER
+			__cpuidex(registers, leaf, subleaf);
+			#else
+			unsigned int eax{}, ebx{}, ecx{}, edx{};
+			__get_cpuid_count(static_cast<unsigned int>(leaf), static_cast<unsigned int>(subleaf), &eax, &ebx, &ecx, &edx);
+			registers[0] = static_cast<int>(eax);
+			registers[1] = static_cast<int>(ebx);
+			registers[2] = static_cast<int>(ecx);
+			registers[3] = static_cast<int>(edx);
+			#endif // _MSC_VER
+		}
+
+		RAPIDIO_TARGET("xsave")
+		uint64_t GetEnabledXStateFeatures()
+		{
+			return _xgetbv(0);
+		}
+
+		CopyKernel DetectBestCopyKernel()
+		{
+			int registers[4]{};
+			CpuId(0, 0, registers);
+			const int maxLeaf = registers[0];
+
+			CpuId(1, 0, registers);
+			const bool hasSSE2 = (registers[3] & (1 << 26)) != 0;
+			const bool hasOSXSave = (registers[2] & (1 << 27)) != 0;
+
+			if (!hasSSE2)
+			{
+				return CopyKernel::Memcpy;
+			}
+
+			if (!hasOSXSave || maxLeaf < 7)
+			{
+				return CopyKernel::SSE2;
+			}
+
+			// The CPU supporting AVX is not enough, the OS also has to save the wider registers on a context switch
+			const uint64_t xstate = GetEnabledXStateFeatures();
+			const bool osSavesYmm = (xstate & 0x6) == 0x6;
+			const bool osSavesZmm = (xstate & 0xE6) == 0xE6;
+
+			CpuId(7, 0, registers);
+			const bool hasAVX2 = (registers[1] & (1 << 5)) != 0;
+			const bool hasAVX512F = (registers[1] & (1 << 16)) != 0;
+
+			if (hasAVX512F && osSavesZmm)
+			{
+				return CopyKernel::AVX512;
+			}
+
+			if (hasAVX2 && osSavesYmm)
+			{
+				return CopyKernel::AVX2;
+			}
+
+			return CopyKernel::SSE2;
+		}
+
+		// Every kernel copies the unaligned head with memcpy, streams the aligned middle and copies the tail with memcpy.
+		// Non-temporal stores are weakly ordered, so every kernel ends with a store fence
+		RAPIDIO_TARGET("sse2")
+		void StreamingCopySSE2(char* dst, const char* src, size_t size)
+		{
+			const size_t head = (16 - reinterpret_cast<uintptr_t>(dst) % 16) % 16;
+			std::memcpy(dst, src, head);
+			dst += head;
+			src += head;
+			size -= head;
+
+			for (; size >= 64; size -= 64, dst += 64, src += 64)
+			{
+				const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+				const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16));
+				const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 32));
+				const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 48));
+				_mm_stream_si128(reinterpret_cast<__m128i*>(dst), a);
+				_mm_stream_si128(reinterpret_cast<__m128i*>(dst + 16), b);
+				_mm_stream_si128(reinterpret_cast<__m128i*>(dst + 32), c);
+				_mm_stream_si128(reinterpret_cast<__m128i*>(dst + 48), d);
+			}
+
+			_mm_sfence();
+			std::memcpy(dst, src, size);
+		}
+
+		RAPIDIO_TARGET("avx2")
+		void StreamingCopyAVX2(char* dst, const char* src, size_t size)
+		{
+			const size_t head = (32 - reinterpret_cast<uintptr_t>(dst) % 32) % 32;
+			std::memcpy(dst, src, head);
+			dst += head;
+			src += head;
+			size -= head;
+
+			for (; size >= 128; size -= 128, dst += 128, src += 128)
+			{
+				const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+				const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 32));
+				const __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 64));
+				const __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 96));
+				_mm256_stream_si256(reinterpret_cast<__m256i*>(dst), a);
+				_mm256_stream_si256(reinterpret_cast<__m256i*>(dst + 32), b);
+				_mm256_stream_si256(reinterpret_cast<__m256i*>(dst + 64), c);
+				_mm256_stream_si256(reinterpret_cast<__m256i*>(dst + 96), d);
+			}
+
+			_mm_sfence();
+			std::memcpy(dst, src, size);
+		}
+
+		RAPIDIO_TARGET("avx512f")
+		void StreamingCopyAVX512(char* dst, const char* src, size_t size)
+		{
+			const size_t head = (64 - reinterpret_cast<uintptr_t>(dst) % 64) % 64;
+			std::memcpy(dst, src, head);
+			dst += head;
+			src += head;
+			size -= head;
+
+			for (; size >= 256; size -= 256, dst += 256, src += 256)
+			{
+				const __m512i a = _mm512_loadu_si512(src);
+				const __m512i b = _mm512_loadu_si512(src + 64);
+				const __m512i c = _mm512_loadu_si512(src + 128);
+				const __m512i d = _mm512_loadu_si512(src + 192);
+				_mm512_stream_si512(reinterpret_cast<__m512i*>(dst), a);
+				_mm512_stream_si512(reinterpret_cast<__m512i*>(dst + 64), b);
+				_mm512_stream_si512(reinterpret_cast<__m512i*>(dst + 128), c);
+				_mm512_stream_si512(reinterpret_cast<__m512i*>(dst + 192), d);
+			}
+
+			_mm_sfence();
+			std::memcpy(dst, src, size);
+		}
+		#else
+		CopyKernel DetectBestCopyKernel()
+		{
+			return CopyKernel::Memcpy;
+		}
+		#endif // RAPIDIO_X86
+	} // namespace detail
+
+	inline namespace CopyUtils
+	{
+		/// <summary>
+		/// Returns the widest non-temporal copy kernel supported by both this CPU and the OS. Detected once
+		/// </summary>
+		CopyKernel GetBestCopyKernel()
+		{
+			static const CopyKernel BestKernel = detail::DetectBestCopyKernel();
+			return BestKernel;
+		}
+
+		bool IsCopyKernelSupported(CopyKernel kernel)
+		{
+			return static_cast<int>(kernel) <= static_cast<int>(GetBestCopyKernel());
+		}
+
+		std::string_view GetCopyKernelName(CopyKernel kernel)
+		{
+			switch (kernel)
+			{
+			case CopyKernel::SSE2:
+				return "SSE2";
+			case CopyKernel::AVX2:
+				return "AVX2";
+			case CopyKernel::AVX512:
+				return "AVX-512";
+			default:
+				return "memcpy";
+			}
+		}
+
+		/// <summary>
+		/// Copies 'size' bytes with non-temporal stores, so the destination does not evict the rest of the cache.
+		/// Use this for data that will not be read back soon, small copies fall back to a regular memcpy
+		/// </summary>
+		/// <param name="kernel">Kernel to copy with, must be supported by this CPU (see 'IsCopyKernelSupported()')</param>
+		void StreamingCopy(void* dst, const void* src, size_t size, CopyKernel kernel)
+		{
+			char* const dstBytes = static_cast<char*>(dst);
+			const char* const srcBytes = static_cast<const char*>(src);
+
+			if (size < detail::MinStreamingCopySize)
+			{
+				kernel = CopyKernel::Memcpy;
+			}
+
+			switch (kernel)
+			{
+			#ifdef RAPIDIO_X86
+			case CopyKernel::SSE2:
+				detail::StreamingCopySSE2(dstBytes, srcBytes, size);
+				break;
+			case CopyKernel::AVX2:
+				detail::StreamingCopyAVX2(dstBytes, srcBytes, size);
+				break;
+			case CopyKernel::AVX512:
+				detail::StreamingCopyAVX512(dstBytes, srcBytes, size);
+				break;
+			#endif // RAPIDIO_X86
+			default:
+				std::memcpy(dstBytes, srcBytes, size);
+				break;
+			}
+		}
+
+		void StreamingCopy(void* dst, const void* src, size_t size)
+		{
+			StreamingCopy(dst, src, size, GetBestCopyKernel());
+		}
+
+		/// <summary>
+		/// Sets the transfer size from which 'Write()', 'ReadV()' and 'WriteV()' switch from memcpy to non-temporal stores.
+		/// Use std::numeric_limits<size_t>::max() to always copy through the cache
+		/// </summary>
+		void SetStreamingCopyThreshold(size_t bytes)
+		{
+			detail::StreamingCopyThreshold.store(bytes, std::memory_order_relaxed);
+		}
+
+		size_t GetStreamingCopyThreshold()
+		{
+			return detail::StreamingCopyThreshold.load(std::memory_order_relaxed);
+		}
+
+		/// <summary>
+		/// Copies with non-temporal stores if 'transferSize' reaches the streaming copy threshold, with a regular memcpy otherwise.
+		/// 'transferSize' is the size of the entire transfer, which can be larger than 'size' when a transfer is copied in chunks
+		/// </summary>
+		void CopyBytes(void* dst, const void* src, size_t size, size_t transferSize)
+		{
+			if (transferSize >= GetStreamingCopyThreshold())
+			{
+				StreamingCopy(dst, src, size);
+			}
+			else
+			{
+				std::memcpy(dst, src, size);
+			}
+		}
+
+		void CopyBytes(void* dst, const void* src, size_t size)
+		{
+			CopyBytes(dst, src, size, size);
+		}
+	} // inline namespace CopyUtils
+} // namespace rapidio
@@ -0,0 +1,298 @@
+#pragma once
+
+#include "rapidio.hpp"
+#include "ScanUtils.hpp"
+#include "ThreadUtils.hpp"
+
+#include <bit>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace rapidio
+{
+	/// <summary>
+	/// Zero-copy reader for delimited text (CSV, TSV, ...) in a mapped view. On construction, a vectorized structural pass locates every
+	/// row boundary outside of quotes, in parallel over chunks of the data. Fields are handed out as std::string_views into the mapping.
+	/// Quoted fields are returned without their enclosing quotes, but escaped quotes ("") inside them are left as-is, see 'Unescape()'
+	/// </summary>
+	class DelimitedReader final
+	{
+	public:
+		struct Options
+		{
+			char delimiter = ',';
+			char quote = '"';
+
+			// Number of threads to index with, 0 means every hardware thread
+			size_t nrOfThreads = 0;
+		};
+
+		template<FileAccessMode Access>
+		explicit DelimitedReader(const BasicFileView<Access>& view);
+		template<FileAccessMode Access>
+		DelimitedReader(const BasicFileView<Access>& view, Options options);
+		DelimitedReader(std::string_view data, Options options);
+
+		size_t GetNrOfRows() const;
+
+		/// <summary>
+		/// Splits row 'row' into its fields. The views stay valid as long as the mapping is not re-allocated
+		/// </summary>
+		/// <returns>Returns false if 'row' is out of range</returns>
+		bool GetRow(size_t row, std::vector<std::string_view>& fields) const;
+
+		/// <summary>
+		/// Splits the next row into its fields, starting at the first row
+		/// </summary>
+		/// <returns>Returns false once every row has been read</returns>
+		bool ReadRow(std::vector<std::string_view>& fields);
+
+		// Returns the byte offset of the start of 'row' in the data
+		size_t GetRowOffset(size_t row) const;
+
+		/// <summary>
+		/// Replaces every escaped (doubled) quote in a field by a single quote
+		/// </summary>
+		static std::string Unescape(std::string_view field, char quote = '"');
+
+	private:
+		// Quotes are counted and rows are indexed per chunk of this size, every chunk is a task for the thread pool
+		static constexpr size_t ChunkSize = 1024 * 1024 * 4; // 4 MB
+
+		void BuildIndex();
+		size_t CountQuotes(size_t begin, size_t end) const;
+		void FindRowEnds(size_t begin, size_t end, bool inQuotes, std::vector<uint64_t>& rowEnds) const;
+
+		std::string_view m_data;
+		Options m_options;
+
+		// Start offset of every row, followed by the offset just past the terminating newline of the last row
+		std::vector<uint64_t> m_rowStarts;
+		size_t m_nextRow = 0;
+	};
+
+	template<FileAccessMode Access>
+	DelimitedReader::DelimitedReader(const BasicFileView<Access>& view)
+		: DelimitedReader(view, Options{})
+	{
+	}
+
+	template<FileAccessMode Access>
+	DelimitedReader::DelimitedReader(const BasicFileView<Access>& view, Options options)
+		: DelimitedReader(std::string_view(view.GetData(), view.GetMappedSize()), options)
+	{
+	}
+
+	DelimitedReader::DelimitedReader(std::string_view data, Options options)
+		: m_data(data)
+		, m_options(options)
+	{
+		BuildIndex();
+	}
+
+	size_t DelimitedReader::GetNrOfRows() const
+	{
+		return m_rowStarts.size() - 1;
+	}
+
+	size_t DelimitedReader::GetRowOffset(size_t row) const
+	{
+		return static_cast<size_t>(m_rowStarts[row]);
+	}
+
+	bool DelimitedReader::GetRow(size_t row, std::vector<std::string_view>& fields) const
+	{
+		fields.clear();
+
+		if (row >= GetNrOfRows())
+		{
+			return false;
+		}
+
+		// Rows always start outside of quotes, so a row can be split on its own
+		const size_t rowStart = static_cast<size_t>(m_rowStarts[row]);
+		size_t rowEnd = std::min(static_cast<size_t>(m_rowStarts[row + 1]) - 1, m_data.size());
+		if (rowEnd > rowStart && m_data[rowEnd - 1] == '\r')
+		{
+			--rowEnd;
+		}
+
+		auto addField = [this, &fields](size_t begin, size_t end)
+		{
+			std::string_view field = m_data.substr(begin, end - begin);
+			if (field.size() >= 2 && field.front() == m_options.quote && field.back() == m_options.quote)
+			{
+				field = field.substr(1, field.size() - 2);
+			}
+
+			fields.push_back(field);
+		};
+
+		const char structurals[]{ m_options.quote, m_options.delimiter };
+		size_t fieldStart = rowStart;
+		uint64_t inQuotes{};
+
+		for (size_t block = rowStart; block < rowEnd; block += ScanBlockSize)
+		{
+			// Rows are mostly shorter than a block, so classify the block in place whenever the data extends far enough, and drop the bits past
+			// the end of the row. Only a row at the very end of the data is copied into a padded block
+			uint64_t masks[2];
+			if (m_data.size() - block >= ScanBlockSize)
+			{
+				MatchBytes(m_data.data() + block, structurals, masks);
+
+				if (rowEnd - block < ScanBlockSize)
+				{
+					const uint64_t valid = (uint64_t{ 1 } << (rowEnd - block)) - 1;
+					masks[0] &= valid;
+					masks[1] &= valid;
+				}
+			}
+			else
+			{
+				MatchBytesPartial(m_data.data() + block, rowEnd - block, structurals, masks);
+			}
+
+			const uint64_t quoted = PrefixXor(masks[0]) ^ inQuotes;
+			inQuotes = static_cast<uint64_t>(static_cast<int64_t>(quoted) >> 63);
+
+			for (uint64_t delimiters = masks[1] & ~quoted; delimiters != 0; delimiters &= delimiters - 1)
+			{
+				const size_t offset = block + std::countr_zero(delimiters);
+				addField(fieldStart, offset);
+				fieldStart = offset + 1;
+			}
+		}
+
+		addField(fieldStart, rowEnd);
+		return true;
+	}
+
+	bool DelimitedReader::ReadRow(std::vector<std::string_view>& fields)
+	{
+		if (!GetRow(m_nextRow, fields))
+		{
+			return false;
+		}
+
+		++m_nextRow;
+		return true;
+	}
+
+	std::string DelimitedReader::Unescape(std::string_view field, char quote /* = '"' */)
+	{
+		std::string unescaped;
+		unescaped.reserve(field.size());
+
+		for (size_t i{}; i < field.size(); ++i)
+		{
+			unescaped += field[i];
+
+			if (field[i] == quote && i + 1 < field.size() && field[i + 1] == quote)
+			{
+				++i;
+			}
+		}
+
+		return unescaped;
+	}
+
+	void DelimitedReader::BuildIndex()
+	{
+		const size_t nrOfChunks = (m_data.size() + ChunkSize - 1) / ChunkSize;
+
+		// Pass 1: whether a chunk starts inside quotes only depends on the number of quotes before it
+		std::vector<size_t> quoteCounts(nrOfChunks);
+		ParallelFor(nrOfChunks, m_options.nrOfThreads, [this, &quoteCounts](size_t chunk)
+			{
+				quoteCounts[chunk] = CountQuotes(chunk * ChunkSize, std::min(m_data.size(), (chunk + 1) * ChunkSize));
+			});
+
+		std::vector<bool> startsInQuotes(nrOfChunks);
+		size_t quotesSoFar{};
+		for (size_t chunk{}; chunk < nrOfChunks; ++chunk)
+		{
+			startsInQuotes[chunk] = quotesSoFar % 2 != 0;
+			quotesSoFar += quoteCounts[chunk];
+		}
+
+		// Pass 2: with the quote state known at every chunk boundary, every chunk can find its row ends independently
+		std::vector<std::vector<uint64_t>> rowEnds(nrOfChunks);
+		ParallelFor(nrOfChunks, m_options.nrOfThreads, [this, &startsInQuotes, &rowEnds](size_t chunk)
+			{
+				FindRowEnds(chunk * ChunkSize, std::min(m_data.size(), (chunk + 1) * ChunkSize), startsInQuotes[chunk], rowEnds[chunk]);
+			});
+
+		size_t nrOfRows{};
+		for (const std::vector<uint64_t>& chunkRowEnds : rowEnds)
+		{
+			nrOfRows += chunkRowEnds.size();
+		}
+
+		m_rowStarts.reserve(nrOfRows + 2);
+		m_rowStarts.push_back(0);
+
+		for (const std::vector<uint64_t>& chunkRowEnds : rowEnds)
+		{
+			m_rowStarts.insert(m_rowStarts.end(), chunkRowEnds.begin(), chunkRowEnds.end());
+		}
+
+		// The last row does not need a terminating newline
+		if (m_rowStarts.back() < m_data.size())
+		{
+			m_rowStarts.push_back(m_data.size() + 1);
+		}
+	}
+
+	size_t DelimitedReader::CountQuotes(size_t begin, size_t end) const
+	{
+		const char quote[]{ m_options.quote };
+		size_t count{};
+
+		for (size_t block = begin; block < end; block += ScanBlockSize)
+		{
+			uint64_t mask;
+			if (end - block >= ScanBlockSize)
+			{
+				MatchBytes(m_data.data() + block, quote, &mask);
+			}
+			else
+			{
+				MatchBytesPartial(m_data.data() + block, end - block, quote, &mask);
+			}
+
+			count += std::popcount(mask);
+		}
+
+		return count;
+	}
+
+	void DelimitedReader::FindRowEnds(size_t begin, size_t end, bool inQuotes, std::vector<uint64_t>& rowEnds) const
+	{
+		const char structurals[]{ m_options.quote, '\n' };
+		uint64_t carry = inQuotes ? ~uint64_t{ 0 } : 0;
+
+		for (size_t block = begin; block < end; block += ScanBlockSize)
+		{
+			uint64_t masks[2];
+			if (end - block >= ScanBlockSize)
+			{
+				MatchBytes(m_data.data() + block, structurals, masks);
+			}
+			else
+			{
+				MatchBytesPartial(m_data.data() + block, end - block, structurals, masks);
+			}
+
+			// simdjson-style quote tracking: a prefix XOR over the quote bits marks every byte inside quotes, the carry continues it over blocks
+			const uint64_t quoted = PrefixXor(masks[0]) ^ carry;
+			carry = static_cast<uint64_t>(static_cast<int64_t>(quoted) >> 63);
+
+			for (uint64_t newlines = masks[1] & ~quoted; newlines != 0; newlines &= newlines - 1)
+			{
+				rowEnds.push_back(block + std::countr_zero(newlines) + 1);
+			}
+		}
+	}
+} // namespace rapidio
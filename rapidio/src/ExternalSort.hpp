@@ -0,0 +1,486 @@
+#pragma once
+
+#include "rapidio.hpp"
+#include "PathUtils.hpp"
+#include "ThreadUtils.hpp"
+#include "TraceUtils.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace rapidio
+{
+	struct ExternalSortOptions
+	{
+		// File to write the sorted records to. If empty, the input file is replaced by its sorted records
+		std::filesystem::path outputPath;
+
+		// Directory to write the sorted runs to. If empty, they are written next to the output file
+		std::filesystem::path tempDirectory;
+
+		// Maximum number of runs sorted at once, 0 means every hardware thread. The memory budget is shared by all of them
+		size_t nrOfThreads = 0;
+	};
+
+	namespace detail
+	{
+		template<typename KeyFn>
+		using ExternalSortKey = std::remove_cvref_t<std::invoke_result_t<KeyFn&, std::span<const char>>>;
+
+		template<typename Key>
+		concept RadixSortableKey = std::unsigned_integral<Key> && !std::same_as<Key, bool>;
+
+		template<typename Key>
+		struct SortEntry
+		{
+			Key key;
+			uint32_t index; // Of the record in its run
+		};
+
+		/// <summary>
+		/// Least significant digit radix sort on the bytes of the keys. Stable, so records with equal keys keep their order.
+		/// Passes over a byte that is the same in every key are skipped, so small keys in a wide integer do not pay for the unused bytes
+		/// </summary>
+		template<RadixSortableKey Key>
+		void RadixSort(std::vector<SortEntry<Key>>& entries, std::vector<SortEntry<Key>>& scratch)
+		{
+			if (entries.empty())
+			{
+				return;
+			}
+
+			scratch.resize(entries.size());
+
+			for (size_t byte{}; byte < sizeof(Key); ++byte)
+			{
+				const size_t shift = byte * 8;
+				auto getDigit = [shift](const SortEntry<Key>& entry)
+				{
+					return static_cast<size_t>((static_cast<uint64_t>(entry.key) >> shift) & 0xFF);
+				};
+
+				std::array<size_t, 256> offsets{};
+				for (const SortEntry<Key>& entry : entries)
+				{
+					++offsets[getDigit(entry)];
+				}
+
+				if (offsets[getDigit(entries.front())] == entries.size())
+				{
+					continue;
+				}
+
+				size_t offset{};
+				for (size_t& count : offsets)
+				{
+					offset += std::exchange(count, offset);
+				}
+
+				for (const SortEntry<Key>& entry : entries)
+				{
+					scratch[offsets[getDigit(entry)]++] = entry;
+				}
+
+				entries.swap(scratch);
+			}
+		}
+
+		/// <summary>
+		/// Tournament tree over the current record of every run. Every inner node holds the loser of the match played there, the root the overall winner.
+		/// Replacing the winner only replays the matches on the path from its leaf to the root, one comparison per level
+		/// </summary>
+		template<typename Less>
+		class LoserTree final
+		{
+		public:
+			LoserTree(size_t nrOfLeaves, Less less);
+
+			size_t GetWinner() const;
+
+			// Plays the matches of 'leaf' again, after its value has changed. 'leaf' must be the current winner
+			void Replay(size_t leaf);
+
+		private:
+			std::vector<size_t> m_nodes; // Inner nodes are [1, nrOfLeaves), leaf i is node nrOfLeaves + i. Node 0 holds the winner
+			size_t m_nrOfLeaves;
+			Less m_less;
+		};
+
+		struct MergeCursor
+		{
+			const char* data;
+			size_t size;
+			size_t position = 0;
+			size_t blockStart = 0; // Start of the block being merged, the block after it is being prefetched
+		};
+
+		// Removes every file when destroyed, so temporary files do not outlive a failed sort. Views of the files have to be closed first
+		struct TemporaryFiles final
+		{
+			~TemporaryFiles();
+
+			std::vector<std::filesystem::path> paths;
+		};
+
+		template<typename Less>
+		LoserTree<Less>::LoserTree(size_t nrOfLeaves, Less less)
+			: m_nodes(nrOfLeaves)
+			, m_nrOfLeaves(nrOfLeaves)
+			, m_less(std::move(less))
+		{
+			std::vector<size_t> winners(nrOfLeaves * 2);
+			for (size_t i{}; i < nrOfLeaves; ++i)
+			{
+				winners[nrOfLeaves + i] = i;
+			}
+
+			for (size_t node = nrOfLeaves - 1; node > 0; --node)
+			{
+				const size_t left = winners[node * 2];
+				const size_t right = winners[node * 2 + 1];
+				const bool isRightWinner = m_less(right, left);
+
+				winners[node] = isRightWinner ? right : left;
+				m_nodes[node] = isRightWinner ? left : right;
+			}
+
+			m_nodes[0] = nrOfLeaves > 1 ? winners[1] : 0;
+		}
+
+		template<typename Less>
+		size_t LoserTree<Less>::GetWinner() const
+		{
+			return m_nodes[0];
+		}
+
+		template<typename Less>
+		void LoserTree<Less>::Replay(size_t leaf)
+		{
+			size_t winner = leaf;
+			for (size_t node = (m_nrOfLeaves + leaf) / 2; node > 0; node /= 2)
+			{
+				if (m_less(m_nodes[node], winner))
+				{
+					std::swap(m_nodes[node], winner);
+				}
+			}
+
+			m_nodes[0] = winner;
+		}
+
+		TemporaryFiles::~TemporaryFiles()
+		{
+			for (const std::filesystem::path& path : paths)
+			{
+				std::error_code error;
+				std::filesystem::remove(path, error);
+			}
+		}
+	} // namespace detail
+
+	/// <summary>
+	/// Sorts a file of fixed-size records that can be far larger than memory. Runs of records that fit in the memory budget are sorted in parallel,
+	/// with a radix sort if the key is an unsigned integer and a stable comparison sort otherwise, and written to mapped temporary files.
+	/// The runs are then merged with a loser tree into a preallocated mapped file. While merging, the block after the one being merged is prefetched
+	/// for every run, and blocks that have been merged are released again. The sort is stable
+	/// </summary>
+	/// <param name="filepath">File to sort, its size must be a multiple of 'recordSize'</param>
+	/// <param name="recordSize">Size of every record in bytes</param>
+	/// <param name="keyFn">Callable taking a std::span<const char> of a record and returning its key, which may point into the record.
+	/// Keys must be totally ordered. 'keyFn' is called from several threads at once</param>
+	/// <param name="memoryBudget">Approximate number of bytes of memory to use for records, sort buffers and merge blocks together</param>
+	/// <param name="options">Where to write the sorted records and the runs to, and how many threads to sort with</param>
+	/// <returns>Returns true if the sorted records were written. Temporary files are removed either way</returns>
+	template<typename KeyFn>
+		requires std::invocable<KeyFn&, std::span<const char>> && std::totally_ordered<detail::ExternalSortKey<KeyFn>>
+	bool ExternalSort(const std::filesystem::path& filepath, size_t recordSize, KeyFn keyFn, size_t memoryBudget, const ExternalSortOptions& options = {});
+
+	template<typename KeyFn>
+		requires std::invocable<KeyFn&, std::span<const char>> && std::totally_ordered<detail::ExternalSortKey<KeyFn>>
+	bool ExternalSort(const std::filesystem::path& filepath, size_t recordSize, KeyFn keyFn, size_t memoryBudget,
+		const ExternalSortOptions& options /* = {} */)
+	{
+		using Key = detail::ExternalSortKey<KeyFn>;
+		using Entry = detail::SortEntry<Key>;
+
+		if (recordSize == 0)
+		{
+			std::cerr << "ExternalSort > Record size cannot be 0\n";
+			return false;
+		}
+
+		std::error_code error;
+		const size_t fileSize = std::filesystem::file_size(filepath, error);
+		if (error)
+		{
+			std::cerr << "ExternalSort > Could not get the size of " << filepath << "\n";
+			return false;
+		}
+
+		if (fileSize % recordSize != 0)
+		{
+			std::cerr << "ExternalSort > " << filepath << " does not hold a whole number of records\n";
+			return false;
+		}
+
+		const std::filesystem::path outputPath = options.outputPath.empty() ? filepath : options.outputPath;
+		const std::filesystem::path tempDirectory = options.tempDirectory.empty() ? outputPath.parent_path() : options.tempDirectory;
+
+		if (fileSize == 0)
+		{
+			if (outputPath != filepath)
+			{
+				std::filesystem::copy_file(filepath, outputPath, std::filesystem::copy_options::overwrite_existing, error);
+			}
+
+			return !error;
+		}
+
+		const size_t nrOfRecords = fileSize / recordSize;
+		const size_t nrOfThreads = GetThreadCount(options.nrOfThreads);
+
+		// While a run is sorted, its records are resident both in the input and in the run, next to an entry and a scratch entry per record
+		const size_t bytesPerRecord = recordSize * 2 + sizeof(Entry) * 2;
+		const size_t recordsPerRun = std::clamp<size_t>(memoryBudget / nrOfThreads / bytesPerRecord, 1, std::numeric_limits<uint32_t>::max());
+		const size_t nrOfRuns = (nrOfRecords + recordsPerRun - 1) / recordsPerRun;
+
+		// While merging, every run has the block being merged and the next one resident, and the output has the block being written
+		const size_t pageSize = FileView::GetSystemPageSize();
+		const size_t blockSize = memoryBudget / (nrOfRuns * 2 + 1) / pageSize * pageSize;
+		if (nrOfRuns > 1 && blockSize == 0)
+		{
+			std::cerr << "ExternalSort > Memory budget is too small to merge " << nrOfRuns << " runs\n";
+			return false;
+		}
+
+		// Views are declared after the temporary files, so they are closed before the files are removed
+		detail::TemporaryFiles temporaryFiles;
+
+		// The sorted records only replace the output file once they are complete
+		const std::filesystem::path sortedPath = std::filesystem::path{ outputPath } += ".sorted.tmp";
+		temporaryFiles.paths.push_back(sortedPath);
+
+		std::vector<std::filesystem::path> runPaths;
+		for (size_t run{}; nrOfRuns > 1 && run < nrOfRuns; ++run)
+		{
+			runPaths.push_back(tempDirectory / (outputPath.filename().string() + ".run" + std::to_string(run) + ".tmp"));
+			temporaryFiles.paths.push_back(runPaths.back());
+		}
+
+		for (const std::filesystem::path& path : temporaryFiles.paths)
+		{
+			if (PathUtils::DoesFileExist(path))
+			{
+				std::filesystem::remove(path);
+			}
+		}
+
+		{
+			std::optional<ReadOnlyFileView> input = ReadOnlyFileView::CreateViewFromExistingFile(filepath, FileOpenMode::OpenExisting);
+			if (!input)
+			{
+				return false;
+			}
+
+			auto sortRun = [&](size_t run, FileView& destination)
+			{
+				const size_t firstRecord = run * recordsPerRun;
+				const size_t nrOfRunRecords = std::min(recordsPerRun, nrOfRecords - firstRecord);
+				const FileRange range{ firstRecord * recordSize, nrOfRunRecords * recordSize };
+
+				RAPIDIO_TRACE_SCOPE("SortRun", range.offset, range.size);
+
+				input->Prefetch(range);
+				const char* records = input->GetData() + range.offset;
+
+				std::vector<Entry> entries;
+				entries.reserve(nrOfRunRecords);
+				for (size_t i{}; i < nrOfRunRecords; ++i)
+				{
+					entries.push_back(Entry{ keyFn(std::span<const char>{ records + i * recordSize, recordSize }), static_cast<uint32_t>(i) });
+				}
+
+				if constexpr (detail::RadixSortableKey<Key>)
+				{
+					std::vector<Entry> scratch;
+					detail::RadixSort(entries, scratch);
+				}
+				else
+				{
+					std::stable_sort(entries.begin(), entries.end(), [](const Entry& lhs, const Entry& rhs) { return lhs.key < rhs.key; });
+				}
+
+				char* sortedRecords = destination.GetData();
+				for (size_t i{}; i < nrOfRunRecords; ++i)
+				{
+					std::memcpy(sortedRecords + i * recordSize, records + entries[i].index * recordSize, recordSize);
+				}
+
+				// Both the records and the sorted run are backed by files, neither has to stay in memory
+				input->Discard(range);
+				destination.Discard({ 0, range.size });
+			};
+
+			if (nrOfRuns == 1)
+			{
+				std::optional<FileView> sorted = FileView::CreateViewForNewFile(sortedPath, fileSize);
+				if (!sorted)
+				{
+					return false;
+				}
+
+				sortRun(0, *sorted);
+			}
+			else
+			{
+				std::atomic<bool> hasFailed{ false };
+				ParallelFor(nrOfRuns, nrOfThreads, [&](size_t run)
+					{
+						if (hasFailed.load(std::memory_order_relaxed))
+						{
+							return;
+						}
+
+						const size_t runSize = std::min(recordsPerRun, nrOfRecords - run * recordsPerRun) * recordSize;
+						std::optional<FileView> runView = FileView::CreateViewForNewFile(runPaths[run], runSize);
+						if (!runView)
+						{
+							hasFailed = true;
+							return;
+						}
+
+						sortRun(run, *runView);
+					});
+
+				if (hasFailed)
+				{
+					std::cerr << "ExternalSort > Could not write the sorted runs to " << tempDirectory << "\n";
+					return false;
+				}
+			}
+		}
+
+		if (nrOfRuns > 1)
+		{
+			RAPIDIO_TRACE_SCOPE("MergeRuns", 0, fileSize);
+
+			std::vector<ReadOnlyFileView> runs;
+			runs.reserve(nrOfRuns);
+			for (const std::filesystem::path& path : runPaths)
+			{
+				std::optional<ReadOnlyFileView> run = ReadOnlyFileView::CreateViewFromExistingFile(path, FileOpenMode::OpenExisting);
+				if (!run)
+				{
+					return false;
+				}
+
+				runs.push_back(std::move(*run));
+			}
+
+			std::optional<FileView> sorted = FileView::CreateViewForNewFile(sortedPath, fileSize);
+			if (!sorted)
+			{
+				return false;
+			}
+
+			std::vector<detail::MergeCursor> cursors;
+			std::vector<Key> keys;
+			cursors.reserve(nrOfRuns);
+			keys.reserve(nrOfRuns);
+
+			for (ReadOnlyFileView& run : runs)
+			{
+				cursors.push_back(detail::MergeCursor{ run.GetData(), run.GetMappedSize() });
+				keys.push_back(keyFn(std::span<const char>{ run.GetData(), recordSize }));
+				run.Prefetch({ 0, blockSize * 2 });
+			}
+
+			// Exhausted runs lose every match, equal keys are won by the earlier run, which keeps the sort stable
+			auto less = [&cursors, &keys](size_t lhs, size_t rhs)
+			{
+				const bool isLhsExhausted = cursors[lhs].position == cursors[lhs].size;
+				const bool isRhsExhausted = cursors[rhs].position == cursors[rhs].size;
+				if (isLhsExhausted || isRhsExhausted)
+				{
+					return !isLhsExhausted;
+				}
+
+				if (keys[lhs] < keys[rhs])
+				{
+					return true;
+				}
+
+				if (keys[rhs] < keys[lhs])
+				{
+					return false;
+				}
+
+				return lhs < rhs;
+			};
+
+			detail::LoserTree tree{ nrOfRuns, less };
+
+			char* sortedRecords = sorted->GetData();
+			size_t releasedSize{};
+
+			for (size_t written{}; written < fileSize;)
+			{
+				const size_t winner = tree.GetWinner();
+				detail::MergeCursor& cursor = cursors[winner];
+
+				std::memcpy(sortedRecords + written, cursor.data + cursor.position, recordSize);
+				written += recordSize;
+				cursor.position += recordSize;
+
+				if (cursor.position < cursor.size)
+				{
+					keys[winner] = keyFn(std::span<const char>{ cursor.data + cursor.position, recordSize });
+				}
+
+				while (cursor.position >= cursor.blockStart + blockSize)
+				{
+					// The run has moved into its next block: release the merged one, and start reading the one after
+					runs[winner].Discard({ cursor.blockStart, blockSize });
+					cursor.blockStart += blockSize;
+
+					if (cursor.blockStart + blockSize < cursor.size)
+					{
+						runs[winner].Prefetch({ cursor.blockStart + blockSize, blockSize });
+					}
+				}
+
+				tree.Replay(winner);
+
+				if (written - releasedSize >= blockSize)
+				{
+					sorted->Discard({ releasedSize, written - releasedSize });
+					releasedSize = written / pageSize * pageSize;
+				}
+			}
+		}
+
+		std::filesystem::rename(sortedPath, outputPath, error);
+		if (error)
+		{
+			std::cerr << "ExternalSort > Could not replace " << outputPath << " with the sorted records\n";
+			return false;
+		}
+
+		return true;
+	}
+} // namespace rapidio
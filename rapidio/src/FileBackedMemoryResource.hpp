@@ -0,0 +1,300 @@
+#pragma once
+
+#include "rapidio.hpp"
+
+#include <array>
+#include <bit>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace rapidio
+{
+	/// <summary>
+	/// std::pmr::memory_resource that carves its allocations out of memory-mapped spill files, so pmr containers can grow past physical memory.
+	/// Spill files are created on demand as fixed-size segments (segments are never re-mapped, so allocations never move) and are deleted
+	/// when the resource is destroyed. Optionally, allocations are served from an upstream resource until a threshold is reached.
+	/// Allocation failure throws std::bad_alloc, as required by std::pmr::memory_resource. All member functions are thread-safe
+	/// </summary>
+	class FileBackedMemoryResource final : public std::pmr::memory_resource
+	{
+	public:
+		struct Options
+		{
+			// Directory the spill files are created in
+			std::filesystem::path directory = std::filesystem::temp_directory_path();
+
+			// Size of every spill file. Allocations bigger than this get a spill file of their own
+			size_t segmentSize = 1024 * 1024 * 64; // 64 MB
+
+			// Number of bytes served from 'upstream' before allocations start spilling to disk. 0 always spills
+			size_t heapThreshold = 0;
+
+			std::pmr::memory_resource* upstream = std::pmr::new_delete_resource();
+		};
+
+		FileBackedMemoryResource();
+		explicit FileBackedMemoryResource(Options options);
+		~FileBackedMemoryResource() override;
+
+		FileBackedMemoryResource(const FileBackedMemoryResource&) = delete;
+		FileBackedMemoryResource& operator=(const FileBackedMemoryResource&) = delete;
+
+		// Returns the number of bytes currently served from the upstream resource
+		size_t GetHeapBytes() const;
+
+		// Returns the total size of all spill files
+		size_t GetSpilledBytes() const;
+
+	private:
+		// Allocations up to this size are rounded up to a power of 2 and recycled through per-size-class free lists
+		static constexpr size_t MaxSmallSize = 1024 * 256; // 256 KB
+		static constexpr size_t MinSmallSize = 16;
+		static constexpr size_t NrOfSizeClasses = std::countr_zero(MaxSmallSize) - std::countr_zero(MinSmallSize) + 1;
+
+		struct FreeBlock
+		{
+			FreeBlock* next;
+		};
+
+		struct Segment
+		{
+			FileView view;
+			std::filesystem::path filepath;
+			size_t used = 0;
+		};
+
+		void* do_allocate(size_t bytes, size_t alignment) override;
+		void do_deallocate(void* ptr, size_t bytes, size_t alignment) override;
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+		static size_t GetSizeClass(size_t bytes);
+		void* AllocateFromSegment(size_t bytes, size_t alignment);
+		Segment* FindSegment(const void* ptr);
+
+		Options m_options;
+		size_t m_pageSize;
+		size_t m_heapBytes = 0;
+		size_t m_spilledBytes = 0;
+		size_t m_segmentCounter = 0;
+
+		std::array<FreeBlock*, NrOfSizeClasses> m_freeLists{};
+		std::multimap<size_t, char*> m_freeRuns; // Freed large allocations, keyed by size
+		std::vector<std::unique_ptr<Segment>> m_segments;
+		std::map<const char*, Segment*> m_segmentsByAddress;
+		mutable std::mutex m_mutex;
+	};
+
+	FileBackedMemoryResource::FileBackedMemoryResource()
+		: FileBackedMemoryResource(Options{})
+	{
+	}
+
+	FileBackedMemoryResource::FileBackedMemoryResource(Options options)
+		: m_options(std::move(options))
+		, m_pageSize(FileView::GetSystemPageSize())
+	{
+	}
+
+	FileBackedMemoryResource::~FileBackedMemoryResource()
+	{
+		std::vector<std::filesystem::path> filepaths;
+		filepaths.reserve(m_segments.size());
+
+		for (const std::unique_ptr<Segment>& segment : m_segments)
+		{
+			filepaths.push_back(segment->filepath);
+		}
+
+		// The spill files can only be removed once they are no longer mapped
+		m_segmentsByAddress.clear();
+		m_segments.clear();
+
+		for (const std::filesystem::path& filepath : filepaths)
+		{
+			std::error_code error;
+			if (!std::filesystem::remove(filepath, error))
+			{
+				std::cerr << "FileBackedMemoryResource > Could not remove spill file " << filepath << "\n";
+			}
+		}
+	}
+
+	size_t FileBackedMemoryResource::GetHeapBytes() const
+	{
+		std::lock_guard lock(m_mutex);
+		return m_heapBytes;
+	}
+
+	size_t FileBackedMemoryResource::GetSpilledBytes() const
+	{
+		std::lock_guard lock(m_mutex);
+		return m_spilledBytes;
+	}
+
+	void* FileBackedMemoryResource::do_allocate(size_t bytes, size_t alignment)
+	{
+		std::lock_guard lock(m_mutex);
+
+		if (bytes == 0)
+		{
+			bytes = 1;
+		}
+
+		if (m_heapBytes + bytes <= m_options.heapThreshold)
+		{
+			void* const ptr = m_options.upstream->allocate(bytes, alignment);
+			m_heapBytes += bytes;
+			return ptr;
+		}
+
+		if (std::max(bytes, alignment) <= MaxSmallSize)
+		{
+			const size_t sizeClass = GetSizeClass(std::max(bytes, alignment));
+
+			if (FreeBlock* const block = m_freeLists[sizeClass])
+			{
+				m_freeLists[sizeClass] = block->next;
+				return block;
+			}
+
+			// Size-class blocks are aligned to their own size, which covers any alignment up to that size
+			const size_t classSize = MinSmallSize << sizeClass;
+			return AllocateFromSegment(classSize, classSize);
+		}
+
+		// Large allocations are whole pages, so they can be given back to the OS once freed
+		const size_t runSize = (bytes + m_pageSize - 1) / m_pageSize * m_pageSize;
+
+		for (auto it = m_freeRuns.lower_bound(runSize); it != m_freeRuns.end(); ++it)
+		{
+			char* const run = it->second;
+			if (reinterpret_cast<uintptr_t>(run) % alignment != 0)
+			{
+				continue;
+			}
+
+			const size_t remainder = it->first - runSize;
+			m_freeRuns.erase(it);
+
+			if (remainder > 0)
+			{
+				m_freeRuns.emplace(remainder, run + runSize);
+			}
+
+			return run;
+		}
+
+		return AllocateFromSegment(runSize, std::max(alignment, m_pageSize));
+	}
+
+	void FileBackedMemoryResource::do_deallocate(void* ptr, size_t bytes, size_t alignment)
+	{
+		std::lock_guard lock(m_mutex);
+
+		if (bytes == 0)
+		{
+			bytes = 1;
+		}
+
+		Segment* const segment = FindSegment(ptr);
+		if (!segment)
+		{
+			m_options.upstream->deallocate(ptr, bytes, alignment);
+			m_heapBytes -= bytes;
+			return;
+		}
+
+		if (std::max(bytes, alignment) <= MaxSmallSize)
+		{
+			const size_t sizeClass = GetSizeClass(std::max(bytes, alignment));
+			m_freeLists[sizeClass] = new (ptr) FreeBlock{ m_freeLists[sizeClass] };
+			return;
+		}
+
+		const size_t runSize = (bytes + m_pageSize - 1) / m_pageSize * m_pageSize;
+		const size_t offset = static_cast<size_t>(static_cast<char*>(ptr) - segment->view.GetData());
+
+		// The contents of a freed run are garbage, so there is no point in keeping them in memory
+		segment->view.Discard({ offset, runSize });
+		m_freeRuns.emplace(runSize, static_cast<char*>(ptr));
+	}
+
+	bool FileBackedMemoryResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+	{
+		return this == &other;
+	}
+
+	size_t FileBackedMemoryResource::GetSizeClass(size_t bytes)
+	{
+		return std::countr_zero(std::bit_ceil(std::max(bytes, MinSmallSize))) - std::countr_zero(MinSmallSize);
+	}
+
+	void* FileBackedMemoryResource::AllocateFromSegment(size_t bytes, size_t alignment)
+	{
+		// Alignment is applied to the address, the start of a segment is only aligned to the allocation granularity
+		auto getAlignedOffset = [alignment](const Segment& segment)
+		{
+			const uintptr_t base = reinterpret_cast<uintptr_t>(segment.view.GetData());
+			return static_cast<size_t>((base + segment.used + alignment - 1) / alignment * alignment - base);
+		};
+
+		Segment* segment = m_segments.empty() ? nullptr : m_segments.back().get();
+
+		if (!segment || getAlignedOffset(*segment) + bytes > segment->view.GetMappedSize())
+		{
+			// Segments are never grown, growing would re-map them and move every allocation inside them
+			const size_t segmentSize = std::max(m_options.segmentSize, (bytes + alignment + m_pageSize - 1) / m_pageSize * m_pageSize);
+
+			std::optional<FileView> view;
+			std::filesystem::path filepath;
+
+			for (int attempt{}; attempt < 16 && !view; ++attempt)
+			{
+				filepath = m_options.directory / ("rapidio_spill_" + std::to_string(reinterpret_cast<uintptr_t>(this)) + "_" +
+					std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) + "_" + std::to_string(m_segmentCounter++) + ".tmp");
+
+				view = FileView::CreateViewForNewFile(filepath, segmentSize);
+			}
+
+			if (!view)
+			{
+				std::cerr << "FileBackedMemoryResource > Could not create spill file in " << m_options.directory << "\n";
+				throw std::bad_alloc();
+			}
+
+			m_segments.push_back(std::make_unique<Segment>(Segment{ std::move(*view), filepath }));
+			segment = m_segments.back().get();
+			m_segmentsByAddress.emplace(segment->view.GetData(), segment);
+			m_spilledBytes += segment->view.GetMappedSize();
+		}
+
+		const size_t offset = getAlignedOffset(*segment);
+		segment->used = offset + bytes;
+		return segment->view.GetData() + offset;
+	}
+
+	FileBackedMemoryResource::Segment* FileBackedMemoryResource::FindSegment(const void* ptr)
+	{
+		auto it = m_segmentsByAddress.upper_bound(static_cast<const char*>(ptr));
+		if (it == m_segmentsByAddress.begin())
+		{
+			return nullptr;
+		}
+
+		--it;
+		Segment* const segment = it->second;
+		if (static_cast<const char*>(ptr) >= segment->view.GetData() + segment->view.GetMappedSize())
+		{
+			return nullptr;
+		}
+
+		return segment;
+	}
+} // namespace rapidio
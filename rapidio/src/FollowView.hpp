@@ -0,0 +1,116 @@
+#pragma once
+
+#include "rapidio.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace rapidio
+{
+	namespace detail
+	{
+		/// <summary>
+		/// State shared between a FollowView and its background watcher thread.
+		/// Lives on the heap so the FollowView itself can be moved while the thread is running
+		/// </summary>
+		struct FollowState final
+		{
+			using Callback = std::function<void(std::span<const char> data, size_t offset)>;
+
+			Callback callback;
+			size_t fileSize = 0; // Last size reported by the watcher thread
+			size_t offset = 0; // Number of bytes handed out so far
+			bool finished = false;
+
+			std::mutex mutex;
+			std::condition_variable dataAvailable;
+
+			// Only the thread delivering data touches the tail mapping: the watcher thread with a callback, the consumer without one
+			size_t allocationGranularity = 0;
+
+			#ifdef _WIN32
+			Win32Handle fileHandle;
+			Win32Handle directoryHandle;
+			Win32Handle tailMappingHandle;
+			Win32MappedView tailView;
+			Win32Handle changeEvent;
+			Win32Handle stopEvent;
+			OVERLAPPED overlapped{};
+			std::vector<DWORD> changes;
+			#endif // _WIN32
+		};
+	} // namespace detail
+
+	/// <summary>
+	/// Follows a file that other processes keep appending to, like 'tail -f'. A background thread sleeps on change notifications
+	/// for the file and, when it has grown, maps only the newly appended tail and hands it out, either to a callback or to 'WaitForData()'.
+	/// The file is opened with shared access, so writers are never locked out
+	/// </summary>
+	class FollowView final
+	{
+	public:
+		using Callback = detail::FollowState::Callback;
+
+		/// <summary>
+		/// Starts following the file at the given path. New data is retrieved by calling 'WaitForData()'
+		/// </summary>
+		/// <param name="filepath">Path to the file to follow</param>
+		/// <param name="startOffset">Offset to start following from. Data already in the file past this offset is handed out first</param>
+		/// <returns>std::nullopt if the file could not be opened or watched. A valid optional of a FollowView otherwise</returns>
+		static std::optional<FollowView> Create(const std::filesystem::path& filepath, size_t startOffset = 0);
+
+		/// <summary>
+		/// Starts following the file at the given path. New data is passed to 'callback' on the watcher thread, together with its offset in the file.
+		/// The span is only valid for the duration of the callback
+		/// </summary>
+		/// <param name="filepath">Path to the file to follow</param>
+		/// <param name="callback">Function to invoke with every newly appended span of data</param>
+		/// <param name="startOffset">Offset to start following from. Data already in the file past this offset is handed out first</param>
+		/// <returns>std::nullopt if the file could not be opened or watched. A valid optional of a FollowView otherwise</returns>
+		static std::optional<FollowView> Create(const std::filesystem::path& filepath, Callback callback, size_t startOffset = 0);
+
+		~FollowView();
+
+		FollowView(const FollowView&) = delete;
+		FollowView(FollowView&& other) noexcept = default;
+		FollowView& operator=(const FollowView&) = delete;
+		FollowView& operator=(FollowView&& other) noexcept;
+
+		/// <summary>
+		/// Blocks until data has been appended past everything handed out so far, or until 'timeout' expires.
+		/// The span is valid until the next call to WaitForData(). Not available if the FollowView was created with a callback
+		/// </summary>
+		/// <param name="timeout">Maximum time to wait for new data</param>
+		/// <returns>Span of the newly appended data. An empty span means the timeout expired</returns>
+		std::span<const char> WaitForData(std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+
+		// Returns the offset up to which data has been handed out
+		size_t GetOffset() const;
+
+		// Stops the watcher thread. No data is handed out afterwards
+		void Stop();
+
+	private:
+		FollowView() = default;
+
+		bool Start(const std::filesystem::path& filepath, size_t startOffset);
+		static void WatchLoop(detail::FollowState* state);
+		static std::span<const char> MapTail(detail::FollowState& state, size_t begin, size_t end);
+		static void UnmapTail(detail::FollowState& state);
+
+		std::unique_ptr<detail::FollowState> m_state;
+		std::thread m_watcherThread;
+	};
+} // namespace rapidio
+
+#ifdef _WIN32
+#	include "FollowViewWin32.hpp"
+#endif // _WIN32
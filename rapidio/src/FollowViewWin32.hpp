@@ -0,0 +1,322 @@
+#pragma once
+
+#include "Win32Call.hpp"
+#include "Win32Handle.hpp"
+
+#include <iostream>
+
+namespace rapidio
+{
+	std::optional<FollowView> FollowView::Create(const std::filesystem::path& filepath, size_t startOffset /* = 0 */)
+	{
+		return Create(filepath, Callback{}, startOffset);
+	}
+
+	std::optional<FollowView> FollowView::Create(const std::filesystem::path& filepath, Callback callback, size_t startOffset /* = 0 */)
+	{
+		FollowView view;
+		view.m_state = std::make_unique<detail::FollowState>();
+		view.m_state->callback = std::move(callback);
+
+		if (!view.Start(filepath, startOffset))
+		{
+			return std::nullopt;
+		}
+
+		return view;
+	}
+
+	FollowView::~FollowView()
+	{
+		Stop();
+
+		if (m_state)
+		{
+			UnmapTail(*m_state);
+		}
+	}
+
+	FollowView& FollowView::operator=(FollowView&& other) noexcept
+	{
+		if (this != &other)
+		{
+			Stop();
+
+			if (m_state)
+			{
+				UnmapTail(*m_state);
+			}
+
+			m_state = std::move(other.m_state);
+			m_watcherThread = std::move(other.m_watcherThread);
+		}
+
+		return *this;
+	}
+
+	std::span<const char> FollowView::WaitForData(std::chrono::milliseconds timeout /* = std::chrono::milliseconds::max() */)
+	{
+		if (!m_state)
+		{
+			return {};
+		}
+
+		if (m_state->callback)
+		{
+			std::cerr << "FollowView::WaitForData > Data is handed to the callback of this FollowView\n";
+			return {};
+		}
+
+		std::unique_lock lock(m_state->mutex);
+		auto hasData = [this]() { return m_state->fileSize > m_state->offset || m_state->finished; };
+
+		if (timeout == std::chrono::milliseconds::max())
+		{
+			m_state->dataAvailable.wait(lock, hasData);
+		}
+		else if (!m_state->dataAvailable.wait_for(lock, timeout, hasData))
+		{
+			return {};
+		}
+
+		if (m_state->fileSize <= m_state->offset)
+		{
+			return {};
+		}
+
+		const size_t begin = m_state->offset;
+		const size_t end = m_state->fileSize;
+		m_state->offset = end;
+		lock.unlock();
+
+		return MapTail(*m_state, begin, end);
+	}
+
+	size_t FollowView::GetOffset() const
+	{
+		if (!m_state)
+		{
+			return 0;
+		}
+
+		std::lock_guard lock(m_state->mutex);
+		return m_state->offset;
+	}
+
+	void FollowView::Stop()
+	{
+		if (!m_watcherThread.joinable())
+		{
+			return;
+		}
+
+		CALL_WIN32(SetEvent(m_state->stopEvent.Get()));
+		m_watcherThread.join();
+	}
+
+	bool FollowView::Start(const std::filesystem::path& filepath, size_t startOffset)
+	{
+		detail::FollowState& state = *m_state;
+
+		// Unlike FileView, the file is shared with everyone, the whole point is that someone else keeps writing to it
+		state.fileHandle = Win32Handle{ CALL_WIN32_RV
+		(
+			CreateFileA
+			(
+				filepath.string().c_str(),
+				GENERIC_READ,
+				FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+				nullptr,
+				OPEN_EXISTING,
+				FILE_ATTRIBUTE_NORMAL,
+				nullptr
+			)
+		) };
+
+		if (!state.fileHandle.IsValid())
+		{
+			std::cerr << "FollowView::Create > Could not open " << filepath << "\n";
+			return false;
+		}
+
+		// Change notifications are only available per directory
+		const std::filesystem::path directory = std::filesystem::absolute(filepath).parent_path();
+		state.directoryHandle = Win32Handle{ CALL_WIN32_RV
+		(
+			CreateFileA
+			(
+				directory.string().c_str(),
+				FILE_LIST_DIRECTORY,
+				FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+				nullptr,
+				OPEN_EXISTING,
+				FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED,
+				nullptr
+			)
+		) };
+
+		if (!state.directoryHandle.IsValid())
+		{
+			std::cerr << "FollowView::Create > Could not watch " << directory << "\n";
+			return false;
+		}
+
+		state.changeEvent = Win32Handle{ CALL_WIN32_RV(CreateEventA(nullptr, TRUE, FALSE, nullptr)) };
+		state.stopEvent = Win32Handle{ CALL_WIN32_RV(CreateEventA(nullptr, TRUE, FALSE, nullptr)) };
+
+		if (!state.changeEvent.IsValid() || !state.stopEvent.IsValid())
+		{
+			std::cerr << "FollowView::Create > Could not create events\n";
+			return false;
+		}
+
+		state.overlapped.hEvent = state.changeEvent.Get();
+		state.changes.resize(1024 * 16); // 64 KB, the maximum for directories on network shares
+		state.allocationGranularity = FileView::GetSystemAllocationGranularity();
+		state.offset = startOffset;
+
+		m_watcherThread = std::thread(&FollowView::WatchLoop, m_state.get());
+		return true;
+	}
+
+	void FollowView::WatchLoop(detail::FollowState* state)
+	{
+		while (true)
+		{
+			// The next notification is queued before the size is checked, so an append in between is never missed
+			CALL_WIN32(ResetEvent(state->changeEvent.Get()));
+
+			const BOOL isQueued = CALL_WIN32_RV
+			(
+				ReadDirectoryChangesW
+				(
+					state->directoryHandle.Get(),
+					state->changes.data(),
+					static_cast<DWORD>(state->changes.size() * sizeof(DWORD)),
+					FALSE,
+					FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE,
+					nullptr,
+					&state->overlapped,
+					nullptr
+				)
+			);
+
+			if (!isQueued)
+			{
+				std::cerr << "FollowView > Could not watch for changes\n";
+				break;
+			}
+
+			LARGE_INTEGER filesize{};
+			if (CALL_WIN32_RV(GetFileSizeEx(state->fileHandle.Get(), &filesize)) == 0)
+			{
+				std::cerr << "FollowView > Could not retrieve the file size\n";
+				break;
+			}
+
+			const size_t newSize = static_cast<size_t>(filesize.QuadPart);
+			size_t begin{};
+			{
+				std::lock_guard lock(state->mutex);
+
+				if (newSize < state->offset)
+				{
+					std::cerr << "FollowView > File was truncated, following it from the start\n";
+					state->offset = 0;
+				}
+
+				state->fileSize = newSize;
+				begin = state->offset;
+
+				if (state->callback)
+				{
+					state->offset = newSize;
+				}
+			}
+
+			if (!state->callback)
+			{
+				state->dataAvailable.notify_all();
+			}
+			else if (newSize > begin)
+			{
+				std::span<const char> data = MapTail(*state, begin, newSize);
+				if (!data.empty())
+				{
+					state->callback(data, begin);
+				}
+			}
+
+			HANDLE events[]{ state->changeEvent.Get(), state->stopEvent.Get() };
+			const DWORD signaled = CALL_WIN32_RV(WaitForMultipleObjects(2, events, FALSE, INFINITE));
+
+			// Which entries changed is not inspected: re-reading the size is cheaper than matching names, and also covers an overflowed buffer
+			DWORD bytesReturned{};
+			if (signaled != WAIT_OBJECT_0)
+			{
+				CALL_WIN32(CancelIoEx(state->directoryHandle.Get(), &state->overlapped));
+				CALL_WIN32_IGNORE_ERROR(GetOverlappedResult(state->directoryHandle.Get(), &state->overlapped, &bytesReturned, TRUE), ERROR_OPERATION_ABORTED);
+				break;
+			}
+
+			CALL_WIN32(GetOverlappedResult(state->directoryHandle.Get(), &state->overlapped, &bytesReturned, FALSE));
+		}
+
+		std::lock_guard lock(state->mutex);
+		state->finished = true;
+		state->dataAvailable.notify_all();
+	}
+
+	std::span<const char> FollowView::MapTail(detail::FollowState& state, size_t begin, size_t end)
+	{
+		UnmapTail(state);
+
+		// Only the appended bytes are mapped, the view just has to start on an allocation granularity boundary
+		const size_t viewOffset = begin / state.allocationGranularity * state.allocationGranularity;
+
+		state.tailMappingHandle = Win32Handle{ CALL_WIN32_RV
+		(
+			CreateFileMappingA
+			(
+				state.fileHandle.Get(),
+				nullptr,
+				PAGE_READONLY,
+				static_cast<DWORD>(static_cast<uint64_t>(end) >> 32),
+				static_cast<DWORD>(end),
+				nullptr
+			)
+		) };
+
+		if (!state.tailMappingHandle.IsValid())
+		{
+			std::cerr << "FollowView > Could not map the file\n";
+			return {};
+		}
+
+		state.tailView = Win32MappedView{ CALL_WIN32_RV
+		(
+			MapViewOfFile
+			(
+				state.tailMappingHandle.Get(),
+				FILE_MAP_READ,
+				static_cast<DWORD>(static_cast<uint64_t>(viewOffset) >> 32),
+				static_cast<DWORD>(viewOffset),
+				end - viewOffset
+			)
+		) };
+
+		if (!state.tailView.IsValid())
+		{
+			std::cerr << "FollowView > Could not map the appended data\n";
+			return {};
+		}
+
+		return { static_cast<const char*>(state.tailView.Get()) + (begin - viewOffset), end - begin };
+	}
+
+	void FollowView::UnmapTail(detail::FollowState& state)
+	{
+		state.tailView.Release();
+		state.tailMappingHandle.Release();
+	}
+} // namespace rapidio
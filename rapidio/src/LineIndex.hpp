@@ -0,0 +1,444 @@
+#pragma once
+
+#include "rapidio.hpp"
+#include "ChecksumUtils.hpp"
+#include "ScanUtils.hpp"
+#include "ThreadUtils.hpp"
+
+#include <bit>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace rapidio
+{
+	namespace detail
+	{
+		constexpr char LineIndexMagic[8] = { 'R', 'I', 'O', 'L', 'I', 'N', 'E', 'S' };
+		constexpr uint32_t LineIndexVersion = 2;
+
+		struct LineIndexHeader
+		{
+			char magic[8];
+			uint32_t version;
+			uint32_t stride;
+			uint64_t indexedSize;
+			uint64_t nrOfNewlines;
+			uint32_t prefixChecksum;
+			uint32_t reserved;
+			uint64_t nrOfCheckpoints;
+		};
+	} // namespace detail
+
+	/// <summary>
+	/// Index of the line starts of a text file for O(1) random line access. The offset of every 'stride'-th line is stored in a small sidecar file,
+	/// a line in between is found by skipping at most 'stride - 1' newlines with SIMD. The index is built with a parallel scan, and when a file has
+	/// only grown since its sidecar was written, only the new tail is scanned. Whether the file has only grown is decided with a CRC32C of the whole
+	/// indexed prefix, so any edit of already indexed data, including one that keeps the file size, causes a rebuild. Lines are returned as std::string_views into the mapped view,
+	/// without their line ending ('\n' or "\r\n"), and are valid as long as the mapping is not re-allocated
+	/// </summary>
+	class LineIndex final
+	{
+	public:
+		static constexpr size_t DefaultStride = 1024;
+
+		/// <summary>
+		/// Loads the index of 'view' from 'sidecarPath', scanning only the new tail if the file has grown. If the sidecar is missing, belongs to a
+		/// different file, was built with another stride or the indexed data has changed, the index is rebuilt. The sidecar is (re)written whenever the index changed
+		/// </summary>
+		/// <param name="view">View of the text file</param>
+		/// <param name="sidecarPath">Path to the sidecar file</param>
+		/// <param name="stride">Every 'stride'-th line start is stored</param>
+		/// <param name="nrOfThreads">Number of threads to scan with, 0 means every hardware thread</param>
+		/// <returns>std::nullopt if the sidecar file could not be written</returns>
+		template<FileAccessMode Access>
+		static std::optional<LineIndex> Open(const BasicFileView<Access>& view, const std::filesystem::path& sidecarPath, size_t stride = DefaultStride,
+			size_t nrOfThreads = 0);
+
+		/// <summary>
+		/// Re-targets the index to 'view', e.g. after the file has grown, and updates the sidecar file
+		/// </summary>
+		/// <returns>Returns false if the sidecar file could not be written</returns>
+		template<FileAccessMode Access>
+		bool Update(const BasicFileView<Access>& view, size_t nrOfThreads = 0);
+
+		size_t GetNrOfLines() const;
+
+		/// <summary>
+		/// Returns line 'line' (0-based), std::nullopt if the file has fewer lines
+		/// </summary>
+		std::optional<std::string_view> GetLine(size_t line) const;
+
+		/// <summary>
+		/// Returns up to 'count' consecutive lines starting at line 'firstLine'
+		/// </summary>
+		std::vector<std::string_view> GetLines(size_t firstLine, size_t count) const;
+
+	private:
+		// Newlines are counted and checkpoints are collected per chunk of this size, every chunk is a task for the thread pool
+		static constexpr size_t ChunkSize = 1024 * 1024 * 4; // 4 MB
+
+		LineIndex(std::filesystem::path sidecarPath, size_t stride);
+
+		void Reset();
+		template<FileAccessMode Access>
+		bool LoadSidecar(const BasicFileView<Access>& view, size_t nrOfThreads);
+		bool SaveSidecar() const;
+		bool Extend(size_t nrOfThreads);
+		void IndexTail(size_t nrOfThreads);
+		size_t SkipLines(size_t offset, size_t nrOfLines) const;
+		std::string_view GetLineAt(size_t offset) const;
+		template<FileAccessMode Access>
+		static uint32_t GetPrefixChecksum(const BasicFileView<Access>& view, size_t size, size_t nrOfThreads);
+
+		std::filesystem::path m_sidecarPath;
+		std::string_view m_data;
+		size_t m_stride;
+
+		// Number of bytes of 'm_data' covered by the index, and the number of newlines in them
+		size_t m_indexedSize = 0;
+		size_t m_nrOfNewlines = 0;
+
+		// Checksum of the indexed data
+		uint32_t m_prefixChecksum = 0;
+
+		// Offset of the start of line 'i * m_stride'
+		std::vector<uint64_t> m_checkpoints{ 0 };
+	};
+
+	LineIndex::LineIndex(std::filesystem::path sidecarPath, size_t stride)
+		: m_sidecarPath(std::move(sidecarPath))
+		, m_stride(stride)
+	{
+	}
+
+	template<FileAccessMode Access>
+	std::optional<LineIndex> LineIndex::Open(const BasicFileView<Access>& view, const std::filesystem::path& sidecarPath, size_t stride /* = DefaultStride */,
+		size_t nrOfThreads /* = 0 */)
+	{
+		if (stride == 0 || stride > std::numeric_limits<uint32_t>::max())
+		{
+			std::cerr << "LineIndex::Open > Invalid stride " << stride << "\n";
+			return std::nullopt;
+		}
+
+		LineIndex index{ sidecarPath, stride };
+		index.m_data = { view.GetData(), view.GetMappedSize() };
+
+		// A sidecar that cannot be used is not an error, the index is simply rebuilt
+		if (!index.LoadSidecar(view, nrOfThreads))
+		{
+			index.Reset();
+		}
+
+		if (!index.Extend(nrOfThreads))
+		{
+			return std::nullopt;
+		}
+
+		return index;
+	}
+
+	template<FileAccessMode Access>
+	bool LineIndex::Update(const BasicFileView<Access>& view, size_t nrOfThreads /* = 0 */)
+	{
+		m_data = { view.GetData(), view.GetMappedSize() };
+
+		// If the indexed data changed instead of only being appended to, nothing of the index can be trusted anymore
+		const bool hasOnlyGrown = m_indexedSize <= m_data.size() && GetPrefixChecksum(view, m_indexedSize, nrOfThreads) == m_prefixChecksum;
+
+		if (!hasOnlyGrown)
+		{
+			Reset();
+		}
+
+		return Extend(nrOfThreads);
+	}
+
+	size_t LineIndex::GetNrOfLines() const
+	{
+		// The last line does not need a terminating newline
+		const bool hasUnterminatedLine = !m_data.empty() && m_data.back() != '\n';
+		return m_nrOfNewlines + (hasUnterminatedLine ? 1 : 0);
+	}
+
+	std::optional<std::string_view> LineIndex::GetLine(size_t line) const
+	{
+		if (line >= GetNrOfLines())
+		{
+			return std::nullopt;
+		}
+
+		return GetLineAt(SkipLines(static_cast<size_t>(m_checkpoints[line / m_stride]), line % m_stride));
+	}
+
+	std::vector<std::string_view> LineIndex::GetLines(size_t firstLine, size_t count) const
+	{
+		std::vector<std::string_view> lines;
+		if (firstLine >= GetNrOfLines())
+		{
+			return lines;
+		}
+
+		count = std::min(count, GetNrOfLines() - firstLine);
+		lines.reserve(count);
+
+		size_t offset = SkipLines(static_cast<size_t>(m_checkpoints[firstLine / m_stride]), firstLine % m_stride);
+		for (size_t i{}; i < count; ++i)
+		{
+			const std::string_view line = GetLineAt(offset);
+			lines.push_back(line);
+			offset = SkipLines(offset, 1);
+		}
+
+		return lines;
+	}
+
+	void LineIndex::Reset()
+	{
+		m_indexedSize = 0;
+		m_nrOfNewlines = 0;
+		m_prefixChecksum = 0;
+		m_checkpoints = { 0 };
+	}
+
+	template<FileAccessMode Access>
+	bool LineIndex::LoadSidecar(const BasicFileView<Access>& view, size_t nrOfThreads)
+	{
+		if (!PathUtils::DoesFileExist(m_sidecarPath))
+		{
+			return false;
+		}
+
+		std::optional<ReadOnlyFileView> sidecar = ReadOnlyFileView::CreateViewFromExistingFile(m_sidecarPath, FileOpenMode::OpenExisting);
+		if (!sidecar)
+		{
+			return false;
+		}
+
+		const std::string_view headerData = sidecar->ReadView(sizeof(detail::LineIndexHeader));
+		if (headerData.size() != sizeof(detail::LineIndexHeader))
+		{
+			return false;
+		}
+
+		detail::LineIndexHeader header;
+		std::memcpy(&header, headerData.data(), sizeof(header));
+
+		if (std::memcmp(header.magic, detail::LineIndexMagic, sizeof(header.magic)) != 0 || header.version != detail::LineIndexVersion ||
+			header.stride != m_stride)
+		{
+			return false;
+		}
+
+		// The counts have to be consistent with each other before they are used to size anything
+		if (header.indexedSize > m_data.size() || header.nrOfNewlines > header.indexedSize ||
+			header.nrOfCheckpoints != header.nrOfNewlines / m_stride + 1)
+		{
+			return false;
+		}
+
+		const std::string_view checkpointData = sidecar->ReadView(header.nrOfCheckpoints * sizeof(uint64_t));
+		if (checkpointData.size() != header.nrOfCheckpoints * sizeof(uint64_t))
+		{
+			return false;
+		}
+
+		std::vector<uint64_t> checkpoints(header.nrOfCheckpoints);
+		std::memcpy(checkpoints.data(), checkpointData.data(), checkpointData.size());
+
+		// Every checkpoint starts a line after the previous one, and the first line starts at 0
+		if (checkpoints[0] != 0)
+		{
+			return false;
+		}
+
+		for (size_t i{ 1 }; i < checkpoints.size(); ++i)
+		{
+			if (checkpoints[i] <= checkpoints[i - 1] || checkpoints[i] > header.indexedSize)
+			{
+				return false;
+			}
+		}
+
+		// Only reuse the index if the data it covers is still the same, i.e. the file has at most grown
+		if (header.prefixChecksum != GetPrefixChecksum(view, static_cast<size_t>(header.indexedSize), nrOfThreads))
+		{
+			return false;
+		}
+
+		m_indexedSize = static_cast<size_t>(header.indexedSize);
+		m_prefixChecksum = header.prefixChecksum;
+		m_nrOfNewlines = static_cast<size_t>(header.nrOfNewlines);
+		m_checkpoints = std::move(checkpoints);
+		return true;
+	}
+
+	bool LineIndex::SaveSidecar() const
+	{
+		detail::LineIndexHeader header{};
+		std::memcpy(header.magic, detail::LineIndexMagic, sizeof(header.magic));
+		header.version = detail::LineIndexVersion;
+		header.stride = static_cast<uint32_t>(m_stride);
+		header.indexedSize = m_indexedSize;
+		header.nrOfNewlines = m_nrOfNewlines;
+		header.prefixChecksum = m_prefixChecksum;
+		header.nrOfCheckpoints = m_checkpoints.size();
+
+		std::string data(sizeof(header) + m_checkpoints.size() * sizeof(uint64_t), '\0');
+		std::memcpy(data.data(), &header, sizeof(header));
+		std::memcpy(data.data() + sizeof(header), m_checkpoints.data(), m_checkpoints.size() * sizeof(uint64_t));
+
+		if (PathUtils::DoesFileExist(m_sidecarPath))
+		{
+			std::filesystem::remove(m_sidecarPath);
+		}
+
+		std::optional<FileView> sidecar = FileView::CreateViewForNewFile(m_sidecarPath, data.size());
+		if (!sidecar || !sidecar->Write(data, 0, false, false))
+		{
+			std::cerr << "LineIndex > Could not write " << m_sidecarPath << "\n";
+			return false;
+		}
+
+		return true;
+	}
+
+	bool LineIndex::Extend(size_t nrOfThreads)
+	{
+		if (m_indexedSize == m_data.size())
+		{
+			return true;
+		}
+
+		IndexTail(nrOfThreads);
+		return SaveSidecar();
+	}
+
+	void LineIndex::IndexTail(size_t nrOfThreads)
+	{
+		const char newline[]{ '\n' };
+		const size_t begin = m_indexedSize;
+		const size_t nrOfChunks = (m_data.size() - begin + ChunkSize - 1) / ChunkSize;
+
+		auto getChunk = [this, begin](size_t chunk)
+		{
+			const size_t chunkStart = begin + chunk * ChunkSize;
+			return std::pair<size_t, size_t>{ chunkStart, std::min(m_data.size(), chunkStart + ChunkSize) };
+		};
+
+		// Pass 1: count the newlines of every chunk, so every chunk knows the number of the first line it contains. The chunk is checksummed
+		// while it is in cache, extending the checksum of the indexed prefix
+		std::vector<size_t> newlineCounts(nrOfChunks);
+		std::vector<uint32_t> chunkChecksums(nrOfChunks);
+		ParallelFor(nrOfChunks, nrOfThreads, [&](size_t chunk)
+			{
+				const auto [chunkStart, chunkEnd] = getChunk(chunk);
+				size_t count{};
+
+				for (size_t block = chunkStart; block < chunkEnd; block += ScanBlockSize)
+				{
+					uint64_t mask;
+					MatchBytesPartial(m_data.data() + block, chunkEnd - block, newline, &mask);
+					count += std::popcount(mask);
+				}
+
+				newlineCounts[chunk] = count;
+				chunkChecksums[chunk] = Crc32c(m_data.data() + chunkStart, chunkEnd - chunkStart);
+			});
+
+		std::vector<size_t> firstNewline(nrOfChunks);
+		size_t nrOfNewlines = m_nrOfNewlines;
+		for (size_t chunk{}; chunk < nrOfChunks; ++chunk)
+		{
+			const auto [chunkStart, chunkEnd] = getChunk(chunk);
+			firstNewline[chunk] = nrOfNewlines;
+			nrOfNewlines += newlineCounts[chunk];
+			m_prefixChecksum = Crc32cCombine(m_prefixChecksum, chunkChecksums[chunk], chunkEnd - chunkStart);
+		}
+
+		// Pass 2: every chunk knows which checkpoints it contains, so it can fill them in directly
+		m_checkpoints.resize(1 + nrOfNewlines / m_stride);
+		ParallelFor(nrOfChunks, nrOfThreads, [&](size_t chunk)
+			{
+				const auto [chunkStart, chunkEnd] = getChunk(chunk);
+				size_t nrOfNewlinesSoFar = firstNewline[chunk];
+
+				for (size_t block = chunkStart; block < chunkEnd; block += ScanBlockSize)
+				{
+					uint64_t mask;
+					MatchBytesPartial(m_data.data() + block, chunkEnd - block, newline, &mask);
+
+					// Skip blocks without a checkpoint without looking at their newlines one by one
+					const size_t count = std::popcount(mask);
+					if ((nrOfNewlinesSoFar % m_stride) + count < m_stride)
+					{
+						nrOfNewlinesSoFar += count;
+						continue;
+					}
+
+					for (; mask != 0; mask &= mask - 1)
+					{
+						if (++nrOfNewlinesSoFar % m_stride == 0)
+						{
+							m_checkpoints[nrOfNewlinesSoFar / m_stride] = block + std::countr_zero(mask) + 1;
+						}
+					}
+				}
+			});
+
+		m_nrOfNewlines = nrOfNewlines;
+		m_indexedSize = m_data.size();
+	}
+
+	size_t LineIndex::SkipLines(size_t offset, size_t nrOfLines) const
+	{
+		const char newline[]{ '\n' };
+
+		while (nrOfLines > 0 && offset < m_data.size())
+		{
+			uint64_t mask;
+			MatchBytesPartial(m_data.data() + offset, m_data.size() - offset, newline, &mask);
+
+			const size_t count = std::popcount(mask);
+			if (count < nrOfLines)
+			{
+				nrOfLines -= count;
+				offset += ScanBlockSize;
+				continue;
+			}
+
+			for (; nrOfLines > 1; --nrOfLines)
+			{
+				mask &= mask - 1;
+			}
+
+			return offset + std::countr_zero(mask) + 1;
+		}
+
+		return std::min(offset, m_data.size());
+	}
+
+	std::string_view LineIndex::GetLineAt(size_t offset) const
+	{
+		std::string_view line = m_data.substr(offset);
+		line = line.substr(0, FindPattern(line, "\n"));
+
+		if (!line.empty() && line.back() == '\r')
+		{
+			line.remove_suffix(1);
+		}
+
+		return line;
+	}
+
+	template<FileAccessMode Access>
+	uint32_t LineIndex::GetPrefixChecksum(const BasicFileView<Access>& view, size_t size, size_t nrOfThreads)
+	{
+		return view.Checksum({ 0, size }, nrOfThreads).value_or(0);
+	}
+} // namespace rapidio
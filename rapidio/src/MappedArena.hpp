@@ -0,0 +1,730 @@
+#pragma once
+
+#include "rapidio.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+
+namespace rapidio
+{
+	/// <summary>
+	/// Pointer that stores the distance between itself and the object it points to, instead of an absolute address.
+	/// An object graph built out of OffsetPtrs inside a single mapping stays valid no matter at which address the mapping ends up.
+	/// Copying an OffsetPtr re-bases the distance to the new location, so it can be copied and moved like a regular pointer
+	/// </summary>
+	template<typename T>
+	class OffsetPtr final
+	{
+	public:
+		OffsetPtr() = default;
+		OffsetPtr(std::nullptr_t) {}
+		OffsetPtr(T* ptr) { Set(ptr); }
+		OffsetPtr(const OffsetPtr& other) { Set(other.Get()); }
+
+		OffsetPtr& operator=(const OffsetPtr& other)
+		{
+			Set(other.Get());
+			return *this;
+		}
+
+		OffsetPtr& operator=(T* ptr)
+		{
+			Set(ptr);
+			return *this;
+		}
+
+		T* Get() const
+		{
+			if (m_offset == NullOffset)
+			{
+				return nullptr;
+			}
+
+			return reinterpret_cast<T*>(reinterpret_cast<uintptr_t>(this) + m_offset);
+		}
+
+		T* operator->() const { return Get(); }
+		T& operator*() const { return *Get(); }
+		T& operator[](size_t index) const { return Get()[index]; }
+
+		explicit operator bool() const { return m_offset != NullOffset; }
+		bool operator==(const OffsetPtr& other) const { return Get() == other.Get(); }
+		bool operator==(const T* other) const { return Get() == other; }
+
+	private:
+		// An object can never start at the second byte of the OffsetPtr pointing to it, so this is free to use as null
+		static constexpr std::ptrdiff_t NullOffset = 1;
+
+		void Set(T* ptr)
+		{
+			m_offset = ptr ? reinterpret_cast<intptr_t>(ptr) - reinterpret_cast<intptr_t>(this) : NullOffset;
+		}
+
+		std::ptrdiff_t m_offset = NullOffset;
+	};
+
+	/// <summary>
+	/// Computes a hash over the size and alignment of the given types. Pass the types stored in a MappedArena to detect layout changes
+	/// between the program that wrote the arena and the program that opens it
+	/// </summary>
+	template<typename... Ts>
+	constexpr uint64_t ComputeLayoutHash(uint64_t seed = 0)
+	{
+		// FNV-1a
+		uint64_t hash = 14695981039346656037ULL ^ seed;
+		const auto combine = [&hash](uint64_t value) { hash = (hash ^ value) * 1099511628211ULL; };
+
+		(combine(sizeof(Ts)), ...);
+		(combine(alignof(Ts)), ...);
+		return hash;
+	}
+
+	namespace detail
+	{
+		struct ArenaHeader
+		{
+			char magic[8];
+			uint32_t formatVersion;
+			uint32_t version;
+			uint64_t layoutHash;
+			uint64_t usedSize;
+			uint64_t rootOffset;
+		};
+
+		constexpr char ArenaMagic[8] = { 'R', 'I', 'O', 'A', 'R', 'E', 'N', 'A' };
+		constexpr uint32_t ArenaFormatVersion = 1;
+	} // namespace detail
+
+	/// <summary>
+	/// Bump allocator inside a growable memory-mapped file. Objects are linked with OffsetPtrs, so an arena can be closed and re-opened
+	/// at any address and its object graph is usable immediately, without any parsing.
+	/// !!! IMPORTANT !!! Allocating can grow, and therefore re-map, the file. Raw pointers and references into the arena obtained before an
+	/// allocation must be re-resolved afterwards, either through the root object or through offsets (see 'OffsetOf()' and 'Resolve()').
+	/// Reserving enough space up front avoids re-mapping altogether
+	/// </summary>
+	class MappedArena final
+	{
+	public:
+		static constexpr size_t DefaultInitialSize = 1024 * 1024; // 1 MB
+
+		/// <summary>
+		/// Creates a new arena file
+		/// </summary>
+		/// <param name="filepath">Path to the arena file. The file cannot already exist</param>
+		/// <param name="version">User version of the data stored in the arena</param>
+		/// <param name="layoutHash">Hash of the layout of the data stored in the arena, see 'ComputeLayoutHash()'</param>
+		/// <param name="initialSize">Initial size of the arena file</param>
+		/// <returns>std::nullopt if the arena could not be created. A valid optional of a MappedArena otherwise</returns>
+		static std::optional<MappedArena> Create(const std::filesystem::path& filepath, uint32_t version, uint64_t layoutHash,
+			size_t initialSize = DefaultInitialSize);
+
+		/// <summary>
+		/// Opens an existing arena file
+		/// </summary>
+		/// <param name="filepath">Path to the arena file</param>
+		/// <param name="version">Expected user version of the data stored in the arena</param>
+		/// <param name="layoutHash">Expected layout hash of the data stored in the arena</param>
+		/// <returns>std::nullopt if the file is not an arena, or if its version or layout hash do not match</returns>
+		static std::optional<MappedArena> Open(const std::filesystem::path& filepath, uint32_t version, uint64_t layoutHash);
+
+		/// <summary>
+		/// Allocates zero-initialised memory inside the arena
+		/// </summary>
+		/// <param name="size">Number of bytes to allocate</param>
+		/// <param name="alignment">Alignment of the allocation, must be a power of 2</param>
+		/// <returns>Offset of the allocation from the start of the arena, or 0 if the arena could not grow</returns>
+		size_t Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+		/// <summary>
+		/// Allocates and constructs a T inside the arena. The arguments must not live inside the arena
+		/// </summary>
+		/// <returns>Pointer to the new object, valid until the next allocation. nullptr if the arena could not grow</returns>
+		template<typename T, typename... Args>
+		T* New(Args&&... args);
+
+		// Makes sure 'size' more bytes can be allocated without growing the file
+		bool Reserve(size_t size);
+
+		template<typename T>
+		T* Resolve(size_t offset);
+
+		template<typename T>
+		const T* Resolve(size_t offset) const;
+
+		// Returns the offset of 'ptr' from the start of the arena. 'ptr' must point inside the arena
+		size_t OffsetOf(const void* ptr) const;
+
+		bool Contains(const void* ptr) const;
+
+		// Sets the object returned by 'GetRoot()', the entry point of the object graph after re-opening the arena
+		template<typename T>
+		void SetRoot(T* root);
+
+		// Returns the root object of the arena, or nullptr if none was set
+		template<typename T>
+		T* GetRoot();
+
+		size_t GetUsedSize() const;
+		size_t GetCapacity() const;
+
+	private:
+		explicit MappedArena(FileView&& view);
+
+		detail::ArenaHeader* GetHeader();
+		const detail::ArenaHeader* GetHeader() const;
+
+		FileView m_view;
+	};
+
+	/// <summary>
+	/// Vector living inside a MappedArena. Growing allocates a new buffer from the arena, the old buffer is not reused
+	/// </summary>
+	template<typename T>
+	class ArenaVector final
+	{
+		static_assert(std::is_trivially_destructible_v<T>, "Arena objects are never destroyed");
+
+	public:
+		size_t Size() const { return m_size; }
+		size_t Capacity() const { return m_capacity; }
+		bool Empty() const { return m_size == 0; }
+
+		T* Data() { return m_data.Get(); }
+		const T* Data() const { return m_data.Get(); }
+
+		T& operator[](size_t index) { return m_data[index]; }
+		const T& operator[](size_t index) const { return m_data[index]; }
+
+		T* begin() { return Data(); }
+		T* end() { return Data() + m_size; }
+		const T* begin() const { return Data(); }
+		const T* end() const { return Data() + m_size; }
+
+		void Clear() { m_size = 0; }
+
+		// Makes sure 'capacity' elements fit without growing. The vector itself may move, see MappedArena
+		bool Reserve(MappedArena& arena, size_t capacity);
+
+		// Appends 'value'. If T is not trivially copyable, 'value' must not live inside the arena
+		bool PushBack(MappedArena& arena, const T& value);
+
+	private:
+		ArenaVector* Grow(MappedArena& arena, size_t capacity);
+
+		OffsetPtr<T> m_data;
+		uint64_t m_size = 0;
+		uint64_t m_capacity = 0;
+	};
+
+	/// <summary>
+	/// Immutable-content string living inside a MappedArena. The characters are always null-terminated
+	/// </summary>
+	class ArenaString final
+	{
+	public:
+		size_t Size() const { return m_size; }
+		bool Empty() const { return m_size == 0; }
+		const char* CStr() const { return m_data ? m_data.Get() : ""; }
+		std::string_view View() const { return { CStr(), m_size }; }
+
+		operator std::string_view() const { return View(); }
+		bool operator==(std::string_view other) const { return View() == other; }
+		bool operator==(const ArenaString& other) const { return View() == other.View(); }
+
+		// Copies 'value' into the arena. The string itself may move, see MappedArena
+		bool Assign(MappedArena& arena, std::string_view value);
+
+	private:
+		OffsetPtr<char> m_data;
+		uint64_t m_size = 0;
+	};
+
+	template<typename Key>
+	struct ArenaHash
+	{
+		size_t operator()(const Key& key) const
+		{
+			// Mix the bits, std::hash is the identity for integers on most standard libraries
+			uint64_t hash = static_cast<uint64_t>(std::hash<Key>{}(key));
+			hash ^= hash >> 33;
+			hash *= 0xff51afd7ed558ccdULL;
+			hash ^= hash >> 33;
+			return static_cast<size_t>(hash);
+		}
+	};
+
+	template<>
+	struct ArenaHash<ArenaString>
+	{
+		size_t operator()(std::string_view key) const { return std::hash<std::string_view>{}(key); }
+	};
+
+	/// <summary>
+	/// Open-addressing (linear probing) hash map living inside a MappedArena.
+	/// Lookups accept any type 'Hash' and 'operator==' accept, so an ArenaHashMap with ArenaString keys can be searched with a std::string_view
+	/// </summary>
+	template<typename Key, typename Value, typename Hash = ArenaHash<Key>>
+	class ArenaHashMap final
+	{
+		static_assert(std::is_trivially_destructible_v<Key> && std::is_trivially_destructible_v<Value>, "Arena objects are never destroyed");
+
+	public:
+		struct Slot
+		{
+			Key key;
+			Value value;
+			bool occupied;
+		};
+
+		size_t Size() const { return m_size; }
+		bool Empty() const { return m_size == 0; }
+
+		// Returns a pointer to the value of 'key', valid until the next allocation. nullptr if 'key' is not in the map
+		template<typename Lookup>
+		Value* Find(const Lookup& key);
+
+		template<typename Lookup>
+		const Value* Find(const Lookup& key) const;
+
+		/// <summary>
+		/// Inserts or overwrites 'key'. ArenaString keys are copied into the arena, other keys and non-trivially copyable values must not live inside the arena.
+		/// The map itself may move, see MappedArena
+		/// </summary>
+		/// <returns>Returns true if the key was inserted or overwritten</returns>
+		template<typename Lookup>
+		bool Insert(MappedArena& arena, const Lookup& key, const Value& value);
+
+		// Calls 'func(key, value)' for every entry in the map
+		template<typename Func>
+		void ForEach(Func&& func) const;
+
+	private:
+		static constexpr size_t MinimumCapacity = 16;
+
+		template<typename Lookup>
+		size_t FindSlot(const Lookup& key) const;
+
+		ArenaHashMap* Rehash(MappedArena& arena, size_t capacity);
+
+		OffsetPtr<Slot> m_slots;
+		uint64_t m_size = 0;
+		uint64_t m_capacity = 0;
+	};
+
+	std::optional<MappedArena> MappedArena::Create(const std::filesystem::path& filepath, uint32_t version, uint64_t layoutHash,
+		size_t initialSize /* = DefaultInitialSize */)
+	{
+		std::optional<FileView> view = FileView::CreateViewForNewFile(filepath, std::max(initialSize, sizeof(detail::ArenaHeader)));
+		if (!view)
+		{
+			return std::nullopt;
+		}
+
+		MappedArena arena(std::move(*view));
+
+		detail::ArenaHeader* header = arena.GetHeader();
+		std::memcpy(header->magic, detail::ArenaMagic, sizeof(header->magic));
+		header->formatVersion = detail::ArenaFormatVersion;
+		header->version = version;
+		header->layoutHash = layoutHash;
+		header->usedSize = sizeof(detail::ArenaHeader);
+		header->rootOffset = 0;
+
+		return arena;
+	}
+
+	std::optional<MappedArena> MappedArena::Open(const std::filesystem::path& filepath, uint32_t version, uint64_t layoutHash)
+	{
+		std::optional<FileView> view = FileView::CreateViewFromExistingFile(filepath, FileAccessMode::ReadWrite, FileOpenMode::OpenExisting);
+		if (!view)
+		{
+			return std::nullopt;
+		}
+
+		if (view->GetMappedSize() < sizeof(detail::ArenaHeader))
+		{
+			std::cerr << "MappedArena::Open > " << filepath << " is too small to be an arena\n";
+			return std::nullopt;
+		}
+
+		MappedArena arena(std::move(*view));
+
+		const detail::ArenaHeader* header = arena.GetHeader();
+		if (std::memcmp(header->magic, detail::ArenaMagic, sizeof(header->magic)) != 0 || header->formatVersion != detail::ArenaFormatVersion)
+		{
+			std::cerr << "MappedArena::Open > " << filepath << " is not an arena\n";
+			return std::nullopt;
+		}
+
+		if (header->version != version || header->layoutHash != layoutHash)
+		{
+			std::cerr << "MappedArena::Open > " << filepath << " was written with an incompatible version or layout\n";
+			return std::nullopt;
+		}
+
+		if (header->usedSize > arena.GetCapacity() || header->rootOffset >= header->usedSize)
+		{
+			std::cerr << "MappedArena::Open > " << filepath << " is corrupt\n";
+			return std::nullopt;
+		}
+
+		return arena;
+	}
+
+	size_t MappedArena::Allocate(size_t size, size_t alignment /* = alignof(std::max_align_t) */)
+	{
+		assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+		const size_t offset = (GetHeader()->usedSize + alignment - 1) & ~(alignment - 1);
+
+		if (offset + size > GetCapacity())
+		{
+			// Grow geometrically, every growth re-maps the file
+			if (!m_view.Reserve(std::max(GetCapacity() * 2, offset + size)))
+			{
+				std::cerr << "MappedArena::Allocate > Could not grow arena\n";
+				return 0;
+			}
+		}
+
+		GetHeader()->usedSize = offset + size;
+		return offset;
+	}
+
+	template<typename T, typename... Args>
+	T* MappedArena::New(Args&&... args)
+	{
+		const size_t offset = Allocate(sizeof(T), alignof(T));
+		if (offset == 0)
+		{
+			return nullptr;
+		}
+
+		return new (Resolve<T>(offset)) T(std::forward<Args>(args)...);
+	}
+
+	bool MappedArena::Reserve(size_t size)
+	{
+		return m_view.Reserve(GetHeader()->usedSize + size);
+	}
+
+	template<typename T>
+	T* MappedArena::Resolve(size_t offset)
+	{
+		return reinterpret_cast<T*>(m_view.GetData() + offset);
+	}
+
+	template<typename T>
+	const T* MappedArena::Resolve(size_t offset) const
+	{
+		return reinterpret_cast<const T*>(m_view.GetData() + offset);
+	}
+
+	size_t MappedArena::OffsetOf(const void* ptr) const
+	{
+		assert(Contains(ptr));
+		return static_cast<size_t>(static_cast<const char*>(ptr) - m_view.GetData());
+	}
+
+	bool MappedArena::Contains(const void* ptr) const
+	{
+		const char* const data = m_view.GetData();
+		return static_cast<const char*>(ptr) >= data && static_cast<const char*>(ptr) < data + GetCapacity();
+	}
+
+	template<typename T>
+	void MappedArena::SetRoot(T* root)
+	{
+		GetHeader()->rootOffset = root ? OffsetOf(root) : 0;
+	}
+
+	template<typename T>
+	T* MappedArena::GetRoot()
+	{
+		const size_t rootOffset = GetHeader()->rootOffset;
+		return rootOffset == 0 ? nullptr : Resolve<T>(rootOffset);
+	}
+
+	size_t MappedArena::GetUsedSize() const
+	{
+		return GetHeader()->usedSize;
+	}
+
+	size_t MappedArena::GetCapacity() const
+	{
+		return m_view.GetMappedSize();
+	}
+
+	MappedArena::MappedArena(FileView&& view)
+		: m_view(std::move(view))
+	{
+	}
+
+	detail::ArenaHeader* MappedArena::GetHeader()
+	{
+		return Resolve<detail::ArenaHeader>(0);
+	}
+
+	const detail::ArenaHeader* MappedArena::GetHeader() const
+	{
+		return Resolve<detail::ArenaHeader>(0);
+	}
+
+	template<typename T>
+	bool ArenaVector<T>::Reserve(MappedArena& arena, size_t capacity)
+	{
+		return capacity <= m_capacity || Grow(arena, capacity) != nullptr;
+	}
+
+	template<typename T>
+	bool ArenaVector<T>::PushBack(MappedArena& arena, const T& value)
+	{
+		ArenaVector* self = this;
+
+		if (m_size == m_capacity)
+		{
+			if constexpr (std::is_trivially_copyable_v<T>)
+			{
+				// 'value' might live inside the arena, so take a copy before growing
+				const T copy = value;
+				self = Grow(arena, std::max<size_t>(4, m_capacity * 2));
+				if (!self)
+				{
+					return false;
+				}
+
+				new (self->m_data.Get() + self->m_size++) T(copy);
+				return true;
+			}
+			else
+			{
+				self = Grow(arena, std::max<size_t>(4, m_capacity * 2));
+				if (!self)
+				{
+					return false;
+				}
+			}
+		}
+
+		new (self->m_data.Get() + self->m_size++) T(value);
+		return true;
+	}
+
+	template<typename T>
+	ArenaVector<T>* ArenaVector<T>::Grow(MappedArena& arena, size_t capacity)
+	{
+		// Allocating might re-map the arena, so remember where we live
+		const size_t selfOffset = arena.OffsetOf(this);
+
+		const size_t dataOffset = arena.Allocate(capacity * sizeof(T), alignof(T));
+		if (dataOffset == 0)
+		{
+			return nullptr;
+		}
+
+		ArenaVector* self = arena.Resolve<ArenaVector>(selfOffset);
+		T* const newData = arena.Resolve<T>(dataOffset);
+
+		// Copy-construct rather than memcpy, so OffsetPtrs inside the elements are re-based to their new location
+		for (size_t i{}; i < self->m_size; ++i)
+		{
+			new (newData + i) T(self->m_data[i]);
+		}
+
+		self->m_data = newData;
+		self->m_capacity = capacity;
+		return self;
+	}
+
+	bool ArenaString::Assign(MappedArena& arena, std::string_view value)
+	{
+		// Both this string and 'value' might live inside the arena, so remember their offsets in case allocating re-maps the arena
+		const size_t selfOffset = arena.OffsetOf(this);
+		const bool isValueInArena = !value.empty() && arena.Contains(value.data());
+		const size_t valueOffset = isValueInArena ? arena.OffsetOf(value.data()) : 0;
+
+		const size_t dataOffset = arena.Allocate(value.size() + 1, 1);
+		if (dataOffset == 0)
+		{
+			return false;
+		}
+
+		if (isValueInArena)
+		{
+			value = { arena.Resolve<char>(valueOffset), value.size() };
+		}
+
+		ArenaString* self = arena.Resolve<ArenaString>(selfOffset);
+		char* const data = arena.Resolve<char>(dataOffset);
+		std::memcpy(data, value.data(), value.size());
+		data[value.size()] = '\0';
+
+		self->m_data = data;
+		self->m_size = value.size();
+		return true;
+	}
+
+	template<typename Key, typename Value, typename Hash>
+	template<typename Lookup>
+	Value* ArenaHashMap<Key, Value, Hash>::Find(const Lookup& key)
+	{
+		const size_t slot = FindSlot(key);
+		if (slot == m_capacity || !m_slots[slot].occupied)
+		{
+			return nullptr;
+		}
+
+		return &m_slots[slot].value;
+	}
+
+	template<typename Key, typename Value, typename Hash>
+	template<typename Lookup>
+	const Value* ArenaHashMap<Key, Value, Hash>::Find(const Lookup& key) const
+	{
+		return const_cast<ArenaHashMap*>(this)->Find(key);
+	}
+
+	template<typename Key, typename Value, typename Hash>
+	template<typename Lookup>
+	bool ArenaHashMap<Key, Value, Hash>::Insert(MappedArena& arena, const Lookup& key, const Value& value)
+	{
+		ArenaHashMap* self = this;
+
+		// 'key' and 'value' might live inside the arena, which growing the map can re-map, so only copies of them are used from here on.
+		// The characters of an ArenaString key are not copied, if they are inside the arena they are resolved again from their offset
+		using KeyCopy = std::conditional_t<std::is_same_v<Key, ArenaString>, std::string_view, Key>;
+		KeyCopy keyCopy(key);
+		const Value valueCopy = value;
+
+		size_t keyOffset{};
+		if constexpr (std::is_same_v<Key, ArenaString>)
+		{
+			keyOffset = !keyCopy.empty() && arena.Contains(keyCopy.data()) ? arena.OffsetOf(keyCopy.data()) : 0;
+		}
+
+		// Keep the load factor below 75%
+		if ((m_size + 1) * 4 > m_capacity * 3)
+		{
+			self = Rehash(arena, std::max(MinimumCapacity, static_cast<size_t>(m_capacity * 2)));
+			if (!self)
+			{
+				return false;
+			}
+
+			if constexpr (std::is_same_v<Key, ArenaString>)
+			{
+				if (keyOffset != 0)
+				{
+					keyCopy = { arena.Resolve<char>(keyOffset), keyCopy.size() };
+				}
+			}
+		}
+
+		const size_t slotIndex = self->FindSlot(keyCopy);
+		Slot* slot = &self->m_slots[slotIndex];
+
+		if (slot->occupied)
+		{
+			slot->value = valueCopy;
+			return true;
+		}
+
+		if constexpr (std::is_same_v<Key, ArenaString>)
+		{
+			// Copying the key into the arena can re-map it, so resolve the map and the slot again afterwards
+			const size_t selfOffset = arena.OffsetOf(self);
+			const size_t slotOffset = arena.OffsetOf(slot);
+
+			if (!slot->key.Assign(arena, keyCopy))
+			{
+				return false;
+			}
+
+			self = arena.Resolve<ArenaHashMap>(selfOffset);
+			slot = arena.Resolve<Slot>(slotOffset);
+			new (&slot->value) Value(valueCopy);
+		}
+		else
+		{
+			new (&slot->key) Key(keyCopy);
+			new (&slot->value) Value(valueCopy);
+		}
+
+		slot->occupied = true;
+		++self->m_size;
+		return true;
+	}
+
+	template<typename Key, typename Value, typename Hash>
+	template<typename Func>
+	void ArenaHashMap<Key, Value, Hash>::ForEach(Func&& func) const
+	{
+		for (size_t i{}; i < m_capacity; ++i)
+		{
+			if (m_slots[i].occupied)
+			{
+				func(m_slots[i].key, m_slots[i].value);
+			}
+		}
+	}
+
+	template<typename Key, typename Value, typename Hash>
+	template<typename Lookup>
+	size_t ArenaHashMap<Key, Value, Hash>::FindSlot(const Lookup& key) const
+	{
+		if (m_capacity == 0)
+		{
+			return 0;
+		}
+
+		// Capacity is always a power of 2
+		const size_t mask = m_capacity - 1;
+		for (size_t slot = Hash{}(key) & mask;; slot = (slot + 1) & mask)
+		{
+			if (!m_slots[slot].occupied || m_slots[slot].key == key)
+			{
+				return slot;
+			}
+		}
+	}
+
+	template<typename Key, typename Value, typename Hash>
+	ArenaHashMap<Key, Value, Hash>* ArenaHashMap<Key, Value, Hash>::Rehash(MappedArena& arena, size_t capacity)
+	{
+		const size_t selfOffset = arena.OffsetOf(this);
+
+		const size_t slotsOffset = arena.Allocate(capacity * sizeof(Slot), alignof(Slot));
+		if (slotsOffset == 0)
+		{
+			return nullptr;
+		}
+
+		ArenaHashMap* self = arena.Resolve<ArenaHashMap>(selfOffset);
+		Slot* const oldSlots = self->m_slots.Get();
+		const size_t oldCapacity = self->m_capacity;
+
+		self->m_slots = arena.Resolve<Slot>(slotsOffset);
+		self->m_capacity = capacity;
+		std::memset(static_cast<void*>(self->m_slots.Get()), 0, capacity * sizeof(Slot));
+
+		for (size_t i{}; i < oldCapacity; ++i)
+		{
+			if (oldSlots[i].occupied)
+			{
+				// Copy-construct so OffsetPtrs inside keys and values are re-based to their new location
+				new (&self->m_slots[self->FindSlot(oldSlots[i].key)]) Slot(oldSlots[i]);
+			}
+		}
+
+		return self;
+	}
+} // namespace rapidio
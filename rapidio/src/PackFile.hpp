@@ -0,0 +1,618 @@
+#pragma once
+
+#include "rapidio.hpp"
+#include "PathUtils.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_set>
+#include <vector>
+
+namespace rapidio
+{
+	namespace detail
+	{
+		constexpr char PackMagic[8] = { 'R', 'I', 'O', 'P', 'A', 'C', 'K', '\0' };
+		constexpr uint32_t PackVersion = 1;
+
+		// Marks a slot of the name index that no entry hashes to
+		constexpr uint32_t EmptyPackSlot = std::numeric_limits<uint32_t>::max();
+
+		/// <summary>
+		/// Layout of a pack:
+		///   [entry data][entry table][slots][displacements][names][footer]
+		/// The data of every entry starts at a multiple of the alignment, the tables start at a multiple of 8 bytes and are stored back to back.
+		/// Names are found with a perfect hash: the hash of a name picks a bucket, the displacement of that bucket picks the slot of the name,
+		/// and the slot holds the index of its entry. No two names share a slot, so a lookup never probes more than one
+		/// </summary>
+		struct PackFooter
+		{
+			uint64_t entriesOffset;
+			uint64_t nrOfEntries;
+			uint64_t slotsOffset;
+			uint64_t nrOfSlots;
+			uint64_t displacementsOffset;
+			uint64_t nrOfBuckets;
+			uint64_t namesOffset;
+			uint64_t namesSize;
+			uint32_t alignment;
+			uint32_t version;
+			char magic[8];
+		};
+
+		struct PackTableEntry
+		{
+			uint64_t dataOffset;
+			uint64_t dataSize;
+			uint64_t nameOffset; // Relative to the start of the names
+			uint64_t nameSize;
+		};
+
+		uint64_t MixPackHash(uint64_t hash)
+		{
+			// splitmix64 finalizer
+			hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ull;
+			hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBull;
+			return hash ^ (hash >> 31);
+		}
+
+		uint64_t GetPackNameHash(std::string_view name)
+		{
+			// A CRC32C only has 32 bits, too few to tell tens of thousands of names apart. Names are short, so FNV-1a is fast enough
+			uint64_t hash = 0xCBF29CE484222325ull;
+			for (const char c : name)
+			{
+				hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001B3ull;
+			}
+
+			return MixPackHash(hash);
+		}
+
+		size_t GetPackBucket(uint64_t hash, size_t nrOfBuckets)
+		{
+			return static_cast<size_t>(((hash & 0xFFFFFFFF) * nrOfBuckets) >> 32);
+		}
+
+		size_t GetPackSlot(uint64_t hash, uint32_t displacement, size_t nrOfSlots)
+		{
+			return static_cast<size_t>(((MixPackHash(hash + displacement * 0x9E3779B97F4A7C15ull) >> 32) * nrOfSlots) >> 32);
+		}
+
+		/// <summary>
+		/// Finds a displacement for every bucket so that every hash ends up in a slot of its own. Buckets are placed largest first,
+		/// while most slots are still free, trying displacements until every hash of the bucket lands in a free slot
+		/// </summary>
+		/// <returns>Returns false if a bucket could not be placed, a table with more slots is then more likely to succeed</returns>
+		bool BuildPerfectHash(const std::vector<uint64_t>& hashes, size_t nrOfBuckets, size_t nrOfSlots, std::vector<uint32_t>& displacements,
+			std::vector<uint32_t>& slots)
+		{
+			constexpr uint32_t MaxDisplacement = 1 << 16;
+
+			std::vector<std::vector<uint32_t>> buckets(nrOfBuckets);
+			for (size_t i{}; i < hashes.size(); ++i)
+			{
+				buckets[GetPackBucket(hashes[i], nrOfBuckets)].push_back(static_cast<uint32_t>(i));
+			}
+
+			std::vector<size_t> order(nrOfBuckets);
+			for (size_t i{}; i < nrOfBuckets; ++i)
+			{
+				order[i] = i;
+			}
+
+			std::stable_sort(order.begin(), order.end(), [&buckets](size_t lhs, size_t rhs) { return buckets[lhs].size() > buckets[rhs].size(); });
+
+			displacements.assign(nrOfBuckets, 0);
+			slots.assign(nrOfSlots, EmptyPackSlot);
+
+			std::vector<size_t> bucketSlots;
+			for (const size_t bucket : order)
+			{
+				if (buckets[bucket].empty())
+				{
+					break;
+				}
+
+				bool isPlaced = false;
+				for (uint32_t displacement{}; displacement < MaxDisplacement && !isPlaced; ++displacement)
+				{
+					bucketSlots.clear();
+					isPlaced = true;
+
+					for (const uint32_t entry : buckets[bucket])
+					{
+						const size_t slot = GetPackSlot(hashes[entry], displacement, nrOfSlots);
+						if (slots[slot] != EmptyPackSlot || std::find(bucketSlots.begin(), bucketSlots.end(), slot) != bucketSlots.end())
+						{
+							isPlaced = false;
+							break;
+						}
+
+						bucketSlots.push_back(slot);
+					}
+
+					if (isPlaced)
+					{
+						displacements[bucket] = displacement;
+						for (size_t i{}; i < bucketSlots.size(); ++i)
+						{
+							slots[bucketSlots[i]] = buckets[bucket][i];
+						}
+					}
+				}
+
+				if (!isPlaced)
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+	} // namespace detail
+
+	/// <summary>
+	/// Writes many small files into a single pack, so they can be opened with one open and one mapping instead of one of each per file.
+	/// Entries are written back to back through a FileView, every one starting at a multiple of the alignment. 'Finish()' appends a name index
+	/// built on a perfect hash. A pack that was never finished is rejected by 'PackReader'
+	/// </summary>
+	class PackWriter final
+	{
+	public:
+		struct Options
+		{
+			// Every entry starts at a multiple of this many bytes, must be a power of two
+			size_t alignment = 64;
+		};
+
+		/// <summary>
+		/// Creates a writer for a new pack at 'filepath'. An existing file is overwritten
+		/// </summary>
+		/// <returns>std::nullopt if the file could not be created</returns>
+		static std::optional<PackWriter> Create(const std::filesystem::path& filepath);
+		static std::optional<PackWriter> Create(const std::filesystem::path& filepath, Options options);
+
+		/// <summary>
+		/// Appends an entry to the pack
+		/// </summary>
+		/// <returns>Returns false if the pack already has an entry called 'name', or the pack is already finished</returns>
+		bool Add(std::string_view name, std::string_view data);
+
+		/// <summary>
+		/// Appends the contents of the file at 'filepath' to the pack, see 'Add()'. The file is mapped rather than read
+		/// </summary>
+		/// <returns>Returns false if the file could not be opened, or the entry could not be added</returns>
+		bool AddFile(std::string_view name, const std::filesystem::path& filepath);
+
+		/// <summary>
+		/// Writes the entry table, the name index and the footer, after which the pack can be opened by 'PackReader'
+		/// </summary>
+		/// <returns>Returns true if the pack was written</returns>
+		bool Finish();
+
+		size_t GetNrOfEntries() const;
+
+	private:
+		// Small entries are gathered and written to the file in pieces of this size, so the view is not grown for every entry
+		static constexpr size_t WriteSize = 1024 * 1024 * 4; // 4 MB
+
+		PackWriter(FileView view, Options options);
+
+		bool WritePending();
+		void AlignPending(size_t alignment);
+
+		FileView m_view;
+		Options m_options;
+
+		std::string m_pending; // Data that has not been written to the view yet
+		size_t m_writtenSize = 0;
+
+		std::vector<detail::PackTableEntry> m_entries;
+		std::vector<uint64_t> m_hashes;
+		std::string m_names;
+		std::unordered_set<std::string> m_addedNames;
+		bool m_isFinished = false;
+	};
+
+	/// <summary>
+	/// A single entry of a pack. Both views point into the mapped pack
+	/// </summary>
+	struct PackEntry
+	{
+		std::string_view name;
+		std::string_view data;
+
+		bool operator==(const PackEntry&) const = default;
+	};
+
+	/// <summary>
+	/// Read-only view of a pack written by 'PackWriter'. Opening a pack maps it once and validates its tables, nothing is copied.
+	/// Finding an entry hashes its name, reads one displacement and one slot, and compares a single name, none of which allocates.
+	/// Names and data are handed out as std::string_views into the mapping, valid as long as the reader lives
+	/// </summary>
+	class PackReader final
+	{
+	public:
+		/// <summary>
+		/// Opens the pack at 'filepath'
+		/// </summary>
+		/// <returns>std::nullopt if the file could not be mapped or is not a finished pack</returns>
+		static std::optional<PackReader> Open(const std::filesystem::path& filepath);
+
+		/// <summary>
+		/// Returns the data of the entry called 'name', std::nullopt if the pack does not contain it
+		/// </summary>
+		std::optional<std::string_view> Get(std::string_view name) const;
+
+		bool Contains(std::string_view name) const;
+
+		// Returns the entry at 'index', in the order the entries were added. 'index' must be smaller than 'GetNrOfEntries()'
+		PackEntry GetEntry(size_t index) const;
+
+		size_t GetNrOfEntries() const;
+
+	private:
+		explicit PackReader(ReadOnlyFileView view);
+
+		bool Load();
+
+		detail::PackTableEntry GetTableEntry(size_t index) const;
+		uint32_t GetTableValue(const char* table, size_t index) const;
+
+		ReadOnlyFileView m_view;
+
+		const char* m_data = nullptr;
+		const char* m_entries = nullptr;
+		size_t m_nrOfEntries = 0;
+		const char* m_slots = nullptr;
+		size_t m_nrOfSlots = 0;
+		const char* m_displacements = nullptr;
+		size_t m_nrOfBuckets = 0;
+		const char* m_names = nullptr;
+	};
+
+	PackWriter::PackWriter(FileView view, Options options)
+		: m_view(std::move(view))
+		, m_options(options)
+	{
+	}
+
+	std::optional<PackWriter> PackWriter::Create(const std::filesystem::path& filepath)
+	{
+		return Create(filepath, Options{});
+	}
+
+	std::optional<PackWriter> PackWriter::Create(const std::filesystem::path& filepath, Options options)
+	{
+		if (options.alignment == 0 || (options.alignment & (options.alignment - 1)) != 0 || options.alignment > std::numeric_limits<uint32_t>::max())
+		{
+			std::cerr << "PackWriter::Create > Alignment must be a power of two\n";
+			return std::nullopt;
+		}
+
+		if (PathUtils::DoesFileExist(filepath))
+		{
+			std::filesystem::remove(filepath);
+		}
+
+		// The file grows with every piece that is written, it is never bigger than the data written so far
+		std::optional<FileView> view = FileView::CreateViewForNewFile(filepath, 1);
+		if (!view)
+		{
+			return std::nullopt;
+		}
+
+		return PackWriter{ std::move(*view), options };
+	}
+
+	bool PackWriter::Add(std::string_view name, std::string_view data)
+	{
+		if (m_isFinished)
+		{
+			std::cerr << "PackWriter::Add > Pack is already finished\n";
+			return false;
+		}
+
+		if (m_entries.size() == detail::EmptyPackSlot)
+		{
+			std::cerr << "PackWriter::Add > Pack cannot hold more entries\n";
+			return false;
+		}
+
+		if (!m_addedNames.emplace(name).second)
+		{
+			std::cerr << "PackWriter::Add > Pack already has an entry called " << name << "\n";
+			return false;
+		}
+
+		AlignPending(m_options.alignment);
+
+		const size_t offset = m_writtenSize + m_pending.size();
+		m_entries.push_back({ offset, data.size(), m_names.size(), name.size() });
+		m_hashes.push_back(detail::GetPackNameHash(name));
+		m_names += name;
+
+		// Large entries are written straight from 'data', rather than copied into the pending data first
+		if (data.size() >= WriteSize)
+		{
+			const ConstIoRange range{ offset, data.size(), data.data() };
+			if (!WritePending() || !m_view.WriteV({ &range, 1 }))
+			{
+				return false;
+			}
+
+			m_writtenSize += data.size();
+			return true;
+		}
+
+		m_pending += data;
+		return m_pending.size() < WriteSize || WritePending();
+	}
+
+	bool PackWriter::AddFile(std::string_view name, const std::filesystem::path& filepath)
+	{
+		std::error_code error;
+		const size_t fileSize = std::filesystem::file_size(filepath, error);
+		if (error)
+		{
+			std::cerr << "PackWriter::AddFile > Could not open " << filepath << "\n";
+			return false;
+		}
+
+		// An empty file cannot be mapped
+		if (fileSize == 0)
+		{
+			return Add(name, {});
+		}
+
+		const std::optional<ReadOnlyFileView> view = ReadOnlyFileView::CreateViewFromExistingFile(filepath, FileOpenMode::OpenExisting);
+		if (!view)
+		{
+			return false;
+		}
+
+		return Add(name, { view->GetData(), view->GetMappedSize() });
+	}
+
+	bool PackWriter::Finish()
+	{
+		if (m_isFinished)
+		{
+			return true;
+		}
+
+		detail::PackFooter footer{};
+		std::memcpy(footer.magic, detail::PackMagic, sizeof(footer.magic));
+		footer.version = detail::PackVersion;
+		footer.alignment = static_cast<uint32_t>(m_options.alignment);
+		footer.nrOfEntries = m_entries.size();
+
+		// Buckets of a few names are quick to place, and a table a quarter larger than the number of names leaves enough free slots.
+		// Should placing fail anyway, the table is grown and the index built again
+		const size_t nrOfBuckets = std::max<size_t>(1, (m_entries.size() + 3) / 4);
+		size_t nrOfSlots = std::max<size_t>(1, m_entries.size() + m_entries.size() / 4);
+
+		std::vector<uint32_t> displacements;
+		std::vector<uint32_t> slots;
+		while (!detail::BuildPerfectHash(m_hashes, nrOfBuckets, nrOfSlots, displacements, slots))
+		{
+			if (nrOfSlots > m_entries.size() * 4)
+			{
+				// Only names with the same 64-bit hash can not be placed in a table this sparse
+				std::cerr << "PackWriter::Finish > Could not build the name index\n";
+				return false;
+			}
+
+			nrOfSlots += nrOfSlots / 2;
+		}
+
+		AlignPending(sizeof(uint64_t));
+
+		footer.entriesOffset = m_writtenSize + m_pending.size();
+		m_pending.append(reinterpret_cast<const char*>(m_entries.data()), m_entries.size() * sizeof(detail::PackTableEntry));
+
+		footer.slotsOffset = m_writtenSize + m_pending.size();
+		footer.nrOfSlots = slots.size();
+		m_pending.append(reinterpret_cast<const char*>(slots.data()), slots.size() * sizeof(uint32_t));
+
+		footer.displacementsOffset = m_writtenSize + m_pending.size();
+		footer.nrOfBuckets = displacements.size();
+		m_pending.append(reinterpret_cast<const char*>(displacements.data()), displacements.size() * sizeof(uint32_t));
+
+		footer.namesOffset = m_writtenSize + m_pending.size();
+		footer.namesSize = m_names.size();
+		m_pending += m_names;
+
+		m_pending.append(reinterpret_cast<const char*>(&footer), sizeof(footer));
+
+		if (!WritePending() || !m_view.Flush())
+		{
+			std::cerr << "PackWriter::Finish > Could not write the pack\n";
+			return false;
+		}
+
+		m_isFinished = true;
+		return true;
+	}
+
+	size_t PackWriter::GetNrOfEntries() const
+	{
+		return m_entries.size();
+	}
+
+	bool PackWriter::WritePending()
+	{
+		if (m_pending.empty())
+		{
+			return true;
+		}
+
+		if (!m_view.Write(m_pending, m_writtenSize))
+		{
+			return false;
+		}
+
+		m_writtenSize += m_pending.size();
+		m_pending.clear();
+		return true;
+	}
+
+	void PackWriter::AlignPending(size_t alignment)
+	{
+		const size_t offset = m_writtenSize + m_pending.size();
+		m_pending.append((alignment - offset % alignment) % alignment, '\0');
+	}
+
+	PackReader::PackReader(ReadOnlyFileView view)
+		: m_view(std::move(view))
+	{
+	}
+
+	std::optional<PackReader> PackReader::Open(const std::filesystem::path& filepath)
+	{
+		std::optional<ReadOnlyFileView> view = ReadOnlyFileView::CreateViewFromExistingFile(filepath, FileOpenMode::OpenExisting);
+		if (!view)
+		{
+			return std::nullopt;
+		}
+
+		PackReader reader{ std::move(*view) };
+		if (!reader.Load())
+		{
+			std::cerr << "PackReader::Open > " << filepath << " is not a pack\n";
+			return std::nullopt;
+		}
+
+		return reader;
+	}
+
+	bool PackReader::Load()
+	{
+		const size_t fileSize = m_view.GetMappedSize();
+		if (fileSize < sizeof(detail::PackFooter))
+		{
+			return false;
+		}
+
+		m_data = m_view.GetData();
+
+		detail::PackFooter footer;
+		std::memcpy(&footer, m_data + fileSize - sizeof(footer), sizeof(footer));
+
+		if (std::memcmp(footer.magic, detail::PackMagic, sizeof(footer.magic)) != 0 || footer.version != detail::PackVersion)
+		{
+			return false;
+		}
+
+		if (footer.nrOfEntries >= detail::EmptyPackSlot || footer.nrOfSlots == 0 || footer.nrOfBuckets == 0 ||
+			footer.nrOfSlots > detail::EmptyPackSlot || footer.nrOfBuckets > detail::EmptyPackSlot)
+		{
+			return false;
+		}
+
+		// The tables are stored back to back, right in front of the footer. They are checked from the footer backwards by subtracting, so a
+		// corrupt offset or size can not wrap around and point outside of the mapping
+		const uint64_t tablesEnd = fileSize - sizeof(footer);
+		if (footer.namesSize > tablesEnd || footer.namesOffset != tablesEnd - footer.namesSize ||
+			footer.nrOfBuckets > footer.namesOffset / sizeof(uint32_t) ||
+			footer.displacementsOffset != footer.namesOffset - footer.nrOfBuckets * sizeof(uint32_t) ||
+			footer.nrOfSlots > footer.displacementsOffset / sizeof(uint32_t) ||
+			footer.slotsOffset != footer.displacementsOffset - footer.nrOfSlots * sizeof(uint32_t) ||
+			footer.nrOfEntries > footer.slotsOffset / sizeof(detail::PackTableEntry) ||
+			footer.entriesOffset != footer.slotsOffset - footer.nrOfEntries * sizeof(detail::PackTableEntry))
+		{
+			return false;
+		}
+
+		// Checking every entry once means lookups do not have to
+		const uint64_t dataSize = footer.entriesOffset;
+
+		m_entries = m_data + footer.entriesOffset;
+		m_nrOfEntries = static_cast<size_t>(footer.nrOfEntries);
+		m_slots = m_data + footer.slotsOffset;
+		m_nrOfSlots = static_cast<size_t>(footer.nrOfSlots);
+		m_displacements = m_data + footer.displacementsOffset;
+		m_nrOfBuckets = static_cast<size_t>(footer.nrOfBuckets);
+		m_names = m_data + footer.namesOffset;
+
+		for (size_t i{}; i < m_nrOfEntries; ++i)
+		{
+			const detail::PackTableEntry entry = GetTableEntry(i);
+			if (entry.dataOffset > dataSize || entry.dataSize > dataSize - entry.dataOffset ||
+				entry.nameOffset > footer.namesSize || entry.nameSize > footer.namesSize - entry.nameOffset)
+			{
+				return false;
+			}
+		}
+
+		for (size_t i{}; i < m_nrOfSlots; ++i)
+		{
+			const uint32_t index = GetTableValue(m_slots, i);
+			if (index != detail::EmptyPackSlot && index >= m_nrOfEntries)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	std::optional<std::string_view> PackReader::Get(std::string_view name) const
+	{
+		const uint64_t hash = detail::GetPackNameHash(name);
+		const uint32_t displacement = GetTableValue(m_displacements, detail::GetPackBucket(hash, m_nrOfBuckets));
+		const uint32_t index = GetTableValue(m_slots, detail::GetPackSlot(hash, displacement, m_nrOfSlots));
+
+		if (index == detail::EmptyPackSlot)
+		{
+			return std::nullopt;
+		}
+
+		// Names that are not in the pack still map to a slot, which can belong to any other name
+		const PackEntry entry = GetEntry(index);
+		if (entry.name != name)
+		{
+			return std::nullopt;
+		}
+
+		return entry.data;
+	}
+
+	bool PackReader::Contains(std::string_view name) const
+	{
+		return Get(name).has_value();
+	}
+
+	PackEntry PackReader::GetEntry(size_t index) const
+	{
+		const detail::PackTableEntry entry = GetTableEntry(index);
+		return { { m_names + entry.nameOffset, static_cast<size_t>(entry.nameSize) }, { m_data + entry.dataOffset, static_cast<size_t>(entry.dataSize) } };
+	}
+
+	size_t PackReader::GetNrOfEntries() const
+	{
+		return m_nrOfEntries;
+	}
+
+	detail::PackTableEntry PackReader::GetTableEntry(size_t index) const
+	{
+		detail::PackTableEntry entry;
+		std::memcpy(&entry, m_entries + index * sizeof(entry), sizeof(entry));
+		return entry;
+	}
+
+	uint32_t PackReader::GetTableValue(const char* table, size_t index) const
+	{
+		uint32_t value;
+		std::memcpy(&value, table + index * sizeof(value), sizeof(value));
+		return value;
+	}
+} // namespace rapidio
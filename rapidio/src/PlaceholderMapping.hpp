@@ -0,0 +1,345 @@
+#pragma once
+#ifdef _WIN32
+
+#include "Win32Call.hpp"
+#include "Win32Handle.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+// Placeholder flags are missing from Windows SDKs older than 10.0.17134
+#ifndef MEM_COALESCE_PLACEHOLDERS
+#	define MEM_COALESCE_PLACEHOLDERS 0x00000001
+#endif
+#ifndef MEM_PRESERVE_PLACEHOLDER
+#	define MEM_PRESERVE_PLACEHOLDER 0x00000002
+#endif
+#ifndef MEM_REPLACE_PLACEHOLDER
+#	define MEM_REPLACE_PLACEHOLDER 0x00004000
+#endif
+#ifndef MEM_RESERVE_PLACEHOLDER
+#	define MEM_RESERVE_PLACEHOLDER 0x00040000
+#endif
+
+namespace rapidio
+{
+	namespace detail
+	{
+		using VirtualAlloc2Func = void* (WINAPI*)(HANDLE, void*, SIZE_T, ULONG, ULONG, void*, ULONG);
+		using MapViewOfFile3Func = void* (WINAPI*)(HANDLE, HANDLE, void*, ULONG64, SIZE_T, ULONG, ULONG, void*, ULONG);
+
+		struct PlaceholderApi
+		{
+			VirtualAlloc2Func virtualAlloc2 = nullptr;
+			MapViewOfFile3Func mapViewOfFile3 = nullptr;
+		};
+
+		// The placeholder APIs only exist since Windows 10 1803, so they are looked up at runtime instead of linking against onecore.lib
+		const PlaceholderApi& GetPlaceholderApi()
+		{
+			static const PlaceholderApi Api = []()
+			{
+				PlaceholderApi api;
+
+				if (HMODULE kernelBase = GetModuleHandleA("kernelbase.dll"))
+				{
+					api.virtualAlloc2 = reinterpret_cast<VirtualAlloc2Func>(GetProcAddress(kernelBase, "VirtualAlloc2"));
+					api.mapViewOfFile3 = reinterpret_cast<MapViewOfFile3Func>(GetProcAddress(kernelBase, "MapViewOfFile3"));
+				}
+
+				return api;
+			}();
+
+			return Api;
+		}
+	} // namespace detail
+
+	inline namespace Win32Utils
+	{
+		/// <summary>
+		/// A range of address space reserved up front as a placeholder, into which a file is mapped piece by piece.
+		/// Every extension maps a view of only the new bytes right behind the previous views, so the base address never changes
+		/// and growing costs as much as mapping the new bytes, regardless of the size of the file
+		/// </summary>
+		class PlaceholderMapping final
+		{
+		public:
+			PlaceholderMapping() = default;
+			~PlaceholderMapping();
+
+			PlaceholderMapping(const PlaceholderMapping&) = delete;
+			PlaceholderMapping(PlaceholderMapping&& other) noexcept;
+			PlaceholderMapping& operator=(const PlaceholderMapping&) = delete;
+			PlaceholderMapping& operator=(PlaceholderMapping&& other) noexcept;
+
+			// Returns true if the system supports placeholders
+			static bool IsSupported();
+
+			/// <summary>
+			/// Reserves 'size' bytes of address space for the file behind 'fileHandle', without mapping anything yet.
+			/// The file handle is not owned and has to outlive the mapping
+			/// </summary>
+			/// <param name="fileHandle">Handle to a file opened with read and write access</param>
+			/// <param name="fileSize">Current size of the file</param>
+			/// <param name="size">Number of bytes to reserve, rounded up to the allocation granularity</param>
+			/// <returns>Returns true if the address space was reserved</returns>
+			bool Reserve(void* fileHandle, size_t fileSize, size_t size);
+
+			/// <summary>
+			/// Makes sure the first 'newEnd' bytes of the file are mapped, growing the file if required. Views are mapped in whole allocation
+			/// granularity units, so the file on disk is padded until the mapping is released
+			/// </summary>
+			/// <returns>Returns false if 'newEnd' does not fit in the reservation, or the view could not be mapped</returns>
+			bool Extend(size_t newEnd);
+
+			/// <summary>
+			/// Unmaps every view and frees the reservation
+			/// </summary>
+			/// <param name="trimFile">If set to true, the padding added by 'Extend()' is cut off the file again</param>
+			void Release(bool trimFile = true);
+
+			bool IsReserved() const;
+			char* GetBase() const;
+			size_t GetReservedSize() const;
+
+			/// <summary>
+			/// Calls 'func(data, size)' for the part of every view overlapping 'size' bytes at 'offset', for APIs that cannot cross views
+			/// </summary>
+			/// <returns>Returns false as soon as 'func' returns false</returns>
+			template<typename Func>
+			bool ForEachView(size_t offset, size_t size, Func&& func) const;
+
+		private:
+			struct View
+			{
+				Win32Handle section;
+				Win32MappedView data;
+				size_t offset;
+				size_t size;
+			};
+
+			void* m_fileHandle = nullptr;
+			size_t m_fileSize = 0; // Size of the file without the padding of the last view
+			char* m_base = nullptr;
+			size_t m_reservedSize = 0;
+			size_t m_mappedSize = 0;
+			size_t m_allocationGranularity = 0;
+			std::vector<View> m_views;
+		};
+
+		PlaceholderMapping::~PlaceholderMapping()
+		{
+			Release();
+		}
+
+		PlaceholderMapping::PlaceholderMapping(PlaceholderMapping&& other) noexcept
+			: m_fileHandle{ std::exchange(other.m_fileHandle, nullptr) }
+			, m_fileSize{ std::exchange(other.m_fileSize, 0) }
+			, m_base{ std::exchange(other.m_base, nullptr) }
+			, m_reservedSize{ std::exchange(other.m_reservedSize, 0) }
+			, m_mappedSize{ std::exchange(other.m_mappedSize, 0) }
+			, m_allocationGranularity{ other.m_allocationGranularity }
+			, m_views{ std::move(other.m_views) }
+		{
+			other.m_views.clear();
+		}
+
+		PlaceholderMapping& PlaceholderMapping::operator=(PlaceholderMapping&& other) noexcept
+		{
+			if (this != &other)
+			{
+				Release();
+
+				m_fileHandle = std::exchange(other.m_fileHandle, nullptr);
+				m_fileSize = std::exchange(other.m_fileSize, 0);
+				m_base = std::exchange(other.m_base, nullptr);
+				m_reservedSize = std::exchange(other.m_reservedSize, 0);
+				m_mappedSize = std::exchange(other.m_mappedSize, 0);
+				m_allocationGranularity = other.m_allocationGranularity;
+				m_views = std::move(other.m_views);
+				other.m_views.clear();
+			}
+
+			return *this;
+		}
+
+		bool PlaceholderMapping::IsSupported()
+		{
+			const detail::PlaceholderApi& api = detail::GetPlaceholderApi();
+			return api.virtualAlloc2 != nullptr && api.mapViewOfFile3 != nullptr;
+		}
+
+		bool PlaceholderMapping::Reserve(void* fileHandle, size_t fileSize, size_t size)
+		{
+			if (!IsSupported())
+			{
+				std::cerr << "PlaceholderMapping::Reserve > Placeholders require Windows 10 version 1803 or later\n";
+				return false;
+			}
+
+			Release();
+
+			SYSTEM_INFO systemInfo;
+			CALL_WIN32(GetNativeSystemInfo(&systemInfo));
+			m_allocationGranularity = systemInfo.dwAllocationGranularity;
+
+			size = std::max<size_t>(size, 1);
+			size = (size + m_allocationGranularity - 1) / m_allocationGranularity * m_allocationGranularity;
+
+			void* const base = detail::GetPlaceholderApi().virtualAlloc2(GetCurrentProcess(), nullptr, size, MEM_RESERVE | MEM_RESERVE_PLACEHOLDER,
+				PAGE_NOACCESS, nullptr, 0);
+
+			if (base == nullptr)
+			{
+				std::cerr << "PlaceholderMapping::Reserve > Could not reserve " << size << " bytes of address space\n";
+				SetLastError(ERROR_SUCCESS);
+				return false;
+			}
+
+			m_fileHandle = fileHandle;
+			m_fileSize = fileSize;
+			m_base = static_cast<char*>(base);
+			m_reservedSize = size;
+			m_mappedSize = 0;
+			return true;
+		}
+
+		bool PlaceholderMapping::Extend(size_t newEnd)
+		{
+			if (newEnd <= m_mappedSize)
+			{
+				m_fileSize = std::max(m_fileSize, newEnd);
+				return true;
+			}
+
+			if (newEnd > m_reservedSize)
+			{
+				std::cerr << "PlaceholderMapping::Extend > " << newEnd << " bytes do not fit in the reserved address space\n";
+				return false;
+			}
+
+			// Map at least an eighth of what is already mapped, so a file growing in small steps does not end up as thousands of views
+			const size_t minimumEnd = std::max(newEnd, m_mappedSize + m_mappedSize / 8);
+			const size_t viewEnd = std::min(m_reservedSize, (minimumEnd + m_allocationGranularity - 1) / m_allocationGranularity * m_allocationGranularity);
+			const size_t viewSize = viewEnd - m_mappedSize;
+
+			// A section can not grow, so every view gets a section of its own. Creating it grows the file to 'viewEnd'
+			Win32Handle section{ CALL_WIN32_RV
+			(
+				CreateFileMappingA
+				(
+					m_fileHandle,
+					nullptr,
+					PAGE_READWRITE,
+					static_cast<DWORD>(static_cast<uint64_t>(viewEnd) >> 32),
+					static_cast<DWORD>(viewEnd),
+					nullptr
+				)
+			) };
+
+			if (!section.IsValid())
+			{
+				std::cerr << "PlaceholderMapping::Extend > Could not grow the file to " << viewEnd << " bytes\n";
+				return false;
+			}
+
+			// Split the view's part off the placeholder, unless the view takes up everything that is left of it
+			char* const viewData = m_base + m_mappedSize;
+			if (viewEnd < m_reservedSize && CALL_WIN32_RV(VirtualFree(viewData, viewSize, MEM_RELEASE | MEM_PRESERVE_PLACEHOLDER)) == 0)
+			{
+				return false;
+			}
+
+			void* const data = detail::GetPlaceholderApi().mapViewOfFile3(section.Get(), GetCurrentProcess(), viewData, m_mappedSize, viewSize,
+				MEM_REPLACE_PLACEHOLDER, PAGE_READWRITE, nullptr, 0);
+
+			if (data == nullptr)
+			{
+				std::cerr << "PlaceholderMapping::Extend > Could not map " << viewSize << " bytes at offset " << m_mappedSize << "\n";
+				SetLastError(ERROR_SUCCESS);
+
+				// Merge the split off placeholder back, so the reservation stays a single placeholder past the mapped views
+				if (viewEnd < m_reservedSize)
+				{
+					CALL_WIN32(VirtualFree(viewData, m_reservedSize - m_mappedSize, MEM_RELEASE | MEM_COALESCE_PLACEHOLDERS));
+				}
+
+				return false;
+			}
+
+			m_views.push_back({ std::move(section), Win32MappedView{ data }, m_mappedSize, viewSize });
+			m_mappedSize = viewEnd;
+			m_fileSize = std::max(m_fileSize, newEnd);
+			return true;
+		}
+
+		void PlaceholderMapping::Release(bool trimFile /* = true */)
+		{
+			if (m_base == nullptr)
+			{
+				return;
+			}
+
+			m_views.clear();
+
+			if (m_mappedSize < m_reservedSize)
+			{
+				CALL_WIN32(VirtualFree(m_base + m_mappedSize, 0, MEM_RELEASE));
+			}
+
+			// Once no view is left, the file can be cut back to the size it would have without the padding of the last view
+			if (trimFile && m_fileSize < m_mappedSize)
+			{
+				LARGE_INTEGER size{};
+				size.QuadPart = static_cast<LONGLONG>(m_fileSize);
+
+				if (CALL_WIN32_RV(SetFilePointerEx(m_fileHandle, size, nullptr, FILE_BEGIN)) == 0 || CALL_WIN32_RV(SetEndOfFile(m_fileHandle)) == 0)
+				{
+					std::cerr << "PlaceholderMapping::Release > Could not trim the file back to " << m_fileSize << " bytes\n";
+				}
+			}
+
+			m_fileHandle = nullptr;
+			m_fileSize = 0;
+			m_base = nullptr;
+			m_reservedSize = 0;
+			m_mappedSize = 0;
+		}
+
+		bool PlaceholderMapping::IsReserved() const
+		{
+			return m_base != nullptr;
+		}
+
+		char* PlaceholderMapping::GetBase() const
+		{
+			return m_base;
+		}
+
+		size_t PlaceholderMapping::GetReservedSize() const
+		{
+			return m_reservedSize;
+		}
+
+		template<typename Func>
+		bool PlaceholderMapping::ForEachView(size_t offset, size_t size, Func&& func) const
+		{
+			for (const View& view : m_views)
+			{
+				const size_t begin = std::max(offset, view.offset);
+				const size_t end = std::min(offset + size, view.offset + view.size);
+
+				if (begin < end && !func(m_base + begin, end - begin))
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+	} // inline namespace Win32Utils
+} // namespace rapidio
+
+#endif // _WIN32
@@ -0,0 +1,164 @@
+#pragma once
+
+#include "CopyUtils.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+
+namespace rapidio
+{
+	namespace detail
+	{
+		void MatchBytesScalar(const char* block, std::span<const char> bytes, uint64_t* masks)
+		{
+			for (size_t b{}; b < bytes.size(); ++b)
+			{
+				uint64_t mask{};
+				for (size_t i{}; i < 64; ++i)
+				{
+					mask |= static_cast<uint64_t>(block[i] == bytes[b]) << i;
+				}
+
+				masks[b] = mask;
+			}
+		}
+
+		#ifdef RAPIDIO_X86
+		RAPIDIO_TARGET("sse2")
+		void MatchBytesSSE2(const char* block, std::span<const char> bytes, uint64_t* masks)
+		{
+			const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block));
+			const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16));
+			const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 32));
+			const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 48));
+
+			for (size_t i{}; i < bytes.size(); ++i)
+			{
+				const __m128i needle = _mm_set1_epi8(bytes[i]);
+				masks[i] = static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(a, needle)))) |
+					static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(b, needle)))) << 16 |
+					static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(c, needle)))) << 32 |
+					static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(d, needle)))) << 48;
+			}
+		}
+
+		RAPIDIO_TARGET("avx2")
+		void MatchBytesAVX2(const char* block, std::span<const char> bytes, uint64_t* masks)
+		{
+			const __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+			const __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32));
+
+			for (size_t i{}; i < bytes.size(); ++i)
+			{
+				const __m256i needle = _mm256_set1_epi8(bytes[i]);
+				masks[i] = static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(low, needle)))) |
+					static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(high, needle)))) << 32;
+			}
+		}
+		#endif // RAPIDIO_X86
+	} // namespace detail
+
+	inline namespace ScanUtils
+	{
+		// Number of bytes classified by a single 'MatchBytes()' call, one bit per byte
+		constexpr size_t ScanBlockSize = 64;
+
+		/// <summary>
+		/// For every byte in 'bytes', sets 'masks[i]' to a mask with bit j set if 'block[j] == bytes[i]'. 'block' must have 64 readable bytes.
+		/// The block is loaded once for all bytes, so classifying several bytes at once is cheaper than separate calls
+		/// </summary>
+		void MatchBytes(const char* block, std::span<const char> bytes, uint64_t* masks)
+		{
+			#ifdef RAPIDIO_X86
+			// AVX2 is detected through the copy-kernel CPUID probe
+			static const bool HasAVX2 = IsCopyKernelSupported(CopyKernel::AVX2);
+
+			if (HasAVX2)
+			{
+				detail::MatchBytesAVX2(block, bytes, masks);
+			}
+			else
+			{
+				detail::MatchBytesSSE2(block, bytes, masks);
+			}
+			#else
+			detail::MatchBytesScalar(block, bytes, masks);
+			#endif // RAPIDIO_X86
+		}
+
+		/// <summary>
+		/// Like 'MatchBytes()', but for blocks of less than 64 bytes. Bits past 'size' are never set
+		/// </summary>
+		void MatchBytesPartial(const char* block, size_t size, std::span<const char> bytes, uint64_t* masks)
+		{
+			char padded[ScanBlockSize]{};
+			std::memcpy(padded, block, std::min(size, ScanBlockSize));
+			MatchBytes(padded, bytes, masks);
+
+			const uint64_t valid = size >= ScanBlockSize ? ~uint64_t{ 0 } : (uint64_t{ 1 } << size) - 1;
+			for (size_t i{}; i < bytes.size(); ++i)
+			{
+				masks[i] &= valid;
+			}
+		}
+
+		/// <summary>
+		/// Returns a mask where bit i is the XOR of bits 0..i of 'mask'. Applied to a mask of quote characters, this yields the bytes inside quotes
+		/// </summary>
+		constexpr uint64_t PrefixXor(uint64_t mask)
+		{
+			mask ^= mask << 1;
+			mask ^= mask << 2;
+			mask ^= mask << 4;
+			mask ^= mask << 8;
+			mask ^= mask << 16;
+			mask ^= mask << 32;
+			return mask;
+		}
+
+		/// <summary>
+		/// Returns the offset of the first occurrence of 'pattern' in 'haystack', or std::string_view::npos.
+		/// Candidates are filtered 64 positions at a time by comparing both the first and the last byte of the pattern, only those are compared in full
+		/// </summary>
+		size_t FindPattern(std::string_view haystack, std::string_view pattern)
+		{
+			if (pattern.empty())
+			{
+				return 0;
+			}
+
+			if (pattern.size() > haystack.size())
+			{
+				return std::string_view::npos;
+			}
+
+			const char firstByte[]{ pattern.front() };
+			const char lastByte[]{ pattern.back() };
+			const size_t lastOffset = pattern.size() - 1;
+			size_t position{};
+
+			for (; position + lastOffset + ScanBlockSize <= haystack.size(); position += ScanBlockSize)
+			{
+				uint64_t firstMask, lastMask;
+				MatchBytes(haystack.data() + position, firstByte, &firstMask);
+				MatchBytes(haystack.data() + position + lastOffset, lastByte, &lastMask);
+
+				for (uint64_t candidates = firstMask & lastMask; candidates != 0; candidates &= candidates - 1)
+				{
+					const size_t candidate = position + std::countr_zero(candidates);
+					if (std::memcmp(haystack.data() + candidate, pattern.data(), pattern.size()) == 0)
+					{
+						return candidate;
+					}
+				}
+			}
+
+			const size_t tail = haystack.substr(position).find(pattern);
+			return tail == std::string_view::npos ? tail : position + tail;
+		}
+	} // inline namespace ScanUtils
+} // namespace rapidio
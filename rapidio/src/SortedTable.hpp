@@ -0,0 +1,637 @@
+#pragma once
+
+#include "rapidio.hpp"
+#include "ChecksumUtils.hpp"
+#include "PathUtils.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace rapidio
+{
+	namespace detail
+	{
+		constexpr char SortedTableMagic[8] = { 'R', 'I', 'O', 'T', 'A', 'B', 'L', 'E' };
+		constexpr uint32_t SortedTableVersion = 1;
+
+		// Every block of the bloom filter is a single cache line, so probing the filter costs one cache miss
+		constexpr size_t BloomBlockSize = 64;
+		constexpr size_t BloomBlockBits = BloomBlockSize * 8;
+
+		/// <summary>
+		/// Layout of a sorted table:
+		///   [entries][index entries][index keys][bloom filter][footer]
+		/// Every entry is a uint32_t key size, a uint32_t value size, the key and the value. Entries are sorted by key and stored back to back.
+		/// The index has an entry for the first key of every data block, the footer is always the last bytes of the file
+		/// </summary>
+		struct SortedTableFooter
+		{
+			uint64_t indexOffset;
+			uint64_t nrOfBlocks;
+			uint64_t bloomOffset;
+			uint64_t nrOfBloomBlocks;
+			uint64_t nrOfEntries;
+			uint32_t nrOfBloomProbes;
+			uint32_t version;
+			char magic[8];
+		};
+
+		struct SortedTableIndexEntry
+		{
+			uint64_t blockOffset;
+			uint64_t keyOffset; // Relative to the start of the index keys
+			uint64_t keySize;
+		};
+
+		// Size of the key and value size in front of every entry
+		constexpr size_t SortedTableEntryHeaderSize = sizeof(uint32_t) * 2;
+
+		uint64_t GetBloomHash(std::string_view key)
+		{
+			// CRC32C is hardware accelerated, the splitmix64 finalizer spreads its bits over the 64 that are needed to pick a block and the probes
+			uint64_t hash = Crc32c(key.data(), key.size()) + 0x9E3779B97F4A7C15ull;
+			hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ull;
+			hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBull;
+			return hash ^ (hash >> 31);
+		}
+
+		/// <summary>
+		/// Calls 'func(bit)' for every bit of the filter that belongs to 'hash', all of them inside the same block. Stops as soon as 'func' returns false
+		/// </summary>
+		/// <returns>Returns false if 'func' returned false</returns>
+		template<typename Func>
+		bool ForEachBloomBit(uint64_t hash, uint64_t nrOfBlocks, uint32_t nrOfProbes, Func&& func)
+		{
+			const uint64_t firstBit = ((hash >> 32) * nrOfBlocks >> 32) * BloomBlockBits;
+
+			// Double hashing, the probes are derived from a single hash
+			uint32_t probe = static_cast<uint32_t>(hash);
+			const uint32_t delta = (probe >> 17) | (probe << 15);
+
+			for (uint32_t i{}; i < nrOfProbes; ++i)
+			{
+				if (!func(firstBit + probe % BloomBlockBits))
+				{
+					return false;
+				}
+
+				probe += delta;
+			}
+
+			return true;
+		}
+	} // namespace detail
+
+	/// <summary>
+	/// Writes an immutable sorted table: key/value entries in ascending key order, a sparse index of the first key of every data block and a bloom filter
+	/// over every key. Entries are written through a FileView in large pieces, the index and the filter are appended by 'Finish()'.
+	/// A table that was never finished is rejected by 'SortedTableReader'
+	/// </summary>
+	class SortedTableWriter final
+	{
+	public:
+		struct Options
+		{
+			// A new data block, and so a new index entry, is started once the current block has grown past this size
+			size_t blockSize = 1024 * 4;
+
+			// Bits of bloom filter per key. 10 bits gives about 1% false positives, 0 disables the filter
+			size_t bloomBitsPerKey = 10;
+		};
+
+		/// <summary>
+		/// Creates a writer for a new sorted table at 'filepath'. An existing file is overwritten
+		/// </summary>
+		/// <returns>std::nullopt if the file could not be created</returns>
+		static std::optional<SortedTableWriter> Create(const std::filesystem::path& filepath);
+		static std::optional<SortedTableWriter> Create(const std::filesystem::path& filepath, Options options);
+
+		/// <summary>
+		/// Appends an entry to the table. Keys are compared bytewise and must be added in strictly ascending order
+		/// </summary>
+		/// <returns>Returns false if the key is out of order, or the table is already finished</returns>
+		bool Add(std::string_view key, std::string_view value);
+
+		/// <summary>
+		/// Writes the index, the bloom filter and the footer, after which the table can be opened by 'SortedTableReader'
+		/// </summary>
+		/// <returns>Returns true if the table was written</returns>
+		bool Finish();
+
+		size_t GetNrOfEntries() const;
+
+	private:
+		// Entries are written to the file in pieces of this size, so the view is not grown for every entry
+		static constexpr size_t WriteSize = 1024 * 1024 * 4; // 4 MB
+
+		SortedTableWriter(FileView view, Options options);
+
+		bool WritePending();
+
+		FileView m_view;
+		Options m_options;
+
+		std::string m_pending; // Data that has not been written to the view yet
+		size_t m_writtenSize = 0;
+		size_t m_blockStart = 0;
+		std::string m_lastKey;
+
+		std::vector<detail::SortedTableIndexEntry> m_index;
+		std::string m_indexKeys;
+		std::vector<uint64_t> m_hashes;
+		bool m_isFinished = false;
+	};
+
+	/// <summary>
+	/// A single entry of a sorted table. Both views point into the mapped table
+	/// </summary>
+	struct SortedTableEntry
+	{
+		std::string_view key;
+		std::string_view value;
+
+		bool operator==(const SortedTableEntry&) const = default;
+	};
+
+	/// <summary>
+	/// Forward iterator over the entries of a sorted table in key order. Entries are stored back to back, so iterating never consults the index
+	/// </summary>
+	class SortedTableIterator final
+	{
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = SortedTableEntry;
+		using difference_type = std::ptrdiff_t;
+
+		SortedTableIterator() = default;
+
+		SortedTableEntry operator*() const;
+		SortedTableIterator& operator++();
+		SortedTableIterator operator++(int);
+
+		bool operator==(const SortedTableIterator& other) const;
+
+	private:
+		friend class SortedTableReader;
+
+		explicit SortedTableIterator(const char* position);
+
+		const char* m_position = nullptr;
+	};
+
+	/// <summary>
+	/// Read-only view of a table written by 'SortedTableWriter'. Opening a table only maps it and checks its footer, nothing is loaded.
+	/// A lookup probes a single cache line of the bloom filter, binary searches the first keys of the data blocks and scans one block,
+	/// none of which allocates. Keys and values are handed out as std::string_views into the mapping, valid as long as the reader lives
+	/// </summary>
+	class SortedTableReader final
+	{
+	public:
+		using Iterator = SortedTableIterator;
+
+		/// <summary>
+		/// Opens the sorted table at 'filepath'
+		/// </summary>
+		/// <returns>std::nullopt if the file could not be mapped or is not a finished sorted table</returns>
+		static std::optional<SortedTableReader> Open(const std::filesystem::path& filepath);
+
+		/// <summary>
+		/// Returns the value of 'key', std::nullopt if the table does not contain it
+		/// </summary>
+		std::optional<std::string_view> Get(std::string_view key) const;
+
+		/// <summary>
+		/// Probes the bloom filter. Returns false only if the table certainly does not contain 'key'
+		/// </summary>
+		bool MayContain(std::string_view key) const;
+
+		// Returns the first entry whose key is not less than 'key'
+		Iterator LowerBound(std::string_view key) const;
+
+		/// <summary>
+		/// Returns every entry with a key in [from, to)
+		/// </summary>
+		std::ranges::subrange<Iterator> Range(std::string_view from, std::string_view to) const;
+
+		/// <summary>
+		/// Returns every entry whose key starts with 'prefix'
+		/// </summary>
+		std::ranges::subrange<Iterator> Prefix(std::string_view prefix) const;
+
+		Iterator begin() const;
+		Iterator end() const;
+
+		size_t GetNrOfEntries() const;
+
+	private:
+		explicit SortedTableReader(ReadOnlyFileView view);
+
+		bool Load();
+
+		/// <summary>
+		/// Returns the first entry for which 'isPast(key)' is true. 'isPast' must be false for a (possibly empty) run of keys and true for all keys after
+		/// </summary>
+		template<typename Pred>
+		Iterator Seek(Pred&& isPast) const;
+
+		detail::SortedTableIndexEntry GetIndexEntry(size_t block) const;
+		std::string_view GetBlockKey(size_t block) const;
+
+		ReadOnlyFileView m_view;
+
+		const char* m_entries = nullptr;
+		size_t m_entriesSize = 0;
+		const char* m_index = nullptr;
+		const char* m_indexKeys = nullptr;
+		size_t m_nrOfBlocks = 0;
+		const unsigned char* m_bloom = nullptr;
+		size_t m_nrOfBloomBlocks = 0;
+		uint32_t m_nrOfBloomProbes = 0;
+		size_t m_nrOfEntries = 0;
+	};
+
+	SortedTableWriter::SortedTableWriter(FileView view, Options options)
+		: m_view(std::move(view))
+		, m_options(options)
+	{
+	}
+
+	std::optional<SortedTableWriter> SortedTableWriter::Create(const std::filesystem::path& filepath)
+	{
+		return Create(filepath, Options{});
+	}
+
+	std::optional<SortedTableWriter> SortedTableWriter::Create(const std::filesystem::path& filepath, Options options)
+	{
+		if (options.blockSize == 0)
+		{
+			std::cerr << "SortedTableWriter::Create > Block size cannot be 0\n";
+			return std::nullopt;
+		}
+
+		if (PathUtils::DoesFileExist(filepath))
+		{
+			std::filesystem::remove(filepath);
+		}
+
+		// The file grows with every piece that is written, it is never bigger than the data written so far
+		std::optional<FileView> view = FileView::CreateViewForNewFile(filepath, 1);
+		if (!view)
+		{
+			return std::nullopt;
+		}
+
+		return SortedTableWriter{ std::move(*view), options };
+	}
+
+	bool SortedTableWriter::Add(std::string_view key, std::string_view value)
+	{
+		if (m_isFinished)
+		{
+			std::cerr << "SortedTableWriter::Add > Table is already finished\n";
+			return false;
+		}
+
+		if (!m_hashes.empty() && key <= m_lastKey)
+		{
+			std::cerr << "SortedTableWriter::Add > Keys must be added in strictly ascending order\n";
+			return false;
+		}
+
+		if (key.size() > std::numeric_limits<uint32_t>::max() || value.size() > std::numeric_limits<uint32_t>::max())
+		{
+			std::cerr << "SortedTableWriter::Add > Keys and values must be smaller than 4 GB\n";
+			return false;
+		}
+
+		const size_t offset = m_writtenSize + m_pending.size();
+		if (m_hashes.empty() || offset - m_blockStart >= m_options.blockSize)
+		{
+			m_blockStart = offset;
+			m_index.push_back({ offset, m_indexKeys.size(), key.size() });
+			m_indexKeys += key;
+		}
+
+		const uint32_t sizes[2]{ static_cast<uint32_t>(key.size()), static_cast<uint32_t>(value.size()) };
+		m_pending.append(reinterpret_cast<const char*>(sizes), sizeof(sizes));
+		m_pending += key;
+		m_pending += value;
+
+		m_hashes.push_back(detail::GetBloomHash(key));
+		m_lastKey.assign(key);
+
+		return m_pending.size() < WriteSize || WritePending();
+	}
+
+	bool SortedTableWriter::Finish()
+	{
+		if (m_isFinished)
+		{
+			return true;
+		}
+
+		detail::SortedTableFooter footer{};
+		std::memcpy(footer.magic, detail::SortedTableMagic, sizeof(footer.magic));
+		footer.version = detail::SortedTableVersion;
+		footer.nrOfEntries = m_hashes.size();
+		footer.indexOffset = m_writtenSize + m_pending.size();
+		footer.nrOfBlocks = m_index.size();
+
+		m_pending.append(reinterpret_cast<const char*>(m_index.data()), m_index.size() * sizeof(detail::SortedTableIndexEntry));
+		m_pending += m_indexKeys;
+
+		// Only the block of a key is probed, so the filter is sized in whole blocks
+		if (m_options.bloomBitsPerKey > 0)
+		{
+			const size_t nrOfBits = std::max<size_t>(1, m_hashes.size() * m_options.bloomBitsPerKey);
+			footer.nrOfBloomBlocks = (nrOfBits + detail::BloomBlockBits - 1) / detail::BloomBlockBits;
+			footer.nrOfBloomProbes = static_cast<uint32_t>(std::clamp<double>(std::round(m_options.bloomBitsPerKey * 0.69), 1.0, 30.0));
+		}
+
+		footer.bloomOffset = m_writtenSize + m_pending.size();
+
+		std::string bloom(footer.nrOfBloomBlocks * detail::BloomBlockSize, '\0');
+		for (const uint64_t hash : m_hashes)
+		{
+			detail::ForEachBloomBit(hash, footer.nrOfBloomBlocks, footer.nrOfBloomProbes, [&bloom](uint64_t bit)
+				{
+					bloom[bit / 8] |= static_cast<char>(1 << (bit % 8));
+					return true;
+				});
+		}
+
+		m_pending += bloom;
+		m_pending.append(reinterpret_cast<const char*>(&footer), sizeof(footer));
+
+		if (!WritePending() || !m_view.Flush())
+		{
+			std::cerr << "SortedTableWriter::Finish > Could not write the table\n";
+			return false;
+		}
+
+		m_isFinished = true;
+		return true;
+	}
+
+	size_t SortedTableWriter::GetNrOfEntries() const
+	{
+		return m_hashes.size();
+	}
+
+	bool SortedTableWriter::WritePending()
+	{
+		if (!m_view.Write(m_pending, m_writtenSize))
+		{
+			return false;
+		}
+
+		m_writtenSize += m_pending.size();
+		m_pending.clear();
+		return true;
+	}
+
+	SortedTableIterator::SortedTableIterator(const char* position)
+		: m_position(position)
+	{
+	}
+
+	SortedTableEntry SortedTableIterator::operator*() const
+	{
+		uint32_t sizes[2];
+		std::memcpy(sizes, m_position, sizeof(sizes));
+
+		const char* const key = m_position + detail::SortedTableEntryHeaderSize;
+		return { { key, sizes[0] }, { key + sizes[0], sizes[1] } };
+	}
+
+	SortedTableIterator& SortedTableIterator::operator++()
+	{
+		uint32_t sizes[2];
+		std::memcpy(sizes, m_position, sizeof(sizes));
+
+		m_position += detail::SortedTableEntryHeaderSize + sizes[0] + sizes[1];
+		return *this;
+	}
+
+	SortedTableIterator SortedTableIterator::operator++(int)
+	{
+		SortedTableIterator temp = *this;
+		++*this;
+		return temp;
+	}
+
+	bool SortedTableIterator::operator==(const SortedTableIterator& other) const
+	{
+		return m_position == other.m_position;
+	}
+
+	SortedTableReader::SortedTableReader(ReadOnlyFileView view)
+		: m_view(std::move(view))
+	{
+	}
+
+	std::optional<SortedTableReader> SortedTableReader::Open(const std::filesystem::path& filepath)
+	{
+		std::optional<ReadOnlyFileView> view = ReadOnlyFileView::CreateViewFromExistingFile(filepath, FileOpenMode::OpenExisting);
+		if (!view)
+		{
+			return std::nullopt;
+		}
+
+		SortedTableReader reader{ std::move(*view) };
+		if (!reader.Load())
+		{
+			std::cerr << "SortedTableReader::Open > " << filepath << " is not a sorted table\n";
+			return std::nullopt;
+		}
+
+		return reader;
+	}
+
+	bool SortedTableReader::Load()
+	{
+		const size_t fileSize = m_view.GetMappedSize();
+		if (fileSize < sizeof(detail::SortedTableFooter))
+		{
+			return false;
+		}
+
+		const char* const data = m_view.GetData();
+
+		detail::SortedTableFooter footer;
+		std::memcpy(&footer, data + fileSize - sizeof(footer), sizeof(footer));
+
+		if (std::memcmp(footer.magic, detail::SortedTableMagic, sizeof(footer.magic)) != 0 || footer.version != detail::SortedTableVersion)
+		{
+			return false;
+		}
+
+		// Only the layout is validated, the index and the filter are never read up front. Every offset and count is bounded by what is left in
+		// front of the footer before it is multiplied or added, so a corrupt footer can not wrap around and point outside of the mapping
+		const uint64_t tablesEnd = fileSize - sizeof(footer);
+		if (footer.bloomOffset > tablesEnd || footer.nrOfBloomBlocks > (tablesEnd - footer.bloomOffset) / detail::BloomBlockSize ||
+			footer.bloomOffset + footer.nrOfBloomBlocks * detail::BloomBlockSize != tablesEnd ||
+			footer.indexOffset > footer.bloomOffset ||
+			footer.nrOfBlocks > (footer.bloomOffset - footer.indexOffset) / sizeof(detail::SortedTableIndexEntry) ||
+			(footer.nrOfBlocks == 0) != (footer.nrOfEntries == 0))
+		{
+			return false;
+		}
+
+		const uint64_t indexKeysOffset = footer.indexOffset + footer.nrOfBlocks * sizeof(detail::SortedTableIndexEntry);
+
+		m_entries = data;
+		m_entriesSize = static_cast<size_t>(footer.indexOffset);
+		m_index = data + footer.indexOffset;
+		m_indexKeys = data + indexKeysOffset;
+		m_nrOfBlocks = static_cast<size_t>(footer.nrOfBlocks);
+		m_bloom = reinterpret_cast<const unsigned char*>(data + footer.bloomOffset);
+		m_nrOfBloomBlocks = static_cast<size_t>(footer.nrOfBloomBlocks);
+		m_nrOfBloomProbes = footer.nrOfBloomProbes;
+		m_nrOfEntries = static_cast<size_t>(footer.nrOfEntries);
+
+		// Index keys are stored in order, so if the last one fits, all of them do
+		if (m_nrOfBlocks > 0)
+		{
+			const detail::SortedTableIndexEntry last = GetIndexEntry(m_nrOfBlocks - 1);
+			const uint64_t indexKeysSize = footer.bloomOffset - indexKeysOffset;
+			if (last.blockOffset >= m_entriesSize || last.keyOffset > indexKeysSize || last.keySize > indexKeysSize - last.keyOffset)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	std::optional<std::string_view> SortedTableReader::Get(std::string_view key) const
+	{
+		if (!MayContain(key))
+		{
+			return std::nullopt;
+		}
+
+		const Iterator it = LowerBound(key);
+		if (it == end())
+		{
+			return std::nullopt;
+		}
+
+		const SortedTableEntry entry = *it;
+		if (entry.key != key)
+		{
+			return std::nullopt;
+		}
+
+		return entry.value;
+	}
+
+	bool SortedTableReader::MayContain(std::string_view key) const
+	{
+		if (m_nrOfBloomBlocks == 0)
+		{
+			return m_nrOfEntries > 0;
+		}
+
+		return detail::ForEachBloomBit(detail::GetBloomHash(key), m_nrOfBloomBlocks, m_nrOfBloomProbes, [this](uint64_t bit)
+			{
+				return (m_bloom[bit / 8] & (1 << (bit % 8))) != 0;
+			});
+	}
+
+	SortedTableReader::Iterator SortedTableReader::LowerBound(std::string_view key) const
+	{
+		return Seek([key](std::string_view entryKey) { return entryKey >= key; });
+	}
+
+	std::ranges::subrange<SortedTableReader::Iterator> SortedTableReader::Range(std::string_view from, std::string_view to) const
+	{
+		const Iterator first = LowerBound(from);
+		if (to <= from)
+		{
+			return { first, first };
+		}
+
+		return { first, LowerBound(to) };
+	}
+
+	std::ranges::subrange<SortedTableReader::Iterator> SortedTableReader::Prefix(std::string_view prefix) const
+	{
+		// Truncating sorted keys keeps them sorted, so "the prefix of the key is past 'prefix'" is a valid seek predicate
+		return { LowerBound(prefix), Seek([prefix](std::string_view entryKey) { return entryKey.substr(0, prefix.size()) > prefix; }) };
+	}
+
+	SortedTableReader::Iterator SortedTableReader::begin() const
+	{
+		return Iterator{ m_entries };
+	}
+
+	SortedTableReader::Iterator SortedTableReader::end() const
+	{
+		return Iterator{ m_entries + m_entriesSize };
+	}
+
+	size_t SortedTableReader::GetNrOfEntries() const
+	{
+		return m_nrOfEntries;
+	}
+
+	template<typename Pred>
+	SortedTableReader::Iterator SortedTableReader::Seek(Pred&& isPast) const
+	{
+		// Find the first block whose first key is already past, the entry we are looking for is in the block before it
+		size_t low{};
+		size_t high = m_nrOfBlocks;
+
+		while (low < high)
+		{
+			const size_t middle = low + (high - low) / 2;
+			if (isPast(GetBlockKey(middle)))
+			{
+				high = middle;
+			}
+			else
+			{
+				low = middle + 1;
+			}
+		}
+
+		if (low == 0)
+		{
+			return begin();
+		}
+
+		Iterator it{ m_entries + GetIndexEntry(low - 1).blockOffset };
+		const Iterator blockEnd = low == m_nrOfBlocks ? end() : Iterator{ m_entries + GetIndexEntry(low).blockOffset };
+
+		while (it != blockEnd && !isPast((*it).key))
+		{
+			++it;
+		}
+
+		return it;
+	}
+
+	detail::SortedTableIndexEntry SortedTableReader::GetIndexEntry(size_t block) const
+	{
+		detail::SortedTableIndexEntry entry;
+		std::memcpy(&entry, m_index + block * sizeof(entry), sizeof(entry));
+		return entry;
+	}
+
+	std::string_view SortedTableReader::GetBlockKey(size_t block) const
+	{
+		const detail::SortedTableIndexEntry entry = GetIndexEntry(block);
+		return { m_indexKeys + entry.keyOffset, static_cast<size_t>(entry.keySize) };
+	}
+} // namespace rapidio
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "rapidio.hpp"
+
+#include <condition_variable>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace rapidio
+{
+	namespace detail
+	{
+		/// <summary>
+		/// State shared between a StreamReader and its background read-ahead thread.
+		/// Lives on the heap so the StreamReader itself can be moved while the thread is running
+		/// </summary>
+		struct ReadAheadState final
+		{
+			struct Buffer
+			{
+				std::vector<char> data;
+				size_t size = 0;
+			};
+
+			std::vector<Buffer> buffers;
+			size_t head = 0; // Buffer the consumer is currently reading from
+			size_t filledCount = 0; // Number of buffers filled by the reader thread, starting at 'head'
+			bool eof = false;
+			bool stopRequested = false;
+			bool finished = false;
+
+			std::mutex mutex;
+			std::condition_variable bufferFilled;
+			std::condition_variable bufferDrained;
+
+			#ifdef _WIN32
+			Win32Handle streamHandle;
+			#endif // _WIN32
+		};
+	} // namespace detail
+
+	class StreamReader final
+	{
+	public:
+		static constexpr size_t DefaultBufferSize = 1024 * 1024 * 4; // 4 MB
+		static constexpr size_t DefaultBufferCount = 4;
+
+		/// <summary>
+		/// Creates a StreamReader for the given path. If the path turns out to be a regular, non-empty file it is mapped through a FileView,
+		/// otherwise (pipes, FIFOs, character devices, ...) a background thread keeps a ring of buffers filled ahead of the consumer
+		/// </summary>
+		/// <param name="filepath">Path to the file, pipe or device to read from</param>
+		/// <param name="bufferSize">Size of every read-ahead buffer. Unused if the input is mapped</param>
+		/// <param name="bufferCount">Number of read-ahead buffers in the ring. Unused if the input is mapped</param>
+		/// <returns>std::nullopt if the input could not be opened. A valid optional of a StreamReader otherwise</returns>
+		static std::optional<StreamReader> CreateFromFile(const std::filesystem::path& filepath, size_t bufferSize = DefaultBufferSize,
+			size_t bufferCount = DefaultBufferCount);
+
+		/// <summary>
+		/// Creates a StreamReader reading from the standard input of the process. Standard input is always read through the read-ahead ring
+		/// </summary>
+		/// <param name="bufferSize">Size of every read-ahead buffer</param>
+		/// <param name="bufferCount">Number of read-ahead buffers in the ring</param>
+		/// <returns>std::nullopt if the read-ahead thread could not be started. A valid optional of a StreamReader otherwise</returns>
+		static std::optional<StreamReader> CreateFromStdIn(size_t bufferSize = DefaultBufferSize, size_t bufferCount = DefaultBufferCount);
+
+		~StreamReader();
+
+		StreamReader(const StreamReader&) = delete;
+		StreamReader(StreamReader&& other) noexcept = default;
+		StreamReader& operator=(const StreamReader&) = delete;
+		StreamReader& operator=(StreamReader&& other) noexcept;
+
+		// Returns true if the input is read through a FileView rather than the read-ahead ring
+		bool IsMapped() const;
+
+		/// <summary>
+		/// Returns the next contiguous span of at most 'maxBytes' without copying any data.
+		/// The span is valid until the next call to ReadSpan() or Read(). An empty span means EOF has been reached
+		/// </summary>
+		/// <param name="maxBytes">Maximum number of bytes to return</param>
+		/// <returns>Span of the read data</returns>
+		std::span<const char> ReadSpan(size_t maxBytes);
+
+		/// <summary>
+		/// Read bytes from the stream and return a std::string. Fewer bytes are returned only when EOF is reached
+		/// </summary>
+		/// <param name="bytesToRead">Number of bytes to read</param>
+		/// <returns>std::string containing read data</returns>
+		std::string Read(size_t bytesToRead);
+
+		/// <summary>
+		/// Read bytes from the stream and assign the data to the given Buffer-like. If the requested bytes are contiguous in the current
+		/// read-ahead buffer (or the input is mapped) no intermediate copy is made
+		/// </summary>
+		/// <param name="buffer">The buffer-like object to store the read data in</param>
+		/// <param name="bytesToRead">Number of bytes to read</param>
+		/// <returns>Returns true if any data was read, false at EOF</returns>
+		template<IsBufferLike T>
+		bool Read(T& buffer, size_t bytesToRead);
+
+	private:
+		StreamReader() = default;
+
+		bool StartReadAhead(size_t bufferSize, size_t bufferCount);
+		void StopReadAhead();
+		void ReleaseConsumedBuffer();
+		static void ReadAheadLoop(detail::ReadAheadState* state);
+
+		std::optional<ReadOnlyFileView> m_fileView;
+		std::unique_ptr<detail::ReadAheadState> m_state;
+		std::thread m_readAheadThread;
+		size_t m_consumed = 0; // Bytes consumed from the head buffer
+		std::string m_staging; // Only used when a read straddles two read-ahead buffers
+	};
+} // namespace rapidio
+
+#ifdef _WIN32
+#	include "StreamReaderWin32.hpp"
+#endif // _WIN32
@@ -0,0 +1,317 @@
+#pragma once
+
+#include "PathUtils.hpp"
+
+#include "Win32Call.hpp"
+#include "Win32Handle.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+namespace rapidio
+{
+	std::optional<StreamReader> StreamReader::CreateFromFile(const std::filesystem::path& filepath, size_t bufferSize /* = DefaultBufferSize */,
+		size_t bufferCount /* = DefaultBufferCount */)
+	{
+		Win32Handle streamHandle{ CALL_WIN32_RV
+		(
+			CreateFileA
+			(
+				filepath.string().c_str(),
+				GENERIC_READ,
+				FILE_SHARE_READ | FILE_SHARE_WRITE,
+				nullptr,
+				OPEN_EXISTING,
+				FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+				nullptr
+			)
+		) };
+
+		if (!streamHandle.IsValid())
+		{
+			std::cerr << "StreamReader::CreateFromFile > Could not open " << filepath << "\n";
+			return std::nullopt;
+		}
+
+		StreamReader reader;
+
+		// Regular files with a known size can be mapped, everything else has to be streamed
+		LARGE_INTEGER filesize{};
+		if (CALL_WIN32_RV(GetFileType(streamHandle.Get())) == FILE_TYPE_DISK &&
+			CALL_WIN32_RV(GetFileSizeEx(streamHandle.Get(), &filesize)) != 0 &&
+			filesize.QuadPart > 0)
+		{
+			// FileView opens the file with exclusive access, so we have to let go of our own handle first
+			streamHandle.Release();
+
+			reader.m_fileView = ReadOnlyFileView::CreateViewFromExistingFile(filepath, FileOpenMode::OpenExisting);
+			if (!reader.m_fileView)
+			{
+				return std::nullopt;
+			}
+
+			return reader;
+		}
+
+		reader.m_state = std::make_unique<detail::ReadAheadState>();
+		reader.m_state->streamHandle = std::move(streamHandle);
+
+		if (!reader.StartReadAhead(bufferSize, bufferCount))
+		{
+			return std::nullopt;
+		}
+
+		return reader;
+	}
+
+	std::optional<StreamReader> StreamReader::CreateFromStdIn(size_t bufferSize /* = DefaultBufferSize */, size_t bufferCount /* = DefaultBufferCount */)
+	{
+		void* const stdIn = CALL_WIN32_RV(GetStdHandle(STD_INPUT_HANDLE));
+		if (stdIn == nullptr || stdIn == INVALID_HANDLE_VALUE)
+		{
+			std::cerr << "StreamReader::CreateFromStdIn > Process has no standard input\n";
+			return std::nullopt;
+		}
+
+		StreamReader reader;
+
+		// Standard input is owned by the process, so it must never be closed by us. A duplicate of it can be
+		void* duplicate{};
+		if (CALL_WIN32_RV(DuplicateHandle(GetCurrentProcess(), stdIn, GetCurrentProcess(), &duplicate, 0, FALSE, DUPLICATE_SAME_ACCESS)) == 0)
+		{
+			std::cerr << "StreamReader::CreateFromStdIn > Could not duplicate standard input\n";
+			return std::nullopt;
+		}
+
+		reader.m_state = std::make_unique<detail::ReadAheadState>();
+		reader.m_state->streamHandle = Win32Handle{ duplicate };
+
+		if (!reader.StartReadAhead(bufferSize, bufferCount))
+		{
+			return std::nullopt;
+		}
+
+		return reader;
+	}
+
+	StreamReader::~StreamReader()
+	{
+		StopReadAhead();
+	}
+
+	StreamReader& StreamReader::operator=(StreamReader&& other) noexcept
+	{
+		if (this != &other)
+		{
+			StopReadAhead();
+
+			m_fileView = std::move(other.m_fileView);
+			m_state = std::move(other.m_state);
+			m_readAheadThread = std::move(other.m_readAheadThread);
+			m_consumed = other.m_consumed;
+			m_staging = std::move(other.m_staging);
+		}
+
+		return *this;
+	}
+
+	bool StreamReader::IsMapped() const
+	{
+		return m_fileView.has_value();
+	}
+
+	std::span<const char> StreamReader::ReadSpan(size_t maxBytes)
+	{
+		if (m_fileView)
+		{
+			detail::SpanBuffer buffer;
+			if (!m_fileView->Read(buffer, maxBytes))
+			{
+				return {};
+			}
+
+			return { buffer.data(), buffer.size() };
+		}
+
+		if (!m_state || maxBytes == 0)
+		{
+			return {};
+		}
+
+		// The previously returned span is no longer in use, so a fully consumed buffer can go back to the reader thread
+		ReleaseConsumedBuffer();
+
+		std::unique_lock lock(m_state->mutex);
+		m_state->bufferFilled.wait(lock, [this]() { return m_state->filledCount > 0 || m_state->eof; });
+
+		if (m_state->filledCount == 0)
+		{
+			return {};
+		}
+
+		const detail::ReadAheadState::Buffer& buffer = m_state->buffers[m_state->head];
+		const size_t bytesRead = std::min(maxBytes, buffer.size - m_consumed);
+		const char* const data = buffer.data.data() + m_consumed;
+		m_consumed += bytesRead;
+
+		return { data, bytesRead };
+	}
+
+	std::string StreamReader::Read(size_t bytesToRead)
+	{
+		std::string temp;
+		temp.reserve(bytesToRead);
+		Read(temp, bytesToRead);
+		return temp;
+	}
+
+	template<IsBufferLike T>
+	bool StreamReader::Read(T& buffer, size_t bytesToRead)
+	{
+		if (m_fileView)
+		{
+			return m_fileView->Read(buffer, bytesToRead);
+		}
+
+		std::span<const char> span = ReadSpan(bytesToRead);
+		if (span.empty())
+		{
+			return false;
+		}
+
+		// Fast path: the whole request was contiguous inside a single read-ahead buffer
+		if (span.size() == bytesToRead)
+		{
+			buffer.assign(const_cast<char*>(span.data()), span.size());
+			return true;
+		}
+
+		m_staging.assign(span.data(), span.size());
+		while (m_staging.size() < bytesToRead)
+		{
+			span = ReadSpan(bytesToRead - m_staging.size());
+			if (span.empty())
+			{
+				break;
+			}
+
+			m_staging.append(span.data(), span.size());
+		}
+
+		buffer.assign(m_staging.data(), m_staging.size());
+		return true;
+	}
+
+	bool StreamReader::StartReadAhead(size_t bufferSize, size_t bufferCount)
+	{
+		if (bufferSize == 0 || bufferCount < 2)
+		{
+			std::cerr << "StreamReader > Read-ahead requires a non-zero buffer size and at least 2 buffers\n";
+			return false;
+		}
+
+		m_state->buffers.resize(bufferCount);
+		for (detail::ReadAheadState::Buffer& buffer : m_state->buffers)
+		{
+			buffer.data.resize(bufferSize);
+		}
+
+		m_readAheadThread = std::thread(&StreamReader::ReadAheadLoop, m_state.get());
+		return true;
+	}
+
+	void StreamReader::StopReadAhead()
+	{
+		if (!m_readAheadThread.joinable())
+		{
+			return;
+		}
+
+		std::unique_lock lock(m_state->mutex);
+		m_state->stopRequested = true;
+		m_state->bufferDrained.notify_all();
+
+		// The reader thread might be blocked inside ReadFile() on a pipe that never delivers data, so keep cancelling it until it is done
+		while (!m_state->finished)
+		{
+			CALL_WIN32_IGNORE_ERROR(CancelSynchronousIo(m_readAheadThread.native_handle()), ERROR_NOT_FOUND);
+			m_state->bufferFilled.wait_for(lock, std::chrono::milliseconds(1));
+		}
+
+		lock.unlock();
+		m_readAheadThread.join();
+	}
+
+	void StreamReader::ReleaseConsumedBuffer()
+	{
+		{
+			std::lock_guard lock(m_state->mutex);
+			if (m_state->filledCount == 0 || m_consumed < m_state->buffers[m_state->head].size)
+			{
+				return;
+			}
+
+			m_state->head = (m_state->head + 1) % m_state->buffers.size();
+			--m_state->filledCount;
+		}
+
+		m_consumed = 0;
+		m_state->bufferDrained.notify_one();
+	}
+
+	void StreamReader::ReadAheadLoop(detail::ReadAheadState* state)
+	{
+		const size_t nrOfBuffers = state->buffers.size();
+		size_t tail = 0;
+
+		while (true)
+		{
+			{
+				std::unique_lock lock(state->mutex);
+				state->bufferDrained.wait(lock, [state, nrOfBuffers]() { return state->filledCount < nrOfBuffers || state->stopRequested; });
+
+				if (state->stopRequested)
+				{
+					break;
+				}
+			}
+
+			// The tail buffer is owned by this thread until it is published, so it can be filled without holding the lock
+			detail::ReadAheadState::Buffer& buffer = state->buffers[tail];
+			const DWORD bytesToRead = static_cast<DWORD>(std::min<size_t>(buffer.data.size(), MAXDWORD));
+			DWORD bytesRead{};
+
+			// Broken pipes signal EOF, and aborted reads are our own cancellation, so neither is reported as an error
+			const BOOL success = ReadFile(state->streamHandle.Get(), buffer.data.data(), bytesToRead, &bytesRead, nullptr);
+			if (!success)
+			{
+				const DWORD error = GetLastError();
+				SetLastError(ERROR_SUCCESS);
+
+				if (error != ERROR_BROKEN_PIPE && error != ERROR_HANDLE_EOF && error != ERROR_OPERATION_ABORTED)
+				{
+					std::cerr << "StreamReader > ReadFile failed with error " << error << "\n";
+				}
+			}
+
+			std::lock_guard lock(state->mutex);
+
+			if (!success || bytesRead == 0)
+			{
+				state->eof = true;
+				break;
+			}
+
+			buffer.size = bytesRead;
+			++state->filledCount;
+			tail = (tail + 1) % nrOfBuffers;
+			state->bufferFilled.notify_one();
+		}
+
+		std::lock_guard lock(state->mutex);
+		state->eof = true;
+		state->finished = true;
+		state->bufferFilled.notify_all();
+	}
+} // namespace rapidio
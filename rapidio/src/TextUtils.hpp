@@ -0,0 +1,308 @@
+#pragma once
+
+#include "CopyUtils.hpp"
+#include "ScanUtils.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace rapidio
+{
+	namespace detail
+	{
+		// Returns the number of bytes of the sequence started by 'lead'. Continuation bytes and invalid leads count as a single byte
+		size_t GetUtf8SequenceLength(unsigned char lead)
+		{
+			if (lead < 0xC0)
+			{
+				return 1;
+			}
+
+			return lead < 0xE0 ? 2 : lead < 0xF0 ? 3 : 4;
+		}
+
+		bool IsUtf8Continuation(unsigned char byte)
+		{
+			return (byte & 0xC0) == 0x80;
+		}
+
+		/// <summary>
+		/// Returns the offset of the first byte at or after 'position' that does not start a valid UTF-8 sequence, or 'size' if there is none.
+		/// Rejects overlong encodings, surrogates, code points past U+10FFFF and sequences cut off by the end of the data.
+		/// Runs of ASCII are skipped 8 bytes at a time
+		/// </summary>
+		size_t FindInvalidUtf8Scalar(const unsigned char* data, size_t size, size_t position)
+		{
+			while (position < size)
+			{
+				if (position + sizeof(uint64_t) <= size)
+				{
+					uint64_t word;
+					std::memcpy(&word, data + position, sizeof(word));
+					if ((word & 0x8080808080808080ull) == 0)
+					{
+						position += sizeof(word);
+						continue;
+					}
+				}
+
+				const unsigned char lead = data[position];
+				if (lead < 0x80)
+				{
+					++position;
+					continue;
+				}
+
+				// The second byte of some sequences has a narrower range, which rules out overlong encodings, surrogates and code points past U+10FFFF
+				unsigned char secondMin = 0x80;
+				unsigned char secondMax = 0xBF;
+				size_t length{};
+
+				if (lead >= 0xC2 && lead <= 0xDF)
+				{
+					length = 2;
+				}
+				else if (lead >= 0xE0 && lead <= 0xEF)
+				{
+					length = 3;
+					secondMin = lead == 0xE0 ? 0xA0 : secondMin;
+					secondMax = lead == 0xED ? 0x9F : secondMax;
+				}
+				else if (lead >= 0xF0 && lead <= 0xF4)
+				{
+					length = 4;
+					secondMin = lead == 0xF0 ? 0x90 : secondMin;
+					secondMax = lead == 0xF4 ? 0x8F : secondMax;
+				}
+				else
+				{
+					return position;
+				}
+
+				if (size - position < length || data[position + 1] < secondMin || data[position + 1] > secondMax)
+				{
+					return position;
+				}
+
+				for (size_t i{ 2 }; i < length; ++i)
+				{
+					if (!IsUtf8Continuation(data[position + i]))
+					{
+						return position;
+					}
+				}
+
+				position += length;
+			}
+
+			return size;
+		}
+
+		/// <summary>
+		/// Returns where validation can resume at 'position', given that everything before it is known to be valid: the start of the sequence
+		/// that 'position' is part of, or that is still missing continuation bytes at 'position'
+		/// </summary>
+		size_t GetUtf8ResumePosition(const unsigned char* data, size_t position)
+		{
+			for (size_t back{ 1 }; back <= 3 && back <= position; ++back)
+			{
+				if (!IsUtf8Continuation(data[position - back]))
+				{
+					return position - back;
+				}
+			}
+
+			return position;
+		}
+
+		#ifdef RAPIDIO_X86
+		/// <summary>
+		/// Lookup table validator by Keiser and Lemire: three table lookups, on the nibbles of every byte and the byte before it, classify every
+		/// pair of bytes into error bits, and a saturating subtraction checks that the third and fourth bytes of long sequences are continuations.
+		/// A block of only ASCII just checks that the block before it did not end in the middle of a sequence.
+		/// Blocks are only checked for errors as a whole, the exact offset is found by the scalar validator from the start of the failing sequence
+		/// </summary>
+		RAPIDIO_TARGET("avx2")
+		size_t FindInvalidUtf8AVX2(const unsigned char* data, size_t size)
+		{
+			constexpr char TooShort = 1 << 0;			// A lead byte or ASCII where a continuation byte is expected
+			constexpr char TooLong = 1 << 1;			// A continuation byte after ASCII
+			constexpr char Overlong3 = 1 << 2;			// 11100000 100_____
+			constexpr char TooLarge = 1 << 3;			// Past U+10FFFF
+			constexpr char Surrogate = 1 << 4;			// 11101101 101_____
+			constexpr char Overlong2 = 1 << 5;			// 1100000_ 10______
+			constexpr char TooLarge1000 = 1 << 6;		// 11110101 1000____ and higher
+			constexpr char Overlong4 = 1 << 6;			// 11110000 1000____
+			constexpr char TwoContinuations = static_cast<char>(1 << 7); // 10______ 10______, allowed as the third and fourth byte of a sequence
+			constexpr char Carry = TooShort | TooLong | TwoContinuations;
+
+			// Indexed by the high nibble of the previous byte
+			const __m256i firstHighNibble = _mm256_setr_epi8(
+				TooLong, TooLong, TooLong, TooLong, TooLong, TooLong, TooLong, TooLong,
+				TwoContinuations, TwoContinuations, TwoContinuations, TwoContinuations,
+				TooShort | Overlong2, TooShort, TooShort | Overlong3 | Surrogate, TooShort | TooLarge | TooLarge1000 | Overlong4,
+				TooLong, TooLong, TooLong, TooLong, TooLong, TooLong, TooLong, TooLong,
+				TwoContinuations, TwoContinuations, TwoContinuations, TwoContinuations,
+				TooShort | Overlong2, TooShort, TooShort | Overlong3 | Surrogate, TooShort | TooLarge | TooLarge1000 | Overlong4);
+
+			// Indexed by the low nibble of the previous byte
+			const __m256i firstLowNibble = _mm256_setr_epi8(
+				Carry | Overlong3 | Overlong2 | Overlong4, Carry | Overlong2, Carry, Carry,
+				Carry | TooLarge, Carry | TooLarge | TooLarge1000, Carry | TooLarge | TooLarge1000, Carry | TooLarge | TooLarge1000,
+				Carry | TooLarge | TooLarge1000, Carry | TooLarge | TooLarge1000, Carry | TooLarge | TooLarge1000, Carry | TooLarge | TooLarge1000,
+				Carry | TooLarge | TooLarge1000, Carry | TooLarge | TooLarge1000 | Surrogate, Carry | TooLarge | TooLarge1000, Carry | TooLarge | TooLarge1000,
+				Carry | Overlong3 | Overlong2 | Overlong4, Carry | Overlong2, Carry, Carry,
+				Carry | TooLarge, Carry | TooLarge | TooLarge1000, Carry | TooLarge | TooLarge1000, Carry | TooLarge | TooLarge1000,
+				Carry | TooLarge | TooLarge1000, Carry | TooLarge | TooLarge1000, Carry | TooLarge | TooLarge1000, Carry | TooLarge | TooLarge1000,
+				Carry | TooLarge | TooLarge1000, Carry | TooLarge | TooLarge1000 | Surrogate, Carry | TooLarge | TooLarge1000, Carry | TooLarge | TooLarge1000);
+
+			// Indexed by the high nibble of the byte itself
+			const __m256i secondHighNibble = _mm256_setr_epi8(
+				TooShort, TooShort, TooShort, TooShort, TooShort, TooShort, TooShort, TooShort,
+				TooLong | Overlong2 | TwoContinuations | Overlong3 | TooLarge1000 | Overlong4,
+				TooLong | Overlong2 | TwoContinuations | Overlong3 | TooLarge,
+				TooLong | Overlong2 | TwoContinuations | Surrogate | TooLarge,
+				TooLong | Overlong2 | TwoContinuations | Surrogate | TooLarge,
+				TooShort, TooShort, TooShort, TooShort,
+				TooShort, TooShort, TooShort, TooShort, TooShort, TooShort, TooShort, TooShort,
+				TooLong | Overlong2 | TwoContinuations | Overlong3 | TooLarge1000 | Overlong4,
+				TooLong | Overlong2 | TwoContinuations | Overlong3 | TooLarge,
+				TooLong | Overlong2 | TwoContinuations | Surrogate | TooLarge,
+				TooLong | Overlong2 | TwoContinuations | Surrogate | TooLarge,
+				TooShort, TooShort, TooShort, TooShort);
+
+			const __m256i nibbleMask = _mm256_set1_epi8(0x0F);
+			const __m256i thirdByteThreshold = _mm256_set1_epi8(static_cast<char>(0xE0 - 0x80));
+			const __m256i fourthByteThreshold = _mm256_set1_epi8(static_cast<char>(0xF0 - 0x80));
+			const __m256i highBit = _mm256_set1_epi8(static_cast<char>(0x80));
+
+			// Only the last three bytes of a block can start a sequence that continues in the next block
+			const __m256i incompleteThreshold = _mm256_setr_epi8(
+				-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+				-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+				static_cast<char>(0xF0 - 1), static_cast<char>(0xE0 - 1), static_cast<char>(0xC0 - 1));
+
+			__m256i previous = _mm256_setzero_si256();
+			__m256i previousIncomplete = _mm256_setzero_si256();
+
+			size_t position{};
+			for (; position + 32 <= size; position += 32)
+			{
+				const __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + position));
+				__m256i error;
+
+				if (_mm256_movemask_epi8(input) == 0)
+				{
+					error = previousIncomplete;
+				}
+				else
+				{
+					// The bytes 1, 2 and 3 positions earlier, reaching into the previous block
+					const __m256i carried = _mm256_permute2x128_si256(previous, input, 0x21);
+					const __m256i previous1 = _mm256_alignr_epi8(input, carried, 15);
+					const __m256i previous2 = _mm256_alignr_epi8(input, carried, 14);
+					const __m256i previous3 = _mm256_alignr_epi8(input, carried, 13);
+
+					const __m256i specialCases = _mm256_and_si256(_mm256_and_si256(
+						_mm256_shuffle_epi8(firstHighNibble, _mm256_and_si256(_mm256_srli_epi16(previous1, 4), nibbleMask)),
+						_mm256_shuffle_epi8(firstLowNibble, _mm256_and_si256(previous1, nibbleMask))),
+						_mm256_shuffle_epi8(secondHighNibble, _mm256_and_si256(_mm256_srli_epi16(input, 4), nibbleMask)));
+
+					// Continuations that are the third or fourth byte of a sequence cancel out their TwoContinuations bit, any other leaves an error
+					const __m256i mustBeContinuation = _mm256_and_si256(_mm256_or_si256(
+						_mm256_subs_epu8(previous2, thirdByteThreshold), _mm256_subs_epu8(previous3, fourthByteThreshold)), highBit);
+
+					error = _mm256_xor_si256(mustBeContinuation, specialCases);
+					previousIncomplete = _mm256_subs_epu8(input, incompleteThreshold);
+				}
+
+				if (!_mm256_testz_si256(error, error))
+				{
+					break;
+				}
+
+				previous = input;
+			}
+
+			// Every block before 'position' is valid. Either the block at 'position' has an error, or only a partial block is left
+			return FindInvalidUtf8Scalar(data, size, GetUtf8ResumePosition(data, position));
+		}
+		#endif // RAPIDIO_X86
+
+		/// <summary>
+		/// Calls 'func(position)' for every CR in [begin, end) of 'text' that is followed by a LF. The LF may lie past 'end', as long as it is in 'text'
+		/// </summary>
+		template<typename Func>
+		void ForEachCrlf(std::string_view text, size_t begin, size_t end, Func&& func)
+		{
+			const char carriageReturn[]{ '\r' };
+
+			for (size_t block = begin; block < end; block += ScanBlockSize)
+			{
+				uint64_t mask;
+				if (end - block >= ScanBlockSize)
+				{
+					MatchBytes(text.data() + block, carriageReturn, &mask);
+				}
+				else
+				{
+					MatchBytesPartial(text.data() + block, end - block, carriageReturn, &mask);
+				}
+
+				for (; mask != 0; mask &= mask - 1)
+				{
+					const size_t position = block + std::countr_zero(mask);
+					if (position + 1 < text.size() && text[position + 1] == '\n')
+					{
+						func(position);
+					}
+				}
+			}
+		}
+	} // namespace detail
+
+	inline namespace TextUtils
+	{
+		/// <summary>
+		/// Returns the offset of the first byte of 'text' that does not start a valid UTF-8 sequence, or std::string_view::npos if all of 'text' is valid.
+		/// A sequence cut off by the end of 'text' is invalid. Uses a SIMD lookup table validator on CPUs with AVX2
+		/// </summary>
+		size_t FindInvalidUtf8(std::string_view text)
+		{
+			const unsigned char* const data = reinterpret_cast<const unsigned char*>(text.data());
+
+			#ifdef RAPIDIO_X86
+			// AVX2 is detected through the copy-kernel CPUID probe
+			static const bool HasAVX2 = IsCopyKernelSupported(CopyKernel::AVX2);
+
+			const size_t invalid = HasAVX2 ? detail::FindInvalidUtf8AVX2(data, text.size()) : detail::FindInvalidUtf8Scalar(data, text.size(), 0);
+			#else
+			const size_t invalid = detail::FindInvalidUtf8Scalar(data, text.size(), 0);
+			#endif // RAPIDIO_X86
+
+			return invalid == text.size() ? std::string_view::npos : invalid;
+		}
+
+		/// <summary>
+		/// Returns the first offset at or after 'position' where 'text' can be split without splitting a UTF-8 sequence, assuming the sequence
+		/// that 'position' is part of is valid. Splitting at these offsets lets every part be validated on its own, with the same first invalid offset
+		/// </summary>
+		size_t GetUtf8SplitPosition(std::string_view text, size_t position)
+		{
+			const unsigned char* const data = reinterpret_cast<const unsigned char*>(text.data());
+
+			for (size_t back{ 1 }; back <= 3 && back <= position; ++back)
+			{
+				if (!detail::IsUtf8Continuation(data[position - back]))
+				{
+					return std::min(text.size(), std::max(position, position - back + detail::GetUtf8SequenceLength(data[position - back])));
+				}
+			}
+
+			return position;
+		}
+	} // inline namespace TextUtils
+} // namespace rapidio
@@ -0,0 +1,217 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace rapidio
+{
+	inline namespace ThreadUtils
+	{
+		/// <summary>
+		/// Resolves a requested number of threads. 0 means "use every hardware thread"
+		/// </summary>
+		size_t GetThreadCount(size_t requestedThreads)
+		{
+			if (requestedThreads > 0)
+			{
+				return requestedThreads;
+			}
+
+			return std::max<size_t>(1, std::thread::hardware_concurrency());
+		}
+
+		/// <summary>
+		/// Fixed set of worker threads that help callers run 'ParallelFor()' jobs, so parallel work does not pay for creating threads every time.
+		/// The calling thread always takes part in its own job, so a job finishes even if every worker is busy (e.g. with nested jobs)
+		/// </summary>
+		class ThreadPool final
+		{
+		public:
+			explicit ThreadPool(size_t nrOfWorkers);
+			~ThreadPool();
+
+			ThreadPool(const ThreadPool&) = delete;
+			ThreadPool& operator=(const ThreadPool&) = delete;
+
+			/// <summary>
+			/// Returns the pool shared by the library, it has a worker for every hardware thread except the calling one
+			/// </summary>
+			static ThreadPool& GetShared();
+
+			size_t GetNrOfWorkers() const;
+
+			/// <summary>
+			/// Calls 'func(taskIndex)' for every task in [0, nrOfTasks) on the calling thread and up to 'nrOfThreads - 1' workers.
+			/// Tasks are handed out one at a time, so uneven tasks are balanced automatically. Returns once every task has finished
+			/// </summary>
+			/// <param name="nrOfTasks">Number of tasks to run</param>
+			/// <param name="nrOfThreads">Maximum number of threads to use, including the calling thread. 0 means every hardware thread</param>
+			/// <param name="func">Callable taking a size_t task index</param>
+			template<typename Func>
+			void ParallelFor(size_t nrOfTasks, size_t nrOfThreads, Func&& func);
+
+		private:
+			struct Job
+			{
+				std::function<void(size_t)> func;
+				size_t nrOfTasks = 0;
+				size_t helpersWanted = 0; // Guarded by the pool mutex
+				std::atomic<size_t> nextTask{ 0 };
+				std::atomic<size_t> finishedTasks{ 0 };
+			};
+
+			void WorkerLoop();
+			void RunTasks(Job& job);
+
+			std::vector<std::thread> m_workers;
+			std::deque<std::shared_ptr<Job>> m_jobs;
+			std::mutex m_mutex;
+			std::condition_variable m_jobAvailable;
+			std::condition_variable m_jobFinished;
+			bool m_stopRequested = false;
+		};
+
+		ThreadPool::ThreadPool(size_t nrOfWorkers)
+		{
+			m_workers.reserve(nrOfWorkers);
+			for (size_t i{}; i < nrOfWorkers; ++i)
+			{
+				m_workers.emplace_back(&ThreadPool::WorkerLoop, this);
+			}
+		}
+
+		ThreadPool::~ThreadPool()
+		{
+			{
+				std::lock_guard lock(m_mutex);
+				m_stopRequested = true;
+			}
+
+			m_jobAvailable.notify_all();
+
+			for (std::thread& worker : m_workers)
+			{
+				worker.join();
+			}
+		}
+
+		ThreadPool& ThreadPool::GetShared()
+		{
+			static ThreadPool SharedPool{ GetThreadCount(0) - 1 };
+			return SharedPool;
+		}
+
+		size_t ThreadPool::GetNrOfWorkers() const
+		{
+			return m_workers.size();
+		}
+
+		template<typename Func>
+		void ThreadPool::ParallelFor(size_t nrOfTasks, size_t nrOfThreads, Func&& func)
+		{
+			const size_t nrOfHelpers = std::min({ GetThreadCount(nrOfThreads), nrOfTasks, m_workers.size() + 1 }) - (nrOfTasks > 0 ? 1 : 0);
+
+			if (nrOfHelpers == 0)
+			{
+				for (size_t i{}; i < nrOfTasks; ++i)
+				{
+					func(i);
+				}
+
+				return;
+			}
+
+			// 'func' lives on our stack, which is fine: workers only call it for tasks that finish before we return
+			std::shared_ptr<Job> job = std::make_shared<Job>();
+			job->func = [&func](size_t i) { func(i); };
+			job->nrOfTasks = nrOfTasks;
+			job->helpersWanted = nrOfHelpers;
+
+			{
+				std::lock_guard lock(m_mutex);
+				m_jobs.push_back(job);
+			}
+
+			if (nrOfHelpers == 1)
+			{
+				m_jobAvailable.notify_one();
+			}
+			else
+			{
+				m_jobAvailable.notify_all();
+			}
+
+			RunTasks(*job);
+
+			std::unique_lock lock(m_mutex);
+			m_jobFinished.wait(lock, [&job]() { return job->finishedTasks.load() == job->nrOfTasks; });
+
+			// Not every helper has to have shown up, make sure no late worker picks up the job anymore
+			if (job->helpersWanted > 0)
+			{
+				m_jobs.erase(std::remove(m_jobs.begin(), m_jobs.end(), job), m_jobs.end());
+			}
+		}
+
+		void ThreadPool::WorkerLoop()
+		{
+			while (true)
+			{
+				std::shared_ptr<Job> job;
+
+				{
+					std::unique_lock lock(m_mutex);
+					m_jobAvailable.wait(lock, [this]() { return !m_jobs.empty() || m_stopRequested; });
+
+					if (m_stopRequested)
+					{
+						return;
+					}
+
+					job = m_jobs.front();
+					if (--job->helpersWanted == 0)
+					{
+						m_jobs.pop_front();
+					}
+				}
+
+				RunTasks(*job);
+			}
+		}
+
+		void ThreadPool::RunTasks(Job& job)
+		{
+			for (size_t i = job.nextTask.fetch_add(1, std::memory_order_relaxed); i < job.nrOfTasks; i = job.nextTask.fetch_add(1, std::memory_order_relaxed))
+			{
+				job.func(i);
+
+				if (job.finishedTasks.fetch_add(1, std::memory_order_acq_rel) + 1 == job.nrOfTasks)
+				{
+					// Taking the lock makes sure the caller is either waiting already, or has not checked its condition yet
+					std::lock_guard lock(m_mutex);
+					m_jobFinished.notify_all();
+				}
+			}
+		}
+
+		/// <summary>
+		/// Calls 'func(taskIndex)' for every task in [0, nrOfTasks) on up to 'nrOfThreads' threads of the shared thread pool.
+		/// The calling thread takes part in the work. Tasks are handed out one at a time, so uneven tasks are balanced automatically
+		/// </summary>
+		/// <param name="nrOfTasks">Number of tasks to run</param>
+		/// <param name="nrOfThreads">Maximum number of threads to use, 0 means every hardware thread</param>
+		/// <param name="func">Callable taking a size_t task index</param>
+		template<typename Func>
+		void ParallelFor(size_t nrOfTasks, size_t nrOfThreads, Func&& func)
+		{
+			ThreadPool::GetShared().ParallelFor(nrOfTasks, nrOfThreads, std::forward<Func>(func));
+		}
+	} // inline namespace ThreadUtils
+} // namespace rapidio
@@ -0,0 +1,239 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#	define WIN32_LEAN_AND_MEAN
+#	include <Windows.h>
+#endif // _WIN32
+
+/// <summary>
+/// Records a trace event covering the rest of the enclosing scope, with the offset and size of the bytes it works on.
+/// Only compiled in when RAPIDIO_ENABLE_TRACING is defined, otherwise it expands to nothing and its arguments are never evaluated
+/// </summary>
+#ifdef RAPIDIO_ENABLE_TRACING
+#	define RAPIDIO_TRACE_CONCAT_IMPL(a, b) a##b
+#	define RAPIDIO_TRACE_CONCAT(a, b) RAPIDIO_TRACE_CONCAT_IMPL(a, b)
+#	define RAPIDIO_TRACE_SCOPE(name, offset, size) const ::rapidio::detail::TraceScope RAPIDIO_TRACE_CONCAT(rapidioTraceScope, __LINE__){ name, offset, size }
+#else
+#	define RAPIDIO_TRACE_SCOPE(name, offset, size)
+#endif // RAPIDIO_ENABLE_TRACING
+
+namespace rapidio
+{
+	namespace detail
+	{
+		struct TraceEvent final
+		{
+			const char* name = nullptr; // Must be a string literal, events only store the pointer
+			uint64_t start = 0; // Nanoseconds since the first traced event of the process
+			uint64_t duration = 0;
+			uint64_t offset = 0;
+			uint64_t size = 0;
+		};
+
+		/// <summary>
+		/// Events of a single thread. Only the owning thread appends, and publishes every event by bumping 'count',
+		/// so dumping the trace never has to stop or lock the thread. A full buffer drops new events instead of growing
+		/// </summary>
+		struct TraceBuffer final
+		{
+			static constexpr size_t Capacity = 1024 * 64;
+
+			std::unique_ptr<TraceEvent[]> events = std::make_unique<TraceEvent[]>(Capacity);
+			std::atomic<size_t> count{ 0 };
+			std::atomic<size_t> nrOfDropped{ 0 };
+			uint64_t threadId = 0;
+		};
+
+		/// <summary>
+		/// Owns the buffer of every thread that has recorded an event, so events of threads that have exited can still be dumped
+		/// </summary>
+		struct TraceRegistry final
+		{
+			std::mutex mutex;
+			std::vector<std::unique_ptr<TraceBuffer>> buffers;
+			const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+			static TraceRegistry& Get()
+			{
+				static TraceRegistry Registry;
+				return Registry;
+			}
+		};
+
+		uint64_t GetTraceThreadId()
+		{
+			#ifdef _WIN32
+			return GetCurrentThreadId();
+			#else
+			return std::hash<std::thread::id>{}(std::this_thread::get_id());
+			#endif // _WIN32
+		}
+
+		uint64_t GetTraceProcessId()
+		{
+			#ifdef _WIN32
+			return GetCurrentProcessId();
+			#else
+			return 0;
+			#endif // _WIN32
+		}
+
+		uint64_t GetTraceTimestamp()
+		{
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - TraceRegistry::Get().epoch).count();
+		}
+
+		// The lock is only taken the first time a thread records an event
+		TraceBuffer& GetThreadTraceBuffer()
+		{
+			thread_local TraceBuffer* Buffer = []()
+				{
+					TraceRegistry& registry = TraceRegistry::Get();
+
+					std::unique_ptr<TraceBuffer> buffer = std::make_unique<TraceBuffer>();
+					buffer->threadId = GetTraceThreadId();
+
+					std::lock_guard lock(registry.mutex);
+					return registry.buffers.emplace_back(std::move(buffer)).get();
+				}();
+
+			return *Buffer;
+		}
+
+		class TraceScope final
+		{
+		public:
+			TraceScope(const char* name, uint64_t offset, uint64_t size)
+				: m_name(name)
+				, m_offset(offset)
+				, m_size(size)
+				, m_start(GetTraceTimestamp())
+			{
+			}
+
+			~TraceScope()
+			{
+				TraceBuffer& buffer = GetThreadTraceBuffer();
+				const size_t index = buffer.count.load(std::memory_order_relaxed);
+
+				if (index == TraceBuffer::Capacity)
+				{
+					buffer.nrOfDropped.fetch_add(1, std::memory_order_relaxed);
+					return;
+				}
+
+				buffer.events[index] = TraceEvent{ m_name, m_start, GetTraceTimestamp() - m_start, m_offset, m_size };
+				buffer.count.store(index + 1, std::memory_order_release);
+			}
+
+			TraceScope(const TraceScope&) = delete;
+			TraceScope& operator=(const TraceScope&) = delete;
+
+		private:
+			const char* m_name;
+			uint64_t m_offset;
+			uint64_t m_size;
+			uint64_t m_start;
+		};
+	} // namespace detail
+
+	inline namespace TraceUtils
+	{
+		/// <summary>
+		/// Returns whether rapidio was compiled with RAPIDIO_ENABLE_TRACING
+		/// </summary>
+		constexpr bool IsTracingEnabled()
+		{
+			#ifdef RAPIDIO_ENABLE_TRACING
+			return true;
+			#else
+			return false;
+			#endif // RAPIDIO_ENABLE_TRACING
+		}
+
+		/// <summary>
+		/// Writes every event recorded so far as Chrome trace-event JSON, which can be opened in Perfetto or chrome://tracing.
+		/// Threads may keep recording while the trace is written, their newest events are then left out
+		/// </summary>
+		/// <param name="filepath">Path to the trace file. An existing file is overwritten</param>
+		/// <returns>Returns false if tracing is not compiled in or the file could not be written</returns>
+		bool DumpTrace(const std::filesystem::path& filepath)
+		{
+			if (!IsTracingEnabled())
+			{
+				std::cerr << "DumpTrace > Tracing is disabled, define RAPIDIO_ENABLE_TRACING to record events\n";
+				return false;
+			}
+
+			std::ofstream file(filepath, std::ios::binary | std::ios::trunc);
+			if (!file)
+			{
+				std::cerr << "DumpTrace > Could not open " << filepath << "\n";
+				return false;
+			}
+
+			detail::TraceRegistry& registry = detail::TraceRegistry::Get();
+			const uint64_t processId = detail::GetTraceProcessId();
+
+			file << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+			bool isFirst = true;
+			std::lock_guard lock(registry.mutex);
+
+			for (const std::unique_ptr<detail::TraceBuffer>& buffer : registry.buffers)
+			{
+				const size_t count = buffer->count.load(std::memory_order_acquire);
+
+				for (size_t i{}; i < count; ++i)
+				{
+					const detail::TraceEvent& event = buffer->events[i];
+
+					// Timestamps are in microseconds, the fraction keeps nanosecond precision
+					file << (isFirst ? "\n" : ",\n") << "{\"name\":\"" << event.name << "\",\"cat\":\"rapidio\",\"ph\":\"X\""
+						<< ",\"ts\":" << event.start / 1000 << "." << std::setw(3) << std::setfill('0') << event.start % 1000
+						<< ",\"dur\":" << event.duration / 1000 << "." << std::setw(3) << std::setfill('0') << event.duration % 1000
+						<< ",\"pid\":" << processId << ",\"tid\":" << buffer->threadId
+						<< ",\"args\":{\"offset\":" << event.offset << ",\"size\":" << event.size << "}}";
+
+					isFirst = false;
+				}
+
+				if (const size_t nrOfDropped = buffer->nrOfDropped.load(std::memory_order_relaxed); nrOfDropped > 0)
+				{
+					std::cerr << "DumpTrace > Thread " << buffer->threadId << " dropped " << nrOfDropped << " events\n";
+				}
+			}
+
+			file << "\n]}\n";
+			return static_cast<bool>(file);
+		}
+
+		/// <summary>
+		/// Throws away every recorded event. Must not be called while other threads are recording events
+		/// </summary>
+		void ClearTrace()
+		{
+			detail::TraceRegistry& registry = detail::TraceRegistry::Get();
+			std::lock_guard lock(registry.mutex);
+
+			for (const std::unique_ptr<detail::TraceBuffer>& buffer : registry.buffers)
+			{
+				buffer->count.store(0, std::memory_order_relaxed);
+				buffer->nrOfDropped.store(0, std::memory_order_relaxed);
+			}
+		}
+	} // inline namespace TraceUtils
+} // namespace rapidio
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <concepts>
+#include <iostream>
+#include <utility>
+
+#ifndef _WIN32
+#	include <sys/mman.h>
+#	include <unistd.h>
+#endif // !_WIN32
+
+namespace rapidio
+{
+	/// <summary>
+	/// Requirements for the traits of a UniqueHandle
+	/// T must have a ValueType, the type of the wrapped handle
+	/// T must have a static Invalid() returning the sentinel value of an empty handle
+	/// T must have a static IsValid() returning whether a value refers to an open handle
+	/// T must have a static Close() closing a valid handle, returning false on failure
+	/// </summary>
+	template<typename T>
+	concept IsHandleTraits = requires (typename T::ValueType value)
+	{
+		{ T::Invalid() } -> std::same_as<typename T::ValueType>;
+		{ T::IsValid(value) } -> std::same_as<bool>;
+		{ T::Close(value) } -> std::same_as<bool>;
+	};
+
+	/// <summary>
+	/// Move-only owner of a handle that is closed when the UniqueHandle goes out of scope. How a handle is closed is known at compile time,
+	/// so a UniqueHandle is exactly as big as the handle it wraps and closing it is a direct call
+	/// </summary>
+	template<IsHandleTraits Traits>
+	class UniqueHandle final
+	{
+	public:
+		using ValueType = typename Traits::ValueType;
+
+		UniqueHandle() noexcept;
+		explicit UniqueHandle(ValueType value) noexcept;
+		~UniqueHandle();
+
+		UniqueHandle(const UniqueHandle&) = delete;
+		UniqueHandle(UniqueHandle&& other) noexcept;
+		UniqueHandle& operator=(const UniqueHandle&) = delete;
+		UniqueHandle& operator=(UniqueHandle&& other) noexcept;
+
+		bool IsValid() const;
+		ValueType Get() const;
+
+		// Closes the handle
+		void Release();
+
+		// Gives up ownership of the handle without closing it
+		ValueType Detach();
+
+	private:
+		ValueType m_value;
+	};
+
+	template<IsHandleTraits Traits>
+	UniqueHandle<Traits>::UniqueHandle() noexcept
+		: m_value{ Traits::Invalid() }
+	{
+	}
+
+	template<IsHandleTraits Traits>
+	UniqueHandle<Traits>::UniqueHandle(ValueType value) noexcept
+		: m_value{ value }
+	{
+	}
+
+	template<IsHandleTraits Traits>
+	UniqueHandle<Traits>::~UniqueHandle()
+	{
+		Release();
+	}
+
+	template<IsHandleTraits Traits>
+	UniqueHandle<Traits>::UniqueHandle(UniqueHandle&& other) noexcept
+		: m_value{ other.Detach() }
+	{
+	}
+
+	template<IsHandleTraits Traits>
+	UniqueHandle<Traits>& UniqueHandle<Traits>::operator=(UniqueHandle&& other) noexcept
+	{
+		if (this != &other)
+		{
+			Release();
+			m_value = other.Detach();
+		}
+
+		return *this;
+	}
+
+	template<IsHandleTraits Traits>
+	bool UniqueHandle<Traits>::IsValid() const
+	{
+		return Traits::IsValid(m_value);
+	}
+
+	template<IsHandleTraits Traits>
+	typename UniqueHandle<Traits>::ValueType UniqueHandle<Traits>::Get() const
+	{
+		return m_value;
+	}
+
+	template<IsHandleTraits Traits>
+	void UniqueHandle<Traits>::Release()
+	{
+		if (Traits::IsValid(m_value) && !Traits::Close(m_value))
+		{
+			std::cerr << "UniqueHandle > Handle could not be closed\n";
+		}
+
+		m_value = Traits::Invalid();
+	}
+
+	template<IsHandleTraits Traits>
+	typename UniqueHandle<Traits>::ValueType UniqueHandle<Traits>::Detach()
+	{
+		return std::exchange(m_value, Traits::Invalid());
+	}
+
+	#ifndef _WIN32
+	inline namespace PosixUtils
+	{
+		struct FileDescriptorTraits
+		{
+			using ValueType = int;
+
+			static constexpr ValueType Invalid() { return -1; }
+			static bool IsValid(ValueType fd) { return fd >= 0; }
+			static bool Close(ValueType fd) { return ::close(fd) == 0; }
+		};
+
+		// munmap() needs the length of the region, so a mapped region is a pointer and a size
+		struct MappedRegion
+		{
+			void* data = nullptr;
+			size_t size = 0;
+
+			bool operator==(const MappedRegion&) const = default;
+		};
+
+		struct MappedRegionTraits
+		{
+			using ValueType = MappedRegion;
+
+			static constexpr ValueType Invalid() { return {}; }
+			static bool IsValid(const ValueType& region) { return region.data != nullptr && region.data != MAP_FAILED; }
+			static bool Close(const ValueType& region) { return ::munmap(region.data, region.size) == 0; }
+		};
+
+		using FileDescriptor = UniqueHandle<FileDescriptorTraits>;
+		using MappedRegionHandle = UniqueHandle<MappedRegionTraits>;
+
+		static_assert(sizeof(FileDescriptor) == sizeof(int));
+		static_assert(sizeof(MappedRegionHandle) == sizeof(MappedRegion));
+	} // inline namespace PosixUtils
+	#endif // !_WIN32
+} // namespace rapidio
@@ -0,0 +1,187 @@
+#pragma once
+
+#include "rapidio.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace rapidio
+{
+	namespace detail
+	{
+		/// <summary>
+		/// A mapped window of a file. Windows are allocated once and recycled, so a pointer to one stays valid for the lifetime of the cache.
+		/// While mapped, the cache holds one reference and every pin holds another. A window is only evicted when the cache holds the last one
+		/// </summary>
+		struct CachedWindow final
+		{
+			static constexpr uint64_t EmptyKey = ~0ull;
+
+			std::atomic<uint64_t> key{ EmptyKey };
+			std::atomic<uint32_t> nrOfReferences{ 0 };
+			std::atomic<bool> isRecentlyUsed{ false };
+
+			// Written before the window is published by storing 'nrOfReferences', read only while holding a reference
+			const char* data = nullptr;
+			size_t size = 0;
+
+			#ifdef _WIN32
+			Win32MappedView view;
+			#endif // _WIN32
+
+			// Fails if the window is not mapped, or is being evicted
+			bool TryAcquire();
+			void ReleaseReference();
+		};
+
+		struct CachedFile final
+		{
+			std::filesystem::path filepath;
+			std::optional<size_t> fileSize; // Known once the file has been opened once, files are expected not to change
+
+			#ifdef _WIN32
+			Win32Handle fileHandle;
+			Win32Handle fileMappingHandle;
+			#endif // _WIN32
+
+			std::list<uint32_t>::iterator openFilesPosition; // Position in the LRU list of open files, if open
+			bool isOpen = false;
+		};
+	} // namespace detail
+
+	/// <summary>
+	/// Read-only cache of mapped windows over many large files, for random reads across more files than can be kept open or mapped at once.
+	/// Windows are keyed by (file, window-aligned offset) and live in sets of a few windows each, every set being a small shard with its own lock
+	/// and CLOCK replacement (an approximation of LRU that does not need a list update on every hit). Finding a window that is already mapped
+	/// only touches atomics. The number of open files and the total number of mapped bytes are bounded, windows are evicted to stay under the budget.
+	/// All member functions are thread-safe
+	/// </summary>
+	class WindowCache final
+	{
+	public:
+		struct Options
+		{
+			// Size of every window, rounded up to the system allocation granularity. The last window of a file can be smaller
+			size_t windowSize = 1024 * 1024 * 64; // 64 MB
+
+			// Maximum number of bytes mapped at once, over every window of every file
+			size_t maxMappedBytes = 1024ull * 1024 * 1024 * 4; // 4 GB
+
+			// Maximum number of windows mapped at once, rounded up to a multiple of the number of windows in a set
+			size_t maxWindows = 1024;
+
+			// Maximum number of files kept open. Closing a file does not unmap its windows
+			size_t maxOpenFiles = 256;
+		};
+
+		/// <summary>
+		/// Keeps a window mapped for as long as it lives. Move-only
+		/// </summary>
+		class PinnedWindow final
+		{
+		public:
+			PinnedWindow() = default;
+			~PinnedWindow();
+
+			PinnedWindow(const PinnedWindow&) = delete;
+			PinnedWindow(PinnedWindow&& other) noexcept;
+			PinnedWindow& operator=(const PinnedWindow&) = delete;
+			PinnedWindow& operator=(PinnedWindow&& other) noexcept;
+
+			bool IsValid() const;
+
+			// Returns the bytes of the window
+			std::string_view GetData() const;
+
+			// Returns the offset (from start of file) of the first byte of the window
+			size_t GetOffset() const;
+
+		private:
+			friend class WindowCache;
+
+			PinnedWindow(detail::CachedWindow* window, size_t offset);
+
+			detail::CachedWindow* m_window = nullptr;
+			size_t m_offset = 0;
+		};
+
+		WindowCache();
+		explicit WindowCache(Options options);
+
+		// Every PinnedWindow must be destroyed before the cache
+		~WindowCache() = default;
+
+		WindowCache(const WindowCache&) = delete;
+		WindowCache& operator=(const WindowCache&) = delete;
+
+		/// <summary>
+		/// Registers a file with the cache. The file is only opened when one of its windows is first pinned
+		/// </summary>
+		/// <returns>Id to pin windows of the file with. std::nullopt if the file does not exist</returns>
+		std::optional<uint32_t> AddFile(const std::filesystem::path& filepath);
+
+		/// <summary>
+		/// Returns the window containing 'offset', mapping it if it is not mapped yet
+		/// </summary>
+		/// <param name="fileId">Id returned by 'AddFile()'</param>
+		/// <param name="offset">Offset (from start of file) the window has to contain</param>
+		/// <returns>An invalid PinnedWindow if 'offset' is past EOF, the file could not be mapped, or every window that could be evicted is pinned</returns>
+		PinnedWindow Pin(uint32_t fileId, size_t offset);
+
+		/// <summary>
+		/// Copies 'size' bytes at 'offset' into 'buffer', pinning every window the bytes span
+		/// </summary>
+		/// <returns>Returns true if every byte was copied. Reading past EOF fails</returns>
+		bool Read(uint32_t fileId, size_t offset, void* buffer, size_t size);
+
+		// Returns the size of a file, opening it if it has never been opened before
+		std::optional<size_t> GetFileSize(uint32_t fileId);
+
+		size_t GetWindowSize() const;
+		size_t GetMappedBytes() const;
+		size_t GetNrOfOpenFiles() const;
+
+	private:
+		static constexpr size_t NrOfWindowsPerSet = 8;
+
+		// Window indices are stored in the lower bits of a key, file ids in the upper ones
+		static constexpr int WindowIndexBits = 40;
+
+		struct WindowSet
+		{
+			std::array<detail::CachedWindow, NrOfWindowsPerSet> windows;
+			std::mutex mutex; // Taken to map or evict windows, never to find them
+			size_t clockHand = 0;
+		};
+
+		WindowSet& GetSet(uint64_t key);
+		detail::CachedWindow* Find(WindowSet& set, uint64_t key);
+		detail::CachedWindow* MapWindow(WindowSet& set, uint32_t fileId, uint64_t key, size_t windowOffset);
+		detail::CachedWindow* FindVictim(WindowSet& set);
+		bool MakeRoom(size_t size, const WindowSet& lockedSet);
+		bool TryEvict(detail::CachedWindow& window);
+		detail::CachedFile* OpenFile(uint32_t fileId);
+
+		Options m_options;
+		std::unique_ptr<WindowSet[]> m_sets;
+		size_t m_nrOfSets;
+		std::atomic<size_t> m_mappedBytes{ 0 };
+		std::atomic<size_t> m_evictionHand{ 0 }; // Sweeps over every window when the mapped bytes budget is exceeded
+
+		mutable std::mutex m_filesMutex;
+		std::vector<std::unique_ptr<detail::CachedFile>> m_files;
+		std::list<uint32_t> m_openFiles; // Most recently used first
+	};
+} // namespace rapidio
+
+#ifdef _WIN32
+#	include "WindowCacheWin32.hpp"
+#endif // _WIN32
@@ -0,0 +1,470 @@
+#pragma once
+
+#include "Win32Call.hpp"
+#include "Win32Handle.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace rapidio
+{
+	namespace detail
+	{
+		bool CachedWindow::TryAcquire()
+		{
+			uint32_t nrOfReferencesHeld = nrOfReferences.load(std::memory_order_relaxed);
+			while (nrOfReferencesHeld != 0)
+			{
+				if (nrOfReferences.compare_exchange_weak(nrOfReferencesHeld, nrOfReferencesHeld + 1, std::memory_order_acquire, std::memory_order_relaxed))
+				{
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		void CachedWindow::ReleaseReference()
+		{
+			nrOfReferences.fetch_sub(1, std::memory_order_release);
+		}
+	} // namespace detail
+
+	WindowCache::PinnedWindow::PinnedWindow(detail::CachedWindow* window, size_t offset)
+		: m_window(window)
+		, m_offset(offset)
+	{
+	}
+
+	WindowCache::PinnedWindow::~PinnedWindow()
+	{
+		if (m_window)
+		{
+			m_window->ReleaseReference();
+		}
+	}
+
+	WindowCache::PinnedWindow::PinnedWindow(PinnedWindow&& other) noexcept
+		: m_window(std::exchange(other.m_window, nullptr))
+		, m_offset(other.m_offset)
+	{
+	}
+
+	WindowCache::PinnedWindow& WindowCache::PinnedWindow::operator=(PinnedWindow&& other) noexcept
+	{
+		if (this != &other)
+		{
+			if (m_window)
+			{
+				m_window->ReleaseReference();
+			}
+
+			m_window = std::exchange(other.m_window, nullptr);
+			m_offset = other.m_offset;
+		}
+
+		return *this;
+	}
+
+	bool WindowCache::PinnedWindow::IsValid() const
+	{
+		return m_window != nullptr;
+	}
+
+	std::string_view WindowCache::PinnedWindow::GetData() const
+	{
+		return m_window ? std::string_view{ m_window->data, m_window->size } : std::string_view{};
+	}
+
+	size_t WindowCache::PinnedWindow::GetOffset() const
+	{
+		return m_offset;
+	}
+
+	WindowCache::WindowCache()
+		: WindowCache(Options{})
+	{
+	}
+
+	WindowCache::WindowCache(Options options)
+		: m_options(options)
+	{
+		// Windows are mapped at offsets that are a multiple of their size, which MapViewOfFile() requires to be a multiple of the allocation granularity
+		const size_t allocationGranularity = FileView::GetSystemAllocationGranularity();
+		m_options.windowSize = std::max<size_t>(1, (m_options.windowSize + allocationGranularity - 1) / allocationGranularity) * allocationGranularity;
+
+		m_nrOfSets = std::max<size_t>(1, (m_options.maxWindows + NrOfWindowsPerSet - 1) / NrOfWindowsPerSet);
+		m_options.maxWindows = m_nrOfSets * NrOfWindowsPerSet;
+		m_options.maxOpenFiles = std::max<size_t>(1, m_options.maxOpenFiles);
+
+		m_sets = std::make_unique<WindowSet[]>(m_nrOfSets);
+	}
+
+	std::optional<uint32_t> WindowCache::AddFile(const std::filesystem::path& filepath)
+	{
+		if (!PathUtils::DoesFileExist(filepath))
+		{
+			std::cerr << "WindowCache::AddFile > File " << filepath << " does not exist\n";
+			return std::nullopt;
+		}
+
+		std::lock_guard lock(m_filesMutex);
+
+		if (m_files.size() == 1ull << (64 - WindowIndexBits))
+		{
+			std::cerr << "WindowCache::AddFile > Too many files\n";
+			return std::nullopt;
+		}
+
+		std::unique_ptr<detail::CachedFile> file = std::make_unique<detail::CachedFile>();
+		file->filepath = filepath;
+		m_files.push_back(std::move(file));
+
+		return static_cast<uint32_t>(m_files.size() - 1);
+	}
+
+	WindowCache::PinnedWindow WindowCache::Pin(uint32_t fileId, size_t offset)
+	{
+		const size_t windowOffset = offset / m_options.windowSize * m_options.windowSize;
+		const uint64_t key = (static_cast<uint64_t>(fileId) << WindowIndexBits) | (offset / m_options.windowSize);
+
+		WindowSet& set = GetSet(key);
+		detail::CachedWindow* window = Find(set, key);
+
+		if (!window)
+		{
+			std::lock_guard lock(set.mutex);
+
+			// Another thread might have mapped the window while we were waiting for the lock
+			window = Find(set, key);
+			if (!window)
+			{
+				window = MapWindow(set, fileId, key, windowOffset);
+			}
+		}
+
+		PinnedWindow pinnedWindow{ window, windowOffset };
+
+		// The last window of a file is smaller than the others
+		if (window && offset - windowOffset >= window->size)
+		{
+			return {};
+		}
+
+		return pinnedWindow;
+	}
+
+	bool WindowCache::Read(uint32_t fileId, size_t offset, void* buffer, size_t size)
+	{
+		char* destination = static_cast<char*>(buffer);
+
+		while (size > 0)
+		{
+			const PinnedWindow window = Pin(fileId, offset);
+			if (!window.IsValid())
+			{
+				return false;
+			}
+
+			const std::string_view data = window.GetData().substr(offset - window.GetOffset());
+			const size_t bytesToCopy = std::min(size, data.size());
+
+			std::memcpy(destination, data.data(), bytesToCopy);
+			destination += bytesToCopy;
+			offset += bytesToCopy;
+			size -= bytesToCopy;
+		}
+
+		return true;
+	}
+
+	std::optional<size_t> WindowCache::GetFileSize(uint32_t fileId)
+	{
+		std::lock_guard lock(m_filesMutex);
+
+		if (fileId < m_files.size() && m_files[fileId]->fileSize)
+		{
+			return m_files[fileId]->fileSize;
+		}
+
+		const detail::CachedFile* file = OpenFile(fileId);
+		return file ? file->fileSize : std::nullopt;
+	}
+
+	size_t WindowCache::GetWindowSize() const
+	{
+		return m_options.windowSize;
+	}
+
+	size_t WindowCache::GetMappedBytes() const
+	{
+		return m_mappedBytes.load(std::memory_order_relaxed);
+	}
+
+	size_t WindowCache::GetNrOfOpenFiles() const
+	{
+		std::lock_guard lock(m_filesMutex);
+		return m_openFiles.size();
+	}
+
+	WindowCache::WindowSet& WindowCache::GetSet(uint64_t key)
+	{
+		// Consecutive windows of a file must not end up in the same set
+		key = (key ^ (key >> 30)) * 0xBF58476D1CE4E5B9ull;
+		key = (key ^ (key >> 27)) * 0x94D049BB133111EBull;
+		return m_sets[(key ^ (key >> 31)) % m_nrOfSets];
+	}
+
+	detail::CachedWindow* WindowCache::Find(WindowSet& set, uint64_t key)
+	{
+		for (detail::CachedWindow& window : set.windows)
+		{
+			// The key is checked again once the window is pinned, it could have been evicted and re-used in between
+			if (window.key.load(std::memory_order_relaxed) != key || !window.TryAcquire())
+			{
+				continue;
+			}
+
+			if (window.key.load(std::memory_order_relaxed) == key)
+			{
+				// Only written if not set yet, so hits on a hot window do not keep invalidating its cache line on other cores
+				if (!window.isRecentlyUsed.load(std::memory_order_relaxed))
+				{
+					window.isRecentlyUsed.store(true, std::memory_order_relaxed);
+				}
+
+				return &window;
+			}
+
+			window.ReleaseReference();
+		}
+
+		return nullptr;
+	}
+
+	detail::CachedWindow* WindowCache::MapWindow(WindowSet& set, uint32_t fileId, uint64_t key, size_t windowOffset)
+	{
+		std::lock_guard lock(m_filesMutex);
+
+		const detail::CachedFile* file = OpenFile(fileId);
+		if (!file || windowOffset >= *file->fileSize)
+		{
+			return nullptr;
+		}
+
+		detail::CachedWindow* window = FindVictim(set);
+		if (!window)
+		{
+			std::cerr << "WindowCache::Pin > Every window that could hold this one is pinned\n";
+			return nullptr;
+		}
+
+		const size_t size = std::min(m_options.windowSize, *file->fileSize - windowOffset);
+		if (!MakeRoom(size, set))
+		{
+			std::cerr << "WindowCache::Pin > Cannot map " << size << " more bytes, every window that could be evicted is pinned\n";
+			return nullptr;
+		}
+
+		window->view = Win32MappedView{ CALL_WIN32_RV
+		(
+			MapViewOfFile
+			(
+				file->fileMappingHandle.Get(),
+				FILE_MAP_READ,
+				static_cast<DWORD>(static_cast<uint64_t>(windowOffset) >> 32),
+				static_cast<DWORD>(windowOffset),
+				size
+			)
+		) };
+
+		if (!window->view.IsValid())
+		{
+			m_mappedBytes.fetch_sub(size, std::memory_order_relaxed);
+			return nullptr;
+		}
+
+		window->data = static_cast<const char*>(window->view.Get());
+		window->size = size;
+		window->isRecentlyUsed.store(true, std::memory_order_relaxed);
+		window->key.store(key, std::memory_order_relaxed);
+
+		// Publishes the window: one reference for the cache, one for the caller
+		window->nrOfReferences.store(2, std::memory_order_release);
+		return window;
+	}
+
+	detail::CachedWindow* WindowCache::FindVictim(WindowSet& set)
+	{
+		for (detail::CachedWindow& window : set.windows)
+		{
+			if (window.nrOfReferences.load(std::memory_order_acquire) == 0)
+			{
+				return &window;
+			}
+		}
+
+		// Recently used windows get a second chance. Hits keep marking windows as used while we sweep, so the last round ignores the mark
+		for (size_t i{}; i < NrOfWindowsPerSet * 3; ++i)
+		{
+			detail::CachedWindow& window = set.windows[set.clockHand];
+			set.clockHand = (set.clockHand + 1) % NrOfWindowsPerSet;
+
+			const bool isSecondChance = i < NrOfWindowsPerSet * 2 && window.isRecentlyUsed.exchange(false, std::memory_order_relaxed);
+			if (!isSecondChance && TryEvict(window))
+			{
+				return &window;
+			}
+		}
+
+		return nullptr;
+	}
+
+	bool WindowCache::MakeRoom(size_t size, const WindowSet& lockedSet)
+	{
+		if (size > m_options.maxMappedBytes)
+		{
+			return false;
+		}
+
+		const size_t nrOfWindows = m_nrOfSets * NrOfWindowsPerSet;
+		size_t mappedBytes = m_mappedBytes.load(std::memory_order_relaxed);
+
+		for (size_t nrOfVisited{}; ;)
+		{
+			// Reserve the bytes before mapping, so concurrent misses in other sets can not overshoot the budget together
+			if (mappedBytes + size <= m_options.maxMappedBytes)
+			{
+				if (m_mappedBytes.compare_exchange_weak(mappedBytes, mappedBytes + size, std::memory_order_relaxed))
+				{
+					return true;
+				}
+
+				continue;
+			}
+
+			// Sweep over every window of every set, with the same second chance as within a set
+			if (nrOfVisited == nrOfWindows * 3)
+			{
+				return false;
+			}
+
+			const bool isSecondChanceRound = nrOfVisited++ < nrOfWindows * 2;
+			const size_t position = m_evictionHand.fetch_add(1, std::memory_order_relaxed) % nrOfWindows;
+			WindowSet& set = m_sets[position / NrOfWindowsPerSet];
+			detail::CachedWindow& window = set.windows[position % NrOfWindowsPerSet];
+
+			if (window.nrOfReferences.load(std::memory_order_relaxed) == 1 &&
+				!(isSecondChanceRound && window.isRecentlyUsed.exchange(false, std::memory_order_relaxed)))
+			{
+				// Sets are only ever locked one after the other, a set that is busy is skipped instead of waited for
+				if (&set == &lockedSet)
+				{
+					TryEvict(window);
+				}
+				else if (std::unique_lock lock(set.mutex, std::try_to_lock); lock.owns_lock())
+				{
+					TryEvict(window);
+				}
+			}
+
+			mappedBytes = m_mappedBytes.load(std::memory_order_relaxed);
+		}
+	}
+
+	bool WindowCache::TryEvict(detail::CachedWindow& window)
+	{
+		// Only succeeds if the cache holds the last reference, after which the window can no longer be pinned
+		uint32_t expected = 1;
+		if (!window.nrOfReferences.compare_exchange_strong(expected, 0, std::memory_order_acquire, std::memory_order_relaxed))
+		{
+			return false;
+		}
+
+		window.key.store(detail::CachedWindow::EmptyKey, std::memory_order_relaxed);
+		window.view.Release();
+		m_mappedBytes.fetch_sub(window.size, std::memory_order_relaxed);
+
+		window.data = nullptr;
+		window.size = 0;
+		return true;
+	}
+
+	detail::CachedFile* WindowCache::OpenFile(uint32_t fileId)
+	{
+		if (fileId >= m_files.size())
+		{
+			std::cerr << "WindowCache > Unknown file id " << fileId << "\n";
+			return nullptr;
+		}
+
+		detail::CachedFile& file = *m_files[fileId];
+		if (file.isOpen)
+		{
+			m_openFiles.splice(m_openFiles.begin(), m_openFiles, file.openFilesPosition);
+			return &file;
+		}
+
+		// Mapped windows keep their file alive, so the least recently used file can be closed without touching its windows
+		if (m_openFiles.size() >= m_options.maxOpenFiles)
+		{
+			detail::CachedFile& leastRecentlyUsed = *m_files[m_openFiles.back()];
+			leastRecentlyUsed.fileMappingHandle.Release();
+			leastRecentlyUsed.fileHandle.Release();
+			leastRecentlyUsed.isOpen = false;
+			m_openFiles.pop_back();
+		}
+
+		file.fileHandle = Win32Handle{ CALL_WIN32_RV
+		(
+			CreateFileA
+			(
+				file.filepath.string().c_str(),
+				GENERIC_READ,
+				FILE_SHARE_READ,
+				nullptr,
+				OPEN_EXISTING,
+				FILE_ATTRIBUTE_NORMAL,
+				nullptr
+			)
+		) };
+
+		if (!file.fileHandle.IsValid())
+		{
+			std::cerr << "WindowCache > Could not open " << file.filepath << "\n";
+			return nullptr;
+		}
+
+		if (!file.fileSize)
+		{
+			LARGE_INTEGER fileSize{};
+			if (CALL_WIN32_RV(GetFileSizeEx(file.fileHandle.Get(), &fileSize)) == 0)
+			{
+				file.fileHandle.Release();
+				return nullptr;
+			}
+
+			file.fileSize = static_cast<size_t>(fileSize.QuadPart);
+		}
+
+		// An empty file can not be mapped, but has no windows either
+		if (*file.fileSize > 0)
+		{
+			file.fileMappingHandle = Win32Handle{ CALL_WIN32_RV(CreateFileMappingA(file.fileHandle.Get(), nullptr, PAGE_READONLY, 0, 0, nullptr)) };
+
+			if (!file.fileMappingHandle.IsValid())
+			{
+				std::cerr << "WindowCache > Could not map " << file.filepath << "\n";
+				file.fileHandle.Release();
+				return nullptr;
+			}
+		}
+
+		m_openFiles.push_front(fileId);
+		file.openFilesPosition = m_openFiles.begin();
+		file.isOpen = true;
+
+		return &file;
+	}
+} // namespace rapidio
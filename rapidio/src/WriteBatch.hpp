@@ -0,0 +1,247 @@
+#pragma once
+
+#include "rapidio.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <vector>
+
+namespace rapidio
+{
+	/// <summary>
+	/// Collects many small writes and commits them to a FileView in one go. On commit the writes are sorted by offset and adjacent or
+	/// overlapping writes are merged, so the file is grown at most once and every merged range is copied with a single memcpy.
+	/// Overlapping writes are resolved in the order they were added, the last one wins. The batch owns a copy of the added data
+	/// </summary>
+	class WriteBatch final
+	{
+	public:
+		/// <summary>
+		/// Adds a write of 'data' at 'offset' (from start of the mapped view) to the batch. The data is copied into the batch
+		/// </summary>
+		template<IsBufferLike T>
+		void Add(const T& data, size_t offset);
+		void Add(const void* data, size_t size, size_t offset);
+
+		/// <summary>
+		/// Commits every write in the batch to 'view' and clears the batch.
+		/// </summary>
+		/// <param name="view">View to write to. It is grown at most once to fit the furthest write</param>
+		/// <param name="flushTouchedPages">If set to true, only the pages touched by this batch are flushed to the file afterwards, see FileView::Flush</param>
+		/// <param name="nrOfThreads">Number of threads to copy large batches with, 0 means every hardware thread</param>
+		/// <returns>Returns true if every write was applied and flushed. If false is returned, the batch is kept so it can be committed again,
+		/// but if only flushing failed, the writes have already been applied to 'view'</returns>
+		bool Commit(FileView& view, bool flushTouchedPages = false, size_t nrOfThreads = 1);
+
+		/// <summary>
+		/// Returns the sorted, merged ranges this batch would write. The buffers are valid until the batch is changed
+		/// </summary>
+		const std::vector<ConstIoRange>& GetCoalescedRanges();
+
+		// Returns the number of writes added since the last commit
+		size_t GetNrOfWrites() const;
+
+		// Returns true if no writes were added since the last commit
+		bool IsEmpty() const;
+
+		void Clear();
+
+	private:
+		struct Entry
+		{
+			size_t offset;
+			size_t size;
+			size_t dataOffset; // Offset of the data inside 'm_data'
+		};
+
+		void Coalesce();
+
+		std::vector<Entry> m_entries;
+		std::vector<char> m_data;
+
+		// Cached result of 'Coalesce()', merged ranges spanning more than one write point into 'm_mergedData'
+		std::vector<ConstIoRange> m_coalesced;
+		std::vector<char> m_mergedData;
+		bool m_isCoalesced = false;
+	};
+
+	template<IsBufferLike T>
+	void WriteBatch::Add(const T& data, size_t offset)
+	{
+		Add(static_cast<const void*>(data.data()), data.size(), offset);
+	}
+
+	void WriteBatch::Add(const void* data, size_t size, size_t offset)
+	{
+		if (size == 0)
+		{
+			return;
+		}
+
+		m_entries.push_back({ offset, size, m_data.size() });
+		m_data.insert(m_data.end(), static_cast<const char*>(data), static_cast<const char*>(data) + size);
+		m_isCoalesced = false;
+	}
+
+	bool WriteBatch::Commit(FileView& view, bool flushTouchedPages /* = false */, size_t nrOfThreads /* = 1 */)
+	{
+		if (m_entries.empty())
+		{
+			return true;
+		}
+
+		Coalesce();
+
+		if (!view.WriteV(m_coalesced, true, true, nrOfThreads))
+		{
+			return false;
+		}
+
+		if (flushTouchedPages)
+		{
+			// Neighbouring ranges often share a page, so merge them on page granularity first to flush every page only once
+			const size_t pageSize = FileView::GetSystemPageSize();
+			size_t start = m_coalesced.front().offset / pageSize * pageSize;
+			size_t end = start;
+
+			for (const ConstIoRange& range : m_coalesced)
+			{
+				const size_t rangeStart = range.offset / pageSize * pageSize;
+				if (rangeStart > end)
+				{
+					if (!view.Flush({ start, end - start }))
+					{
+						return false;
+					}
+
+					start = rangeStart;
+				}
+
+				end = std::max(end, range.offset + range.size);
+			}
+
+			if (!view.Flush({ start, end - start }))
+			{
+				return false;
+			}
+		}
+
+		Clear();
+		return true;
+	}
+
+	const std::vector<ConstIoRange>& WriteBatch::GetCoalescedRanges()
+	{
+		Coalesce();
+		return m_coalesced;
+	}
+
+	size_t WriteBatch::GetNrOfWrites() const
+	{
+		return m_entries.size();
+	}
+
+	bool WriteBatch::IsEmpty() const
+	{
+		return m_entries.empty();
+	}
+
+	void WriteBatch::Clear()
+	{
+		m_entries.clear();
+		m_data.clear();
+		m_coalesced.clear();
+		m_mergedData.clear();
+		m_isCoalesced = false;
+	}
+
+	void WriteBatch::Coalesce()
+	{
+		if (m_isCoalesced)
+		{
+			return;
+		}
+
+		if (m_entries.empty())
+		{
+			m_coalesced.clear();
+			m_mergedData.clear();
+			m_isCoalesced = true;
+			return;
+		}
+
+		// Sort by offset, a stable sort keeps writes to the same offset in the order they were added
+		std::vector<size_t> order(m_entries.size());
+		std::iota(order.begin(), order.end(), size_t{ 0 });
+		std::stable_sort(order.begin(), order.end(), [this](size_t lhs, size_t rhs) { return m_entries[lhs].offset < m_entries[rhs].offset; });
+
+		struct Group
+		{
+			size_t first; // Index into 'order'
+			size_t last;
+			size_t offset;
+			size_t size;
+		};
+
+		std::vector<Group> groups;
+		size_t mergedSize{};
+
+		for (size_t i{}; i < order.size(); ++i)
+		{
+			const Entry& entry = m_entries[order[i]];
+
+			if (!groups.empty() && entry.offset <= groups.back().offset + groups.back().size)
+			{
+				Group& group = groups.back();
+				group.last = i;
+				group.size = std::max(group.size, entry.offset + entry.size - group.offset);
+				continue;
+			}
+
+			if (!groups.empty() && groups.back().first != groups.back().last)
+			{
+				mergedSize += groups.back().size;
+			}
+
+			groups.push_back({ i, i, entry.offset, entry.size });
+		}
+
+		if (groups.back().first != groups.back().last)
+		{
+			mergedSize += groups.back().size;
+		}
+
+		// Allocated once up front, so the merged buffers never move while they are being filled
+		m_mergedData.resize(mergedSize);
+		m_coalesced.clear();
+		m_coalesced.reserve(groups.size());
+
+		size_t mergedOffset{};
+		for (const Group& group : groups)
+		{
+			if (group.first == group.last)
+			{
+				const Entry& entry = m_entries[order[group.first]];
+				m_coalesced.push_back({ entry.offset, entry.size, m_data.data() + entry.dataOffset });
+				continue;
+			}
+
+			// Apply the writes in the order they were added, so later writes overwrite earlier ones
+			std::vector<size_t> entries(order.begin() + group.first, order.begin() + group.last + 1);
+			std::sort(entries.begin(), entries.end());
+
+			char* const buffer = m_mergedData.data() + mergedOffset;
+			for (const size_t index : entries)
+			{
+				const Entry& entry = m_entries[index];
+				std::memcpy(buffer + (entry.offset - group.offset), m_data.data() + entry.dataOffset, entry.size);
+			}
+
+			m_coalesced.push_back({ group.offset, group.size, buffer });
+			mergedOffset += group.size;
+		}
+
+		m_isCoalesced = true;
+	}
+} // namespace rapidio
@@ -1,13 +1,20 @@
 #pragma once
 
 #ifdef _WIN32
+#	include "PlaceholderMapping.hpp"
 #	include "Win32Handle.hpp"
 #endif // _WIN32
 
 #include <filesystem>
+#include <functional>
+#include <iterator>
+#include <limits>
 #include <optional>
+#include <ranges>
+#include <span>
 #include <string>
 #include <string_view>
+#include <vector>
 
 namespace rapidio
 {
@@ -47,7 +54,57 @@ namespace rapidio
 		{ buff.assign(std::declval<char*>(), std::declval<size_t>()) };
 	};
 
-	class FileView final
+	/// <summary>
+	/// A range of bytes inside the mapped view of a file. Offsets are relative to the start of the mapped view, just like 'Write()'.
+	/// A size that reaches past the end of the mapped view is clamped to the mapped view, so the default range covers the entire view
+	/// </summary>
+	struct FileRange
+	{
+		size_t offset = 0;
+		size_t size = std::numeric_limits<size_t>::max();
+	};
+
+	/// <summary>
+	/// A single segment of a vectored read: 'size' bytes at 'offset' in the mapped view are copied into 'buffer'
+	/// </summary>
+	struct IoRange
+	{
+		size_t offset = 0;
+		size_t size = 0;
+		void* buffer = nullptr;
+	};
+
+	/// <summary>
+	/// A single segment of a vectored write: 'size' bytes from 'buffer' are copied to 'offset' in the mapped view
+	/// </summary>
+	struct ConstIoRange
+	{
+		size_t offset = 0;
+		size_t size = 0;
+		const void* buffer = nullptr;
+	};
+
+	/// <summary>
+	/// A match of 'FileView::FindAny()': 'pattern' is the index of the matching pattern, 'offset' is relative to the start of the mapped view
+	/// </summary>
+	struct PatternMatch
+	{
+		size_t offset = 0;
+		size_t pattern = 0;
+
+		bool operator==(const PatternMatch&) const = default;
+	};
+
+	template<FileAccessMode Access>
+	class ChunkView;
+
+	/// <summary>
+	/// Maps a file into memory. The access mode is part of the type: a 'ReadOnlyFileView' has no functions that write to or grow the file,
+	/// so misusing it does not compile, and reading from it is a bounds check plus pointer arithmetic.
+	/// A 'FileView' can still be opened read-only, writing to it then fails at runtime
+	/// </summary>
+	template<FileAccessMode Access>
+	class BasicFileView final
 	{
 	public:
 		/// <summary>
@@ -61,8 +118,19 @@ namespace rapidio
 		/// which can be retrieved by calling FileView::GetSystemAllocationGranularity().
 		/// This value will be automatically adjusted to fit the allocation granularity</param>
 		/// <returns>std::nullopt if the FileView could not be created. A valid optional of a FileView if the FileView was sucessfully created</returns>
-		static std::optional<FileView> CreateViewFromExistingFile(const std::filesystem::path& filepath, FileAccessMode accessMode,
-			FileOpenMode openMode, size_t fileMappingSize = 0, size_t offset = 0);
+		static std::optional<BasicFileView> CreateViewFromExistingFile(const std::filesystem::path& filepath, FileAccessMode accessMode,
+			FileOpenMode openMode, size_t fileMappingSize = 0, size_t offset = 0) requires (Access == FileAccessMode::ReadWrite);
+
+		/// <summary>
+		/// Creates a read-only view of an existing file on the filesystem.
+		/// </summary>
+		/// <param name="filepath">Path to the file to be mapped</param>
+		/// <param name="openMode">How should the file be opened? Only allowed value is OpenExisting</param>
+		/// <param name="fileMappingSize">How much of the file should be mapped? If set to 0, the entire file is mapped</param>
+		/// <param name="offset">Offset into the file to create the file mapping, adjusted to the system allocation granularity</param>
+		/// <returns>std::nullopt if the view could not be created. A valid optional of a ReadOnlyFileView if the view was sucessfully created</returns>
+		static std::optional<BasicFileView> CreateViewFromExistingFile(const std::filesystem::path& filepath, FileOpenMode openMode,
+			size_t fileMappingSize = 0, size_t offset = 0) requires (Access == FileAccessMode::ReadOnly);
 
 		/// <summary>
 		/// Creates a FileView object for a non-existing file on the filesystem. 
@@ -71,7 +139,8 @@ namespace rapidio
 		/// <param name="filepath">Path to the file to be created and mapped</param>
 		/// <param name="expectedFileSize">Initial size of the file</param>
 		/// <returns>std::nullopt if the FileView could not be created. A valid optional of a FileView if the FileView was sucessfully created</returns>
-		static std::optional<FileView> CreateViewForNewFile(const std::filesystem::path& filepath, size_t expectedFileSize);
+		static std::optional<BasicFileView> CreateViewForNewFile(const std::filesystem::path& filepath, size_t expectedFileSize)
+			requires (Access == FileAccessMode::ReadWrite);
 
 		/// <summary>
 		/// Static function to get the system allocation granularity
@@ -79,6 +148,12 @@ namespace rapidio
 		/// <returns>The system allocation granularity</returns>
 		static size_t GetSystemAllocationGranularity();
 
+		/// <summary>
+		/// Static function to get the system page size
+		/// </summary>
+		/// <returns>The system page size</returns>
+		static size_t GetSystemPageSize();
+
 		// Sets filepointer to a specific position		
 		bool Seek(size_t position);
 
@@ -102,6 +177,14 @@ namespace rapidio
 		template<IsBufferLike T>
 		bool Read(T& buffer, size_t bytesToRead, bool autoGrowFileMapping = true);
 
+		/// <summary>
+		/// Read bytes from the filepointer without copying them. The view is valid as long as no re-allocation of the file mapping takes place
+		/// </summary>
+		/// <param name="bytesToRead">Number of bytes to read</param>
+		/// <param name="autoGrowFileMapping">if set to true, will automatically re-allocate the filemapping if the read amount of bytes exceeds the mapped file size</param>
+		/// <returns>std::string_view into the mapped view, empty at EOF or on failure</returns>
+		std::string_view ReadView(size_t bytesToRead, bool autoGrowFileMapping = true);
+
 		/// <summary>
 		/// Write a buffer to the mapped file at the provided offset.
 		/// </summary>
@@ -111,10 +194,236 @@ namespace rapidio
 		/// <param name="autoGrowFileMapping">If set to true, will automatically increase mapped file size to required size to write data</param>
 		/// <returns>Returns true upon successful writing of data</returns>
 		template<IsBufferLike T>
-		bool Write(T&& data, size_t offset = 0, bool autoGrowFile = true, bool autoGrowFileMapping = true);
+		bool Write(T&& data, size_t offset = 0, bool autoGrowFile = true, bool autoGrowFileMapping = true) requires (Access == FileAccessMode::ReadWrite);
+
+		/// <summary>
+		/// Write a buffer to the mapped file at the provided offset, copying page-aligned slices on multiple threads so page faults on a fresh
+		/// mapping are taken in parallel. The file and its mapped view are grown once before any data is copied. Small buffers are written with 'Write()'
+		/// </summary>
+		/// <param name="data">Buffer containing data to write to mapped file</param>
+		/// <param name="offset">Offset (from start of file) to write data to</param>
+		/// <param name="nrOfThreads">Number of threads to copy with, 0 means every hardware thread</param>
+		/// <param name="autoGrowFile">If set to true, will automatically increase filesize to required size to write data</param>
+		/// <param name="autoGrowFileMapping">If set to true, will automatically increase mapped file size to required size to write data</param>
+		/// <returns>Returns true upon successful writing of data</returns>
+		template<IsBufferLike T>
+		bool ParallelWrite(T&& data, size_t offset = 0, size_t nrOfThreads = 0, bool autoGrowFile = true, bool autoGrowFileMapping = true)
+			requires (Access == FileAccessMode::ReadWrite);
+
+		/// <summary>
+		/// Reads every range into its buffer in one call. All ranges are validated up front and the file mapping is grown at most once.
+		/// The filepointer is not moved
+		/// </summary>
+		/// <param name="ranges">Ranges to read. Reading past EOF fails the entire call</param>
+		/// <param name="autoGrowFileMapping">if set to true, will automatically re-allocate the filemapping if a range exceeds the mapped file size</param>
+		/// <param name="nrOfThreads">Number of threads to copy large batches with, 0 means every hardware thread</param>
+		/// <returns>Returns true if every range was read. If false is returned, no buffer has been written to</returns>
+		bool ReadV(std::span<const IoRange> ranges, bool autoGrowFileMapping = true, size_t nrOfThreads = 1);
+
+		/// <summary>
+		/// Writes every range to the mapped file in one call. All ranges are validated up front and the file is grown at most once
+		/// </summary>
+		/// <param name="ranges">Ranges to write. Ranges may overlap, in which case the last one wins (unless copied in parallel)</param>
+		/// <param name="autoGrowFile">If set to true, will automatically increase filesize to required size to write data</param>
+		/// <param name="autoGrowFileMapping">If set to true, will automatically increase mapped file size to required size to write data</param>
+		/// <param name="nrOfThreads">Number of threads to copy large batches with, 0 means every hardware thread</param>
+		/// <returns>Returns true if every range was written. If false is returned, nothing has been written</returns>
+		bool WriteV(std::span<const ConstIoRange> ranges, bool autoGrowFile = true, bool autoGrowFileMapping = true, size_t nrOfThreads = 1)
+			requires (Access == FileAccessMode::ReadWrite);
+
+		/// <summary>
+		/// Copies 'size' bytes starting at 'offset' of this view to 'destinationOffset' of 'destination', growing the destination if required.
+		/// On volumes that support block cloning (ReFS, Dev Drive) the clusters the range shares with the destination are cloned by the file system,
+		/// without the data ever passing through this process. Everything else is copied from mapped view to mapped view with non-temporal stores
+		/// </summary>
+		/// <param name="offset">Offset (from start of file) of the bytes to copy</param>
+		/// <param name="destination">View to copy to, must be a different view</param>
+		/// <param name="destinationOffset">Offset (from start of file) in 'destination' to copy to</param>
+		/// <param name="size">Number of bytes to copy. Copying past EOF of this view fails</param>
+		/// <param name="allowBlockClone">If set to false, every byte is copied through the mapped views</param>
+		/// <returns>Returns true if every byte was copied. Any pointer into 'destination' is invalidated</returns>
+		bool CopyRange(size_t offset, BasicFileView<FileAccessMode::ReadWrite>& destination, size_t destinationOffset, size_t size, bool allowBlockClone = true);
+
+		/// <summary>
+		/// Copies the entire file to the start of 'destination', see 'CopyRange()'. The destination is grown if required, but never shrunk
+		/// </summary>
+		bool CopyTo(BasicFileView<FileAccessMode::ReadWrite>& destination, bool allowBlockClone = true);
+
+		/// <summary>
+		/// Makes sure both the file and its mapped view are at least 'size' bytes, growing them with a single re-allocation if required.
+		/// Any pointer into the mapped view obtained before growing is invalidated, unless the growth fits in 'ReserveAddressSpace()'
+		/// </summary>
+		/// <param name="size">Minimum size of the file and its mapped view</param>
+		/// <returns>Returns true if the file and its mapped view are at least 'size' bytes</returns>
+		bool Reserve(size_t size);
+
+		/// <summary>
+		/// Reserves 'size' bytes of address space and moves the mapped view to its start. From then on, growing the file or its mapped view
+		/// only maps the new bytes right behind the existing ones, so 'GetData()' and every pointer into the view stay valid.
+		/// Growing past 'size' moves the view once more, into a reservation of twice the size.
+		/// While mapped, the file is padded to the system allocation granularity, the padding is cut off again when the FileView is destroyed.
+		/// Requires ReadWrite access and Windows 10 version 1803 or later
+		/// </summary>
+		/// <param name="size">Number of bytes of address space to reserve</param>
+		/// <returns>Returns true if the mapped view now lives in a reservation of at least 'size' bytes</returns>
+		bool ReserveAddressSpace(size_t size) requires (Access == FileAccessMode::ReadWrite);
+
+		// Returns the number of bytes of address space reserved by 'ReserveAddressSpace()', 0 if the view is not address-stable
+		size_t GetReservedAddressSpace() const;
+
+		/// <summary>
+		/// Returns the start of the mapped view. Valid until the file mapping is re-allocated. A read-only view only hands out const data
+		/// </summary>
+		char* GetData() requires (Access == FileAccessMode::ReadWrite);
+		const char* GetData() const;
+
+		// Returns the number of bytes in the mapped view
+		size_t GetMappedSize() const;
+
+		/// <summary>
+		/// Searches the mapped view for the first occurrence of 'pattern' at or after 'from'. With multiple threads, the view is searched in
+		/// windows of parallel chunks, stopping at the first window containing a match
+		/// </summary>
+		/// <param name="pattern">Bytes to search for</param>
+		/// <param name="from">Offset (from start of the mapped view) to start searching from</param>
+		/// <param name="nrOfThreads">Number of threads to search with, 0 means every hardware thread</param>
+		/// <returns>Offset of the match, which can be passed to 'Seek()'. std::nullopt if there is no match</returns>
+		std::optional<size_t> Find(std::string_view pattern, size_t from = 0, size_t nrOfThreads = 1) const;
+
+		/// <summary>
+		/// Returns the offsets of every occurrence of 'pattern' starting inside 'range', including overlapping ones, in ascending order.
+		/// The range is searched in parallel chunks, matches crossing a chunk boundary are found as well
+		/// </summary>
+		/// <param name="pattern">Bytes to search for, must not be empty</param>
+		/// <param name="range">Range of the mapped view to search. Matches may extend past the end of the range</param>
+		/// <param name="nrOfThreads">Number of threads to search with, 0 means every hardware thread</param>
+		std::vector<size_t> FindAll(std::string_view pattern, FileRange range = {}, size_t nrOfThreads = 0) const;
+
+		/// <summary>
+		/// Searches for several patterns in a single pass. Positions are pre-filtered on the first byte of every pattern with SIMD compares
+		/// </summary>
+		/// <param name="patterns">Patterns to search for, empty patterns are ignored</param>
+		/// <param name="range">Range of the mapped view to search. Matches may extend past the end of the range</param>
+		/// <param name="nrOfThreads">Number of threads to search with, 0 means every hardware thread</param>
+		/// <returns>Every match, sorted by offset and then by pattern index</returns>
+		std::vector<PatternMatch> FindAny(std::span<const std::string_view> patterns, FileRange range = {}, size_t nrOfThreads = 0) const;
+
+		/// <summary>
+		/// Computes the CRC32C of 'range' directly on the mapped bytes. Large ranges are checksummed in blocks on multiple threads
+		/// </summary>
+		/// <param name="range">Range of the mapped view to checksum</param>
+		/// <param name="nrOfThreads">Number of threads to checksum with, 0 means every hardware thread</param>
+		/// <returns>std::nullopt if the range starts past the end of the mapped view</returns>
+		std::optional<uint32_t> Checksum(FileRange range = {}, size_t nrOfThreads = 0) const;
+
+		/// <summary>
+		/// Validates that 'range' is UTF-8, directly on the mapped bytes. Large ranges are split into chunks on sequence boundaries and validated
+		/// on multiple threads, with a SIMD lookup table validator on CPUs with AVX2
+		/// </summary>
+		/// <param name="range">Range of the mapped view to validate, must start at the start of a sequence. A sequence cut off by its end is invalid</param>
+		/// <param name="nrOfThreads">Number of threads to validate with, 0 means every hardware thread</param>
+		/// <returns>Offset of the first byte that does not start a valid UTF-8 sequence, std::nullopt if the entire range is valid.
+		/// A range starting past the end of the mapped view is invalid at its offset</returns>
+		std::optional<size_t> ValidateUtf8(FileRange range = {}, size_t nrOfThreads = 0) const;
+
+		/// <summary>
+		/// Copies 'range' to 'destinationOffset' of 'destination', replacing every CRLF line ending by a LF, a lone CR is kept.
+		/// Line endings are counted first, so the destination is grown once to exactly the size of the output, after which the text between
+		/// line endings is copied straight from mapped view to mapped view. Both passes run in chunks on multiple threads
+		/// </summary>
+		/// <param name="destination">View to copy to, must be a different view. It is grown if required, but never shrunk</param>
+		/// <param name="destinationOffset">Offset (from start of file) in 'destination' to copy to</param>
+		/// <param name="range">Range of the mapped view to copy. A CR at the end of the range is kept, split ranges after a LF to normalize in pieces</param>
+		/// <param name="nrOfThreads">Number of threads to copy with, 0 means every hardware thread</param>
+		/// <returns>Number of bytes written to 'destination', std::nullopt if the range starts past the end of the mapped view or the destination could not grow.
+		/// Any pointer into 'destination' is invalidated</returns>
+		std::optional<size_t> NormalizeLineEndings(BasicFileView<FileAccessMode::ReadWrite>& destination, size_t destinationOffset = 0, FileRange range = {},
+			size_t nrOfThreads = 0);
+
+		/// <summary>
+		/// Writes the dirty pages overlapping 'range' back to the file. The file system may still cache the data, so it is not guaranteed to have
+		/// reached the disk when this returns
+		/// </summary>
+		/// <param name="range">Range of the mapped view to flush</param>
+		/// <returns>Returns true if the pages were flushed</returns>
+		bool Flush(FileRange range = {});
+
+		/// <summary>
+		/// Releases the physical memory backing the pages fully inside 'range'. The data stays in the file and is paged back in on the next access
+		/// </summary>
+		/// <param name="range">Range of the mapped view to release</param>
+		/// <returns>Returns true if the pages were released</returns>
+		bool Discard(FileRange range);
+
+		/// <summary>
+		/// Asks the OS to read the pages of 'range' into memory in the background, so later accesses do not fault. Returns immediately
+		/// </summary>
+		/// <param name="range">Range of the mapped view to prefetch</param>
+		/// <returns>Returns true if the prefetch was issued</returns>
+		bool Prefetch(FileRange range);
+
+		/// <summary>
+		/// Returns a view over the file in consecutive chunks of 'chunkSize' bytes, for sequential scans. The entire file is mapped up front,
+		/// which only costs address space. While iterating, the chunk after the current one is prefetched, and with 'releaseConsumedChunks'
+		/// every chunk that has been moved past is released from the working set, so memory use stays constant regardless of the file size
+		/// </summary>
+		/// <param name="chunkSize">Size of every chunk, the last chunk can be smaller. Multiples of the page size release memory most precisely</param>
+		/// <param name="releaseConsumedChunks">If set to true, pages are released with 'Discard()' once the scan has moved past them</param>
+		/// <returns>An empty view if 'chunkSize' is 0 or the file could not be mapped</returns>
+		ChunkView<Access> Chunks(size_t chunkSize, bool releaseConsumedChunks = true);
+
+		/// <summary>
+		/// Returns which fraction of the pages in 'range' is currently resident in the working set of this process
+		/// </summary>
+		/// <param name="range">Range of the mapped view to query</param>
+		/// <returns>Value between 0 and 1. Returns 0 for an empty range</returns>
+		double ResidentFraction(FileRange range = {}) const;
+
+		/// <summary>
+		/// Returns, for every page in 'range', whether it is currently resident in the working set of this process
+		/// </summary>
+		/// <param name="range">Range of the mapped view to query</param>
+		/// <returns>One entry per page, starting at the page containing 'range.offset'. Empty if the query failed</returns>
+		std::vector<bool> ResidencyBitmap(FileRange range = {}) const;
+
+		/// <summary>
+		/// Faults in every page of 'range' on multiple threads, so later reads no longer page fault
+		/// </summary>
+		/// <param name="range">Range of the mapped view to warm up</param>
+		/// <param name="nrOfThreads">Number of threads to warm up with, 0 means every hardware thread</param>
+		/// <param name="progress">Optional callback receiving (warmed bytes, total bytes). It is called from the warming threads, but never concurrently</param>
+		/// <returns>Returns true if the range was warmed up</returns>
+		bool Warm(FileRange range = {}, size_t nrOfThreads = 0, const std::function<void(size_t, size_t)>& progress = {});
+
+		/// <summary>
+		/// Stores the set of currently resident pages in a small sidecar file, which can be replayed with 'ReplayResidency()' on the next start
+		/// </summary>
+		/// <param name="sidecarPath">Path to the sidecar file. An existing file is overwritten</param>
+		/// <returns>Returns true if the sidecar file was written</returns>
+		bool SaveResidency(const std::filesystem::path& sidecarPath) const;
+
+		/// <summary>
+		/// Warms up exactly the pages stored in a sidecar file created by 'SaveResidency()'
+		/// </summary>
+		/// <param name="sidecarPath">Path to the sidecar file</param>
+		/// <param name="nrOfThreads">Number of threads to warm up with, 0 means every hardware thread</param>
+		/// <param name="progress">Optional callback receiving (warmed bytes, total bytes)</param>
+		/// <returns>Returns false if the sidecar file is missing, or does not belong to this view</returns>
+		bool ReplayResidency(const std::filesystem::path& sidecarPath, size_t nrOfThreads = 0, const std::function<void(size_t, size_t)>& progress = {});
 
 	private:
-		FileView(const std::string& filepath, const FileAccessMode accessMode);
+		// Copying between views reaches into the handles of both, which can differ in access mode
+		template<FileAccessMode>
+		friend class BasicFileView;
+
+		BasicFileView(const std::string& filepath, const FileAccessMode accessMode);
+
+		static std::optional<BasicFileView> OpenExistingFile(const std::filesystem::path& filepath, FileAccessMode accessMode, FileOpenMode openMode,
+			size_t fileMappingSize, size_t offset);
+
+		// Known at compile time for a ReadOnlyFileView, so every check on it folds away
+		bool IsReadOnly() const;
+		bool IsAddressStable() const;
 
 		bool OpenFile(const FileAccessMode accessMode, const FileOpenMode opemMode);
 		bool GetFilesize();
@@ -123,6 +432,15 @@ namespace rapidio
 		void CreateMapViewOfFile(size_t size, size_t offset);
 		bool ReallocateFileMapping(size_t newSize);
 		bool ReallocateMappedViewOfFile(size_t newSize);
+		bool MapIntoReservation(size_t reservationSize, size_t mappedSize) requires (Access == FileAccessMode::ReadWrite);
+		bool ClampRange(FileRange& range) const;
+		template<FileAccessMode SourceAccess>
+		FileRange GetCloneableRange(const BasicFileView<SourceAccess>& source, size_t sourceOffset, size_t offset, size_t size) const
+			requires (Access == FileAccessMode::ReadWrite);
+		template<FileAccessMode SourceAccess>
+		bool CloneFrom(const BasicFileView<SourceAccess>& source, size_t sourceOffset, size_t offset, size_t size)
+			requires (Access == FileAccessMode::ReadWrite);
+		bool WarmRanges(const std::vector<FileRange>& ranges, size_t nrOfThreads, const std::function<void(size_t, size_t)>& progress);
 
 		std::string m_filepath;
 		size_t m_filesize = 0;
@@ -132,11 +450,71 @@ namespace rapidio
 		#ifdef _WIN32
 		Win32Handle m_fileHandle;
 		Win32Handle m_fileMappingHandle;
-		Win32Handle m_mappedViewHandle;
+		Win32MappedView m_mappedViewHandle;
 		size_t m_fileMappingSize = 0;
+		size_t m_mappedViewSize = 0;
 		size_t m_allocationGranularity;
+		PlaceholderMapping m_placeholderMapping; // Replaces 'm_mappedViewHandle' once address space is reserved, never used by a ReadOnlyFileView
 		#endif // _WIN32
 	};
+
+	using FileView = BasicFileView<FileAccessMode::ReadWrite>;
+	using ReadOnlyFileView = BasicFileView<FileAccessMode::ReadOnly>;
+
+	/// <summary>
+	/// Single-pass iterator over the chunks of a ChunkView. A chunk is only valid until the iterator is incremented, after which its pages can be released
+	/// </summary>
+	template<FileAccessMode Access>
+	class ChunkIterator final
+	{
+	public:
+		using iterator_concept = std::input_iterator_tag;
+		using value_type = std::span<const char>;
+		using difference_type = std::ptrdiff_t;
+
+		ChunkIterator() = default;
+
+		std::span<const char> operator*() const;
+		ChunkIterator& operator++();
+		void operator++(int);
+
+		bool operator==(std::default_sentinel_t) const;
+
+	private:
+		friend class ChunkView<Access>;
+
+		ChunkIterator(BasicFileView<Access>* view, size_t size, size_t chunkSize, bool releaseConsumedChunks);
+
+		BasicFileView<Access>* m_view = nullptr;
+		size_t m_size = 0;
+		size_t m_chunkSize = 0;
+		size_t m_offset = 0;
+		size_t m_releasedSize = 0; // Everything before this offset has been released, always a multiple of the page size
+		bool m_releaseConsumedChunks = false;
+	};
+
+	/// <summary>
+	/// std::ranges::view over a file in consecutive chunks, returned by 'Chunks()'. Single-pass, every call to begin() starts a new scan
+	/// </summary>
+	template<FileAccessMode Access>
+	class ChunkView final : public std::ranges::view_interface<ChunkView<Access>>
+	{
+	public:
+		ChunkView() = default;
+
+		ChunkIterator<Access> begin() const;
+		std::default_sentinel_t end() const;
+
+	private:
+		friend class BasicFileView<Access>;
+
+		ChunkView(BasicFileView<Access>& view, size_t size, size_t chunkSize, bool releaseConsumedChunks);
+
+		BasicFileView<Access>* m_view = nullptr;
+		size_t m_size = 0;
+		size_t m_chunkSize = 0;
+		bool m_releaseConsumedChunks = false;
+	};
 } // namespace rapidio
 
 #ifdef _WIN32
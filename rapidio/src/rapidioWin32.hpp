@@ -1,14 +1,26 @@
 #pragma once
 
+#include "ChecksumUtils.hpp"
+#include "CopyUtils.hpp"
 #include "PathUtils.hpp"
+#include "ScanUtils.hpp"
+#include "TextUtils.hpp"
+#include "ThreadUtils.hpp"
+#include "TraceUtils.hpp"
 
 #include "Win32Call.hpp"
 #include "Win32Handle.hpp"
 
 #include <fileapi.h>
+#include <winioctl.h>
+#include <psapi.h>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <filesystem>
 #include <functional>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -18,6 +30,22 @@ namespace rapidio
 {
 	namespace detail
 	{
+		// Buffer-like that only remembers where the data lives, used to get a zero-copy span out of FileView::Read()
+		struct SpanBuffer final
+		{
+			const char* m_data = nullptr;
+			size_t m_size = 0;
+
+			const char* data() const { return m_data; }
+			size_t size() const { return m_size; }
+
+			void assign(const char* data, size_t size)
+			{
+				m_data = data;
+				m_size = size;
+			}
+		};
+
 		DWORD GetHighDWORD(size_t val)
 		{
 			return static_cast<DWORD>(static_cast<uint64_t>(val >> 32) & 0xFFFFFFFF);
@@ -27,10 +55,183 @@ namespace rapidio
 		{
 			return static_cast<DWORD>(static_cast<uint64_t>(val) & 0xFFFFFFFF);
 		}
+
+		// Warm-up work is handed out to threads in chunks of this size
+		constexpr size_t WarmChunkSize = 1024 * 1024; // 1 MB
+
+		struct ResidencySidecarHeader
+		{
+			char magic[8];
+			uint32_t version;
+			uint32_t pageSize;
+			uint64_t mappedSize;
+			uint64_t nrOfPages;
+		};
+
+		// 'Find()', 'FindAll()' and 'FindAny()' search ranges in chunks of this size, every chunk is a task for the thread pool
+		constexpr size_t SearchChunkSize = 1024 * 1024 * 4; // 4 MB
+
+		// The SIMD pre-filter of 'FindAny()' compares every block against each distinct first byte, past this it is cheaper to use a lookup table
+		constexpr size_t MaxSimdLeadingBytes = 16;
+
+		/// <summary>
+		/// Patterns of a 'FindAny()' call, grouped by their first byte
+		/// </summary>
+		struct PatternSet
+		{
+			std::span<const std::string_view> patterns;
+			std::vector<char> leadingBytes;
+			std::array<std::vector<size_t>, 256> patternsByLeadingByte;
+			size_t longestPattern = 0;
+
+			explicit PatternSet(std::span<const std::string_view> patternsToFind)
+				: patterns(patternsToFind)
+			{
+				for (size_t i{}; i < patterns.size(); ++i)
+				{
+					if (patterns[i].empty())
+					{
+						continue;
+					}
+
+					std::vector<size_t>& group = patternsByLeadingByte[static_cast<unsigned char>(patterns[i].front())];
+					if (group.empty())
+					{
+						leadingBytes.push_back(patterns[i].front());
+					}
+
+					group.push_back(i);
+					longestPattern = std::max(longestPattern, patterns[i].size());
+				}
+			}
+
+			// Reports every pattern matching at 'position' of 'haystack'
+			void MatchAt(std::string_view haystack, size_t position, size_t baseOffset, std::vector<PatternMatch>& matches) const
+			{
+				for (const size_t index : patternsByLeadingByte[static_cast<unsigned char>(haystack[position])])
+				{
+					const std::string_view pattern = patterns[index];
+					if (position + pattern.size() <= haystack.size() && std::memcmp(haystack.data() + position, pattern.data(), pattern.size()) == 0)
+					{
+						matches.push_back({ baseOffset + position, index });
+					}
+				}
+			}
+
+			// Reports every match starting before 'reportEnd' in 'haystack'
+			void FindAll(std::string_view haystack, size_t reportEnd, size_t baseOffset, std::vector<PatternMatch>& matches) const
+			{
+				size_t position{};
+
+				if (leadingBytes.size() <= MaxSimdLeadingBytes)
+				{
+					uint64_t masks[MaxSimdLeadingBytes];
+
+					for (; position + ScanBlockSize <= reportEnd; position += ScanBlockSize)
+					{
+						MatchBytes(haystack.data() + position, leadingBytes, masks);
+
+						uint64_t candidates{};
+						for (size_t i{}; i < leadingBytes.size(); ++i)
+						{
+							candidates |= masks[i];
+						}
+
+						for (; candidates != 0; candidates &= candidates - 1)
+						{
+							MatchAt(haystack, position + std::countr_zero(candidates), baseOffset, matches);
+						}
+					}
+				}
+
+				for (; position < reportEnd; ++position)
+				{
+					MatchAt(haystack, position, baseOffset, matches);
+				}
+			}
+		};
+
+		// 'Checksum()' splits ranges into blocks of this size to checksum them in parallel
+		constexpr size_t ChecksumChunkSize = 1024 * 1024; // 1 MB
+
+		// 'ValidateUtf8()' and 'NormalizeLineEndings()' split ranges into chunks of this size to process them in parallel
+		constexpr size_t TextChunkSize = 1024 * 1024; // 1 MB
+
+		// 'ParallelWrite()' copies buffers smaller than this on the calling thread. Slices are a multiple of every common page size
+		constexpr size_t ParallelWriteThreshold = 1024 * 1024 * 8; // 8 MB
+		constexpr size_t ParallelWriteSliceSize = 1024 * 1024 * 2; // 2 MB
+
+		// Vectored reads and writes smaller than this are always copied on the calling thread
+		constexpr size_t VectoredParallelThreshold = 1024 * 1024 * 8; // 8 MB
+		constexpr size_t VectoredChunkSize = 1024 * 1024; // 1 MB
+
+		/// <summary>
+		/// Calls 'copy(rangeIndex, offsetInRange, size)' until every range has been covered. Large batches are split into chunks and spread over threads
+		/// </summary>
+		template<typename Range, typename Func>
+		void ForEachRangeChunk(std::span<const Range> ranges, size_t nrOfThreads, Func&& copy)
+		{
+			size_t totalBytes{};
+			for (const Range& range : ranges)
+			{
+				totalBytes += range.size;
+			}
+
+			if (nrOfThreads == 1 || totalBytes < VectoredParallelThreshold)
+			{
+				for (size_t i{}; i < ranges.size(); ++i)
+				{
+					copy(i, 0, ranges[i].size);
+				}
+
+				return;
+			}
+
+			struct Chunk
+			{
+				size_t range;
+				size_t offset;
+				size_t size;
+			};
+
+			std::vector<Chunk> chunks;
+			chunks.reserve(totalBytes / VectoredChunkSize + ranges.size());
+
+			for (size_t i{}; i < ranges.size(); ++i)
+			{
+				for (size_t offset{}; offset < ranges[i].size; offset += VectoredChunkSize)
+				{
+					chunks.push_back({ i, offset, std::min(VectoredChunkSize, ranges[i].size - offset) });
+				}
+			}
+
+			ParallelFor(chunks.size(), nrOfThreads, [&chunks, &copy](size_t i)
+				{
+					copy(chunks[i].range, chunks[i].offset, chunks[i].size);
+				});
+		}
+
+		constexpr char ResidencySidecarMagic[8] = { 'R', 'I', 'O', 'R', 'E', 'S', 'I', 'D' };
+		constexpr uint32_t ResidencySidecarVersion = 1;
 	} // namespace detail
 
-	std::optional<FileView> FileView::CreateViewFromExistingFile(const std::filesystem::path& filepath, FileAccessMode accessMode,
-		FileOpenMode openMode, size_t fileMappingSize /* = 0 */, size_t offset /* = 0 */)
+	template<FileAccessMode Access>
+	std::optional<BasicFileView<Access>> BasicFileView<Access>::CreateViewFromExistingFile(const std::filesystem::path& filepath, FileAccessMode accessMode,
+		FileOpenMode openMode, size_t fileMappingSize /* = 0 */, size_t offset /* = 0 */) requires (Access == FileAccessMode::ReadWrite)
+	{
+		return OpenExistingFile(filepath, accessMode, openMode, fileMappingSize, offset);
+	}
+
+	template<FileAccessMode Access>
+	std::optional<BasicFileView<Access>> BasicFileView<Access>::CreateViewFromExistingFile(const std::filesystem::path& filepath, FileOpenMode openMode,
+		size_t fileMappingSize /* = 0 */, size_t offset /* = 0 */) requires (Access == FileAccessMode::ReadOnly)
+	{
+		return OpenExistingFile(filepath, FileAccessMode::ReadOnly, openMode, fileMappingSize, offset);
+	}
+
+	template<FileAccessMode Access>
+	std::optional<BasicFileView<Access>> BasicFileView<Access>::OpenExistingFile(const std::filesystem::path& filepath, FileAccessMode accessMode,
+		FileOpenMode openMode, size_t fileMappingSize, size_t offset)
 	{
 		if (!PathUtils::DoesFileExist(filepath))
 		{
@@ -38,7 +239,7 @@ namespace rapidio
 			return std::nullopt;
 		}
 
-		FileView view(filepath.string(), accessMode);
+		BasicFileView view(filepath.string(), accessMode);
 
 		if (!view.OpenFile(accessMode, openMode))
 		{
@@ -67,7 +268,9 @@ namespace rapidio
 		return view;
 	}
 
-	std::optional<FileView> FileView::CreateViewForNewFile(const std::filesystem::path& filepath, size_t expectedFileSize)
+	template<FileAccessMode Access>
+	std::optional<BasicFileView<Access>> BasicFileView<Access>::CreateViewForNewFile(const std::filesystem::path& filepath, size_t expectedFileSize)
+		requires (Access == FileAccessMode::ReadWrite)
 	{
 		if (expectedFileSize == 0)
 		{
@@ -81,7 +284,7 @@ namespace rapidio
 			return std::nullopt;
 		}
 
-		FileView view(filepath.string(), FileAccessMode::ReadWrite);
+		BasicFileView view(filepath.string(), FileAccessMode::ReadWrite);
 
 		if (!view.OpenFile(FileAccessMode::ReadWrite, FileOpenMode::CreateNew))
 		{
@@ -107,10 +310,14 @@ namespace rapidio
 			return std::nullopt;
 		}
 
+		// Creating the file mapping has grown the file to its expected size
+		view.m_filesize = expectedFileSize;
+
 		return view;
 	}
 
-	bool FileView::Seek(size_t position)
+	template<FileAccessMode Access>
+	bool BasicFileView<Access>::Seek(size_t position)
 	{
 		if (position >= m_filesize)
 		{
@@ -128,7 +335,8 @@ namespace rapidio
 		return true;
 	}
 
-	std::string FileView::Read(size_t bytesToRead, bool autoGrowFileMapping /* = true */)
+	template<FileAccessMode Access>
+	std::string BasicFileView<Access>::Read(size_t bytesToRead, bool autoGrowFileMapping /* = true */)
 	{
 		std::string temp;
 		temp.reserve(bytesToRead);
@@ -136,9 +344,12 @@ namespace rapidio
 		return temp;
 	}
 
+	template<FileAccessMode Access>
 	template<IsBufferLike T>
-	bool FileView::Read(T& buffer, size_t bytesToRead, bool autoGrowFileMapping /* = true */)
+	bool BasicFileView<Access>::Read(T& buffer, size_t bytesToRead, bool autoGrowFileMapping /* = true */)
 	{
+		RAPIDIO_TRACE_SCOPE("Read", m_filepointer, bytesToRead);
+
 		// Are we at EOF?
 		if (m_filepointer >= m_filesize)
 		{
@@ -175,14 +386,30 @@ namespace rapidio
 
 		const size_t oldFilepointer = m_filepointer;
 		m_filepointer += bytesToRead;
-		buffer.assign(static_cast<char*>(m_mappedViewHandle.Get()) + oldFilepointer, bytesToRead);
+		buffer.assign(GetData() + oldFilepointer, bytesToRead);
 		return true;
 	}
 
+	template<FileAccessMode Access>
+	std::string_view BasicFileView<Access>::ReadView(size_t bytesToRead, bool autoGrowFileMapping /* = true */)
+	{
+		detail::SpanBuffer span;
+		if (!Read(span, bytesToRead, autoGrowFileMapping))
+		{
+			return {};
+		}
+
+		return { span.data(), span.size() };
+	}
+
+	template<FileAccessMode Access>
 	template<IsBufferLike T>
-	bool FileView::Write(T&& data, size_t offset /* = 0 */, bool autoGrowFile /* = true */, bool autoGrowFileMapping /* = true */)
+	bool BasicFileView<Access>::Write(T&& data, size_t offset /* = 0 */, bool autoGrowFile /* = true */, bool autoGrowFileMapping /* = true */)
+		requires (Access == FileAccessMode::ReadWrite)
 	{
-		if (m_accessMode == FileAccessMode::ReadOnly)
+		RAPIDIO_TRACE_SCOPE("Write", offset, data.size());
+
+		if (IsReadOnly())
 		{
 			std::cerr << "FileView::Write > Cannot write to read-only mapping\n";
 			return false;
@@ -221,20 +448,329 @@ namespace rapidio
 
 				ReallocateFileMapping(newSize);
 			}
+
+			m_filesize = std::max(m_filesize, newSize);
+		}
+
+		CopyBytes(GetData() + offset, static_cast<const void*>(data.data()), data.size());
+		return true;
+	}
+
+	template<FileAccessMode Access>
+	template<IsBufferLike T>
+	bool BasicFileView<Access>::ParallelWrite(T&& data, size_t offset /* = 0 */, size_t nrOfThreads /* = 0 */, bool autoGrowFile /* = true */,
+		bool autoGrowFileMapping /* = true */) requires (Access == FileAccessMode::ReadWrite)
+	{
+		if (data.size() < detail::ParallelWriteThreshold || GetThreadCount(nrOfThreads) == 1)
+		{
+			return Write(std::forward<T>(data), offset, autoGrowFile, autoGrowFileMapping);
+		}
+
+		RAPIDIO_TRACE_SCOPE("ParallelWrite", offset, data.size());
+
+		if (IsReadOnly())
+		{
+			std::cerr << "FileView::ParallelWrite > Cannot write to read-only mapping\n";
+			return false;
+		}
+
+		if (offset + data.size() > m_filesize && !autoGrowFile)
+		{
+			std::cerr << "FileView::ParallelWrite > size of data + offset is bigger than filesize with autogrow disabled!\n";
+			return false;
+		}
+
+		if (offset + data.size() > GetMappedSize() && !autoGrowFileMapping)
+		{
+			std::cerr << "FileView::ParallelWrite > size of data + offset is bigger than mapped view of file with autogrow disabled!\n";
+			return false;
+		}
+
+		// Pre-extend the file once, growing it while other threads are copying would re-map the view underneath them
+		if (!Reserve(offset + data.size()))
+		{
+			return false;
+		}
+
+		// Slices start on page boundaries of the view, so no two threads ever fault in the same page
+		const size_t firstSliceEnd = std::min(data.size(), (offset / detail::ParallelWriteSliceSize + 1) * detail::ParallelWriteSliceSize - offset);
+		const size_t nrOfSlices = 1 + (data.size() - firstSliceEnd + detail::ParallelWriteSliceSize - 1) / detail::ParallelWriteSliceSize;
+
+		char* const destination = GetData() + offset;
+		const char* const source = static_cast<const char*>(static_cast<const void*>(data.data()));
+
+		ParallelFor(nrOfSlices, nrOfThreads, [destination, source, firstSliceEnd, &data](size_t slice)
+			{
+				const size_t begin = slice == 0 ? 0 : firstSliceEnd + (slice - 1) * detail::ParallelWriteSliceSize;
+				const size_t end = std::min(data.size(), slice == 0 ? firstSliceEnd : begin + detail::ParallelWriteSliceSize);
+
+				CopyBytes(destination + begin, source + begin, end - begin, data.size());
+			});
+
+		return true;
+	}
+
+	template<FileAccessMode Access>
+	bool BasicFileView<Access>::ReadV(std::span<const IoRange> ranges, bool autoGrowFileMapping /* = true */, size_t nrOfThreads /* = 1 */)
+	{
+		// Validate every range before touching any of them, so a failing call leaves all buffers untouched
+		size_t end{};
+		for (const IoRange& range : ranges)
+		{
+			// Written so that 'offset + size' can not overflow
+			if (range.offset > m_filesize || range.size > m_filesize - range.offset)
+			{
+				std::cerr << "FileView::ReadV > Cannot read past EOF\n";
+				return false;
+			}
+
+			end = std::max(end, range.offset + range.size);
+		}
+
+		RAPIDIO_TRACE_SCOPE("ReadV", 0, end);
+
+		if (end > GetMappedSize())
+		{
+			if (!autoGrowFileMapping)
+			{
+				std::cerr << "FileView::ReadV > Reading " << end << " bytes would read past Mapped View!\n";
+				return false;
+			}
+
+			// Same growth policy as 'Read()', but only once for the whole batch
+			if (!ReallocateFileMapping(std::min(end * 2, m_filesize)))
+			{
+				return false;
+			}
+		}
+
+		const char* const data = GetData();
+		detail::ForEachRangeChunk(ranges, nrOfThreads, [data, ranges](size_t index, size_t offset, size_t size)
+			{
+				const IoRange& range = ranges[index];
+				CopyBytes(static_cast<char*>(range.buffer) + offset, data + range.offset + offset, size, range.size);
+			});
+
+		return true;
+	}
+
+	template<FileAccessMode Access>
+	bool BasicFileView<Access>::WriteV(std::span<const ConstIoRange> ranges, bool autoGrowFile /* = true */, bool autoGrowFileMapping /* = true */,
+		size_t nrOfThreads /* = 1 */) requires (Access == FileAccessMode::ReadWrite)
+	{
+		if (IsReadOnly())
+		{
+			std::cerr << "FileView::WriteV > Cannot write to read-only mapping\n";
+			return false;
+		}
+
+		size_t end{};
+		for (const ConstIoRange& range : ranges)
+		{
+			if (range.size > std::numeric_limits<size_t>::max() - range.offset)
+			{
+				std::cerr << "FileView::WriteV > size of data + offset overflows\n";
+				return false;
+			}
+
+			end = std::max(end, range.offset + range.size);
+		}
+
+		RAPIDIO_TRACE_SCOPE("WriteV", 0, end);
+
+		if (end > m_filesize && !autoGrowFile)
+		{
+			std::cerr << "FileView::WriteV > size of data + offset is bigger than filesize with autogrow disabled!\n";
+			return false;
+		}
+
+		if (end > GetMappedSize() && !autoGrowFileMapping)
+		{
+			std::cerr << "FileView::WriteV > size of data + offset is bigger than mapped view of file with autogrow disabled!\n";
+			return false;
+		}
+
+		if (!Reserve(end))
+		{
+			return false;
+		}
+
+		char* const data = GetData();
+		detail::ForEachRangeChunk(ranges, nrOfThreads, [data, ranges](size_t index, size_t offset, size_t size)
+			{
+				const ConstIoRange& range = ranges[index];
+				CopyBytes(data + range.offset + offset, static_cast<const char*>(range.buffer) + offset, size, range.size);
+			});
+
+		return true;
+	}
+
+	template<FileAccessMode Access>
+	bool BasicFileView<Access>::CopyRange(size_t offset, BasicFileView<FileAccessMode::ReadWrite>& destination, size_t destinationOffset, size_t size,
+		bool allowBlockClone /* = true */)
+	{
+		RAPIDIO_TRACE_SCOPE("CopyRange", offset, size);
+
+		if (static_cast<const void*>(&destination) == static_cast<const void*>(this))
+		{
+			std::cerr << "FileView::CopyRange > Cannot copy a view onto itself\n";
+			return false;
+		}
+
+		if (offset > m_filesize || size > m_filesize - offset)
+		{
+			std::cerr << "FileView::CopyRange > Range is past EOF\n";
+			return false;
+		}
+
+		if (size == 0)
+		{
+			return true;
+		}
+
+		FileRange cloned{ offset, 0 };
+		if (allowBlockClone)
+		{
+			// The file system clones what is on disk, so dirty pages of our view have to be written back first. Only the clusters that will be
+			// cloned are flushed, and only if the volume can clone at all
+			const FileRange cloneable = destination.GetCloneableRange(*this, offset, destinationOffset, size);
+			if (cloneable.size > 0 && Flush(cloneable) && destination.CloneFrom(*this, cloneable.offset, destinationOffset + (cloneable.offset - offset), cloneable.size))
+			{
+				cloned = cloneable;
+			}
+		}
+
+		if (cloned.size == size)
+		{
+			return true;
+		}
+
+		if (!Reserve(offset + size) || !destination.Reserve(destinationOffset + size))
+		{
+			return false;
 		}
 
-		std::memcpy(static_cast<char*>(m_mappedViewHandle.Get()) + offset, static_cast<const void*>(data.data()), data.size());
+		// Whatever could not be cloned, the unaligned head and tail or the entire range
+		const char* const source = GetData() + offset;
+		char* const target = destination.GetData() + destinationOffset;
+		const size_t headSize = cloned.offset - offset;
+		const size_t tailOffset = headSize + cloned.size;
+
+		StreamingCopy(target, source, headSize);
+		StreamingCopy(target + tailOffset, source + tailOffset, size - tailOffset);
+
 		return true;
 	}
 
-	FileView::FileView(const std::string& filepath, const FileAccessMode accessMode)
+	template<FileAccessMode Access>
+	bool BasicFileView<Access>::CopyTo(BasicFileView<FileAccessMode::ReadWrite>& destination, bool allowBlockClone /* = true */)
+	{
+		return CopyRange(0, destination, 0, m_filesize, allowBlockClone);
+	}
+
+	template<FileAccessMode Access>
+	template<FileAccessMode SourceAccess>
+	FileRange BasicFileView<Access>::GetCloneableRange(const BasicFileView<SourceAccess>& source, size_t sourceOffset, size_t offset, size_t size) const
+		requires (Access == FileAccessMode::ReadWrite)
+	{
+		// Only ReFS reports a cluster size this way. Every other file system fails here, and is copied through the mapped views instead
+		FSCTL_GET_INTEGRITY_INFORMATION_BUFFER integrity{};
+		DWORD bytesReturned{};
+
+		if (IsAddressStable() || !DeviceIoControl(source.m_fileHandle.Get(), FSCTL_GET_INTEGRITY_INFORMATION, nullptr, 0, &integrity, sizeof(integrity),
+			&bytesReturned, nullptr))
+		{
+			// Not being able to clone is expected, the error must not be picked up by the next Win32 call
+			SetLastError(ERROR_SUCCESS);
+			return { sourceOffset, 0 };
+		}
+
+		// Clusters can only be cloned onto clusters, so both ranges need the same offset inside a cluster
+		const size_t clusterSize = integrity.ClusterSizeInBytes;
+		if (clusterSize == 0 || sourceOffset % clusterSize != offset % clusterSize)
+		{
+			return { sourceOffset, 0 };
+		}
+
+		const size_t cloneBegin = (sourceOffset + clusterSize - 1) / clusterSize * clusterSize;
+		const size_t cloneEnd = (sourceOffset + size) / clusterSize * clusterSize;
+		if (cloneBegin >= cloneEnd)
+		{
+			return { sourceOffset, 0 };
+		}
+
+		return { cloneBegin, cloneEnd - cloneBegin };
+	}
+
+	template<FileAccessMode Access>
+	template<FileAccessMode SourceAccess>
+	bool BasicFileView<Access>::CloneFrom(const BasicFileView<SourceAccess>& source, size_t sourceOffset, size_t offset, size_t size)
+		requires (Access == FileAccessMode::ReadWrite)
+	{
+		RAPIDIO_TRACE_SCOPE("Clone", sourceOffset, size);
+
+		// The file system refuses to clone into a file with a mapped view, and only clones inside the current size of the file
+		m_mappedViewHandle.Release();
+		m_fileMappingHandle.Release();
+
+		bool isCloned = true;
+		if (offset + size > m_filesize)
+		{
+			LARGE_INTEGER newSize{};
+			newSize.QuadPart = static_cast<LONGLONG>(offset + size);
+
+			isCloned = CALL_WIN32_RV(SetFilePointerEx(m_fileHandle.Get(), newSize, nullptr, FILE_BEGIN)) != 0 && CALL_WIN32_RV(SetEndOfFile(m_fileHandle.Get())) != 0;
+			if (isCloned)
+			{
+				m_filesize = offset + size;
+			}
+		}
+
+		// A single clone can not be 4 GB or larger, 2 GB is a multiple of every cluster size
+		constexpr size_t MaxCloneSize = 1ull << 31;
+		DWORD bytesReturned{};
+
+		for (size_t clonedSize{}; isCloned && clonedSize < size;)
+		{
+			const size_t chunkSize = std::min(MaxCloneSize, size - clonedSize);
+
+			DUPLICATE_EXTENTS_DATA extents{};
+			extents.FileHandle = source.m_fileHandle.Get();
+			extents.SourceFileOffset.QuadPart = static_cast<LONGLONG>(sourceOffset + clonedSize);
+			extents.TargetFileOffset.QuadPart = static_cast<LONGLONG>(offset + clonedSize);
+			extents.ByteCount.QuadPart = static_cast<LONGLONG>(chunkSize);
+
+			isCloned = DeviceIoControl(m_fileHandle.Get(), FSCTL_DUPLICATE_EXTENTS_TO_FILE, &extents, sizeof(extents), nullptr, 0, &bytesReturned, nullptr) != 0;
+			clonedSize += chunkSize;
+		}
+
+		SetLastError(ERROR_SUCCESS);
+
+		CreateFileMappingHandle(m_fileMappingSize > 0 ? std::max(m_fileMappingSize, m_filesize) : 0);
+		CreateMapViewOfFile(0, 0);
+
+		if (!(m_fileMappingHandle.IsValid() && m_mappedViewHandle.IsValid()))
+		{
+			std::cerr << "FileView::CopyRange > Could not map the file again after cloning\n";
+			return false;
+		}
+
+		// A partially cloned range is copied again in its entirety
+		return isCloned;
+	}
+
+	template<FileAccessMode Access>
+	BasicFileView<Access>::BasicFileView(const std::string& filepath, const FileAccessMode accessMode)
 		: m_filepath(filepath)
 		, m_accessMode(accessMode)
 	{
 	}
 
-	bool FileView::OpenFile(const FileAccessMode accessMode, const FileOpenMode OpenMode)
+	template<FileAccessMode Access>
+	bool BasicFileView<Access>::OpenFile(const FileAccessMode accessMode, const FileOpenMode OpenMode)
 	{
+		RAPIDIO_TRACE_SCOPE("Open", 0, 0);
+
 		const bool doesFileExist = PathUtils::DoesFileExist(m_filepath);
 
 		DWORD errorToIgnore{};
@@ -283,7 +819,7 @@ namespace rapidio
 				break;
 		}
 
-		m_fileHandle = CALL_WIN32_RV_IGNORE_ERROR
+		m_fileHandle = Win32Handle{ CALL_WIN32_RV_IGNORE_ERROR
 		(
 			CreateFileA
 			(
@@ -296,47 +832,52 @@ namespace rapidio
 				nullptr
 			),
 			errorToIgnore
-		);
+		) };
 
-		return m_fileHandle != nullptr;
+		return m_fileHandle.IsValid();
 	}
 
-	bool FileView::GetFilesize()
+	template<FileAccessMode Access>
+	bool BasicFileView<Access>::GetFilesize()
 	{
 		LARGE_INTEGER filesize;
-		const BOOL Ret{ CALL_WIN32_RV(GetFileSizeEx(static_cast<void*>(m_fileHandle), &filesize)) };
+		const BOOL Ret{ CALL_WIN32_RV(GetFileSizeEx(m_fileHandle.Get(), &filesize)) };
 		m_filesize = static_cast<size_t>(filesize.QuadPart);
 		return Ret != 0;
 	}
 
-	void FileView::CreateFileMappingHandle(size_t size)
+	template<FileAccessMode Access>
+	void BasicFileView<Access>::CreateFileMappingHandle(size_t size)
 	{
-		if (m_accessMode == FileAccessMode::ReadOnly)
+		RAPIDIO_TRACE_SCOPE("CreateFileMapping", 0, size);
+
+		if (IsReadOnly())
 		{
-			assert(size < m_filesize);
+			assert(size <= m_filesize);
 		}
 
 		m_fileMappingSize = size;
 
-		m_fileMappingHandle = CALL_WIN32_RV
+		m_fileMappingHandle = Win32Handle{ CALL_WIN32_RV
 		(
 			CreateFileMappingA
 			(
-				static_cast<void*>(m_fileHandle),
+				m_fileHandle.Get(),
 				nullptr,
-				m_accessMode == FileAccessMode::ReadOnly ? PAGE_READONLY : PAGE_READWRITE,
+				IsReadOnly() ? PAGE_READONLY : PAGE_READWRITE,
 				detail::GetHighDWORD(size), // If 'size' is 0, we read the entire file
 				detail::GetLowDWORD(size),
 				"") // [TODO]: assign a name here to ensure we don't re-create file mappings
-		);
+		) };
 	}
 
-	bool FileView::CreateNewFileMappingHandle(size_t size)
+	template<FileAccessMode Access>
+	bool BasicFileView<Access>::CreateNewFileMappingHandle(size_t size)
 	{
 		m_fileMappingSize = size;
 		m_filesize = size;
 
-		m_fileMappingHandle = CALL_WIN32_RV
+		m_fileMappingHandle = Win32Handle{ CALL_WIN32_RV
 		(
 			CreateFileMappingA
 			(
@@ -346,13 +887,16 @@ namespace rapidio
 				detail::GetHighDWORD(size), // How big should our file be?
 				detail::GetLowDWORD(size), // How big should our file be?
 				"") // [TODO]: assign a name here to ensure we don't re-create file mappings
-		);
+		) };
 
-		return m_fileMappingHandle != nullptr;
+		return m_fileMappingHandle.IsValid();
 	}
 
-	void FileView::CreateMapViewOfFile(size_t size, size_t offset)
+	template<FileAccessMode Access>
+	void BasicFileView<Access>::CreateMapViewOfFile(size_t size, size_t offset)
 	{
+		RAPIDIO_TRACE_SCOPE("Map", offset, size);
+
 		// File offset must be a multiple of system allocation granularity
 		const size_t filemapViewOffset = offset / m_allocationGranularity * m_allocationGranularity;
 
@@ -361,37 +905,697 @@ namespace rapidio
 			size = 0;
 		}
 
-		m_mappedViewHandle = { CALL_WIN32_RV
+		m_mappedViewHandle = Win32MappedView{ CALL_WIN32_RV
 		(
 			MapViewOfFile
 			(
-				static_cast<void*>(m_fileMappingHandle),
-				m_accessMode == FileAccessMode::ReadOnly ? FILE_MAP_READ : FILE_MAP_WRITE,
+				m_fileMappingHandle.Get(),
+				IsReadOnly() ? FILE_MAP_READ : FILE_MAP_WRITE,
 				detail::GetHighDWORD(filemapViewOffset),
 				detail::GetLowDWORD(filemapViewOffset),
 				size // 0 means it will create a view of the entire mapped file
 			)
-		), [](void* handle) { return CALL_WIN32_RV(UnmapViewOfFile(handle)) != 0; } };
+		) };
+
+		if (!m_mappedViewHandle.IsValid())
+		{
+			m_mappedViewSize = 0;
+		}
+		else if (size > 0)
+		{
+			m_mappedViewSize = size;
+		}
+		else
+		{
+			m_mappedViewSize = (m_fileMappingSize > 0 ? m_fileMappingSize : m_filesize) - filemapViewOffset;
+		}
 	}
 
-	size_t FileView::GetSystemAllocationGranularity()
+	template<FileAccessMode Access>
+	size_t BasicFileView<Access>::GetSystemAllocationGranularity()
 	{
 		SYSTEM_INFO SystemInfo;
 		CALL_WIN32(GetNativeSystemInfo(&SystemInfo));
 		return SystemInfo.dwAllocationGranularity;
 	}
 
-	bool FileView::ReallocateFileMapping(size_t newSize)
+	template<FileAccessMode Access>
+	size_t BasicFileView<Access>::GetSystemPageSize()
 	{
-		if (!PathUtils::DoesFileExist(m_filepath))
+		SYSTEM_INFO SystemInfo;
+		CALL_WIN32(GetNativeSystemInfo(&SystemInfo));
+		return SystemInfo.dwPageSize;
+	}
+
+	template<FileAccessMode Access>
+	bool BasicFileView<Access>::Reserve(size_t size)
+	{
+		if (size <= GetMappedSize())
 		{
-			std::cerr << "Can only grow file mapping of existing files\n";
+			return true;
+		}
+
+		if (IsReadOnly() && size > m_filesize)
+		{
+			std::cerr << "FileView::Reserve > Cannot grow a read-only file\n";
 			return false;
 		}
 
-		// Release our Map and MapView
-		m_mappedViewHandle.Release();
-		m_fileMappingHandle.Release();
+		if (!ReallocateFileMapping(size))
+		{
+			return false;
+		}
+
+		m_filesize = std::max(m_filesize, size);
+		return true;
+	}
+
+	template<FileAccessMode Access>
+	bool BasicFileView<Access>::ReserveAddressSpace(size_t size) requires (Access == FileAccessMode::ReadWrite)
+	{
+		if (IsReadOnly())
+		{
+			std::cerr << "FileView::ReserveAddressSpace > Cannot grow a read-only file\n";
+			return false;
+		}
+
+		if (size <= GetReservedAddressSpace())
+		{
+			return true;
+		}
+
+		return MapIntoReservation(std::max(size, GetMappedSize()), GetMappedSize());
+	}
+
+	template<FileAccessMode Access>
+	size_t BasicFileView<Access>::GetReservedAddressSpace() const
+	{
+		return m_placeholderMapping.GetReservedSize();
+	}
+
+	template<FileAccessMode Access>
+	std::optional<size_t> BasicFileView<Access>::Find(std::string_view pattern, size_t from /* = 0 */, size_t nrOfThreads /* = 1 */) const
+	{
+		const size_t mappedSize = GetMappedSize();
+		if (from > mappedSize || pattern.size() > mappedSize - from)
+		{
+			return std::nullopt;
+		}
+
+		const std::string_view data{ GetData(), mappedSize };
+		const size_t nrOfChunksPerWindow = GetThreadCount(nrOfThreads);
+
+		if (nrOfChunksPerWindow == 1)
+		{
+			const size_t match = FindPattern(data.substr(from), pattern);
+			return match == std::string_view::npos ? std::nullopt : std::optional<size_t>(from + match);
+		}
+
+		// Search a window of one chunk per thread at a time, so an early match does not pay for searching the entire view
+		const size_t lastStart = mappedSize - pattern.size();
+		for (size_t windowStart = from; windowStart <= lastStart; windowStart += nrOfChunksPerWindow * detail::SearchChunkSize)
+		{
+			std::vector<size_t> chunkMatches(nrOfChunksPerWindow, std::string_view::npos);
+
+			ParallelFor(nrOfChunksPerWindow, nrOfThreads, [&](size_t chunk)
+				{
+					const size_t chunkStart = windowStart + chunk * detail::SearchChunkSize;
+					if (chunkStart > lastStart)
+					{
+						return;
+					}
+
+					// Chunks overlap by the pattern size - 1, so matches crossing a chunk boundary are found by the chunk they start in
+					const size_t chunkEnd = std::min(lastStart + 1, chunkStart + detail::SearchChunkSize);
+					const size_t match = FindPattern(data.substr(chunkStart, chunkEnd - chunkStart + pattern.size() - 1), pattern);
+					if (match != std::string_view::npos)
+					{
+						chunkMatches[chunk] = chunkStart + match;
+					}
+				});
+
+			const size_t match = *std::min_element(chunkMatches.begin(), chunkMatches.end());
+			if (match != std::string_view::npos)
+			{
+				return match;
+			}
+		}
+
+		return std::nullopt;
+	}
+
+	template<FileAccessMode Access>
+	std::vector<size_t> BasicFileView<Access>::FindAll(std::string_view pattern, FileRange range /* = {} */, size_t nrOfThreads /* = 0 */) const
+	{
+		if (pattern.empty() || !ClampRange(range))
+		{
+			return {};
+		}
+
+		const std::string_view data{ GetData(), GetMappedSize() };
+		const size_t nrOfChunks = (range.size + detail::SearchChunkSize - 1) / detail::SearchChunkSize;
+		std::vector<std::vector<size_t>> chunkMatches(nrOfChunks);
+
+		ParallelFor(nrOfChunks, nrOfThreads, [&](size_t chunk)
+			{
+				const size_t chunkStart = range.offset + chunk * detail::SearchChunkSize;
+				const size_t chunkEnd = std::min(range.offset + range.size, chunkStart + detail::SearchChunkSize);
+
+				// Matches starting in this chunk may extend past its end
+				const std::string_view haystack = data.substr(chunkStart, chunkEnd - chunkStart + pattern.size() - 1);
+
+				for (size_t position{}; position < chunkEnd - chunkStart;)
+				{
+					const size_t match = FindPattern(haystack.substr(position), pattern);
+					if (match == std::string_view::npos || position + match >= chunkEnd - chunkStart)
+					{
+						break;
+					}
+
+					chunkMatches[chunk].push_back(chunkStart + position + match);
+					position += match + 1;
+				}
+			});
+
+		std::vector<size_t> matches;
+		for (const std::vector<size_t>& chunk : chunkMatches)
+		{
+			matches.insert(matches.end(), chunk.begin(), chunk.end());
+		}
+
+		return matches;
+	}
+
+	template<FileAccessMode Access>
+	std::vector<PatternMatch> BasicFileView<Access>::FindAny(std::span<const std::string_view> patterns, FileRange range /* = {} */, size_t nrOfThreads /* = 0 */) const
+	{
+		const detail::PatternSet patternSet{ patterns };
+		if (patternSet.longestPattern == 0 || !ClampRange(range))
+		{
+			return {};
+		}
+
+		const std::string_view data{ GetData(), GetMappedSize() };
+		const size_t nrOfChunks = (range.size + detail::SearchChunkSize - 1) / detail::SearchChunkSize;
+		std::vector<std::vector<PatternMatch>> chunkMatches(nrOfChunks);
+
+		ParallelFor(nrOfChunks, nrOfThreads, [&](size_t chunk)
+			{
+				const size_t chunkStart = range.offset + chunk * detail::SearchChunkSize;
+				const size_t chunkSize = std::min(range.offset + range.size, chunkStart + detail::SearchChunkSize) - chunkStart;
+
+				patternSet.FindAll(data.substr(chunkStart, chunkSize + patternSet.longestPattern - 1), chunkSize, chunkStart, chunkMatches[chunk]);
+			});
+
+		std::vector<PatternMatch> matches;
+		for (const std::vector<PatternMatch>& chunk : chunkMatches)
+		{
+			matches.insert(matches.end(), chunk.begin(), chunk.end());
+		}
+
+		return matches;
+	}
+
+	template<FileAccessMode Access>
+	std::optional<uint32_t> BasicFileView<Access>::Checksum(FileRange range /* = {} */, size_t nrOfThreads /* = 0 */) const
+	{
+		if (!ClampRange(range))
+		{
+			std::cerr << "FileView::Checksum > Range starts past end of Mapped View\n";
+			return std::nullopt;
+		}
+
+		const char* const data = GetData() + range.offset;
+		const size_t nrOfChunks = (range.size + detail::ChecksumChunkSize - 1) / detail::ChecksumChunkSize;
+
+		if (nrOfChunks <= 1)
+		{
+			return Crc32c(data, range.size);
+		}
+
+		std::vector<uint32_t> chunkChecksums(nrOfChunks);
+		ParallelFor(nrOfChunks, nrOfThreads, [data, &range, &chunkChecksums](size_t chunk)
+			{
+				const size_t offset = chunk * detail::ChecksumChunkSize;
+				chunkChecksums[chunk] = Crc32c(data + offset, std::min(detail::ChecksumChunkSize, range.size - offset));
+			});
+
+		uint32_t checksum = chunkChecksums[0];
+		for (size_t chunk{ 1 }; chunk < nrOfChunks; ++chunk)
+		{
+			checksum = Crc32cCombine(checksum, chunkChecksums[chunk], std::min(detail::ChecksumChunkSize, range.size - chunk * detail::ChecksumChunkSize));
+		}
+
+		return checksum;
+	}
+
+	template<FileAccessMode Access>
+	std::optional<size_t> BasicFileView<Access>::ValidateUtf8(FileRange range /* = {} */, size_t nrOfThreads /* = 0 */) const
+	{
+		if (!ClampRange(range))
+		{
+			std::cerr << "FileView::ValidateUtf8 > Range starts past end of Mapped View\n";
+			return range.offset;
+		}
+
+		RAPIDIO_TRACE_SCOPE("ValidateUtf8", range.offset, range.size);
+
+		const std::string_view text{ GetData() + range.offset, range.size };
+		const size_t nrOfChunks = (range.size + detail::TextChunkSize - 1) / detail::TextChunkSize;
+
+		if (nrOfChunks <= 1)
+		{
+			const size_t invalid = FindInvalidUtf8(text);
+			return invalid == std::string_view::npos ? std::nullopt : std::optional<size_t>{ range.offset + invalid };
+		}
+
+		// Chunks are moved onto sequence boundaries, so every chunk can be validated on its own. The first chunk with an error has the answer,
+		// so chunks after it do not have to be validated anymore
+		std::atomic<size_t> firstInvalidChunk{ nrOfChunks };
+		std::vector<size_t> chunkInvalid(nrOfChunks, std::string_view::npos);
+
+		ParallelFor(nrOfChunks, nrOfThreads, [&text, &firstInvalidChunk, &chunkInvalid](size_t chunk)
+			{
+				if (chunk > firstInvalidChunk.load(std::memory_order_relaxed))
+				{
+					return;
+				}
+
+				const size_t begin = GetUtf8SplitPosition(text, chunk * detail::TextChunkSize);
+				const size_t end = GetUtf8SplitPosition(text, std::min(text.size(), (chunk + 1) * detail::TextChunkSize));
+				if (begin >= end)
+				{
+					return;
+				}
+
+				const size_t invalid = FindInvalidUtf8(text.substr(begin, end - begin));
+				if (invalid == std::string_view::npos)
+				{
+					return;
+				}
+
+				chunkInvalid[chunk] = begin + invalid;
+
+				size_t known = firstInvalidChunk.load(std::memory_order_relaxed);
+				while (chunk < known && !firstInvalidChunk.compare_exchange_weak(known, chunk, std::memory_order_relaxed))
+				{
+				}
+			});
+
+		const size_t chunk = firstInvalidChunk.load();
+		return chunk == nrOfChunks ? std::nullopt : std::optional<size_t>{ range.offset + chunkInvalid[chunk] };
+	}
+
+	template<FileAccessMode Access>
+	std::optional<size_t> BasicFileView<Access>::NormalizeLineEndings(BasicFileView<FileAccessMode::ReadWrite>& destination,
+		size_t destinationOffset /* = 0 */, FileRange range /* = {} */, size_t nrOfThreads /* = 0 */)
+	{
+		if (static_cast<const void*>(&destination) == static_cast<const void*>(this))
+		{
+			std::cerr << "FileView::NormalizeLineEndings > Cannot copy a view onto itself\n";
+			return std::nullopt;
+		}
+
+		if (!ClampRange(range))
+		{
+			std::cerr << "FileView::NormalizeLineEndings > Range starts past end of Mapped View\n";
+			return std::nullopt;
+		}
+
+		RAPIDIO_TRACE_SCOPE("NormalizeLineEndings", range.offset, range.size);
+
+		const std::string_view text{ GetData() + range.offset, range.size };
+		const size_t nrOfChunks = (range.size + detail::TextChunkSize - 1) / detail::TextChunkSize;
+
+		auto getChunk = [&text](size_t chunk)
+		{
+			const size_t begin = chunk * detail::TextChunkSize;
+			return std::pair<size_t, size_t>{ begin, std::min(text.size(), begin + detail::TextChunkSize) };
+		};
+
+		// Pass 1: count the line endings of every chunk, so every chunk knows where its output starts
+		std::vector<size_t> outputOffsets(nrOfChunks + 1);
+		ParallelFor(nrOfChunks, nrOfThreads, [&text, &getChunk, &outputOffsets](size_t chunk)
+			{
+				const auto [begin, end] = getChunk(chunk);
+				size_t nrOfLineEndings{};
+				detail::ForEachCrlf(text, begin, end, [&nrOfLineEndings](size_t) { ++nrOfLineEndings; });
+
+				outputOffsets[chunk + 1] = end - begin - nrOfLineEndings;
+			});
+
+		for (size_t chunk{}; chunk < nrOfChunks; ++chunk)
+		{
+			outputOffsets[chunk + 1] += outputOffsets[chunk];
+		}
+
+		const size_t outputSize = outputOffsets.back();
+		if (outputSize == 0)
+		{
+			return 0;
+		}
+
+		if (!destination.Reserve(destinationOffset + outputSize))
+		{
+			return std::nullopt;
+		}
+
+		// Pass 2: copy the text between line endings, dropping the CR of every one
+		char* const output = destination.GetData() + destinationOffset;
+		ParallelFor(nrOfChunks, nrOfThreads, [&text, &getChunk, &outputOffsets, output](size_t chunk)
+			{
+				const auto [begin, end] = getChunk(chunk);
+				char* position = output + outputOffsets[chunk];
+				size_t copyFrom = begin;
+
+				detail::ForEachCrlf(text, begin, end, [&text, &position, &copyFrom](size_t carriageReturn)
+					{
+						std::memcpy(position, text.data() + copyFrom, carriageReturn - copyFrom);
+						position += carriageReturn - copyFrom;
+						copyFrom = carriageReturn + 1;
+					});
+
+				std::memcpy(position, text.data() + copyFrom, end - copyFrom);
+			});
+
+		return outputSize;
+	}
+
+	template<FileAccessMode Access>
+	bool BasicFileView<Access>::Flush(FileRange range /* = {} */)
+	{
+		if (!ClampRange(range))
+		{
+			std::cerr << "FileView::Flush > Range starts past end of Mapped View\n";
+			return false;
+		}
+
+		if (range.size == 0)
+		{
+			return true;
+		}
+
+		RAPIDIO_TRACE_SCOPE("Flush", range.offset, range.size);
+
+		// A flush can not cross views, which an address-stable view consists of
+		if (IsAddressStable())
+		{
+			return m_placeholderMapping.ForEachView(range.offset, range.size, [](char* data, size_t size)
+				{
+					return CALL_WIN32_RV(FlushViewOfFile(data, size)) != 0;
+				});
+		}
+
+		return CALL_WIN32_RV(FlushViewOfFile(GetData() + range.offset, range.size)) != 0;
+	}
+
+	template<FileAccessMode Access>
+	bool BasicFileView<Access>::Discard(FileRange range)
+	{
+		if (!ClampRange(range))
+		{
+			std::cerr << "FileView::Discard > Range starts past end of Mapped View\n";
+			return false;
+		}
+
+		// Only release pages that lie entirely inside the range, partial pages might still hold live data
+		const size_t pageSize = GetSystemPageSize();
+		const size_t start = (range.offset + pageSize - 1) / pageSize * pageSize;
+		const size_t end = (range.offset + range.size) / pageSize * pageSize;
+
+		if (start >= end)
+		{
+			return true;
+		}
+
+		// Unlocking pages that were never locked removes them from the working set, which is the Win32 equivalent of MADV_DONTNEED
+		if (IsAddressStable())
+		{
+			return m_placeholderMapping.ForEachView(start, end - start, [](char* data, size_t size)
+				{
+					CALL_WIN32_RV_IGNORE_ERROR(VirtualUnlock(data, size), ERROR_NOT_LOCKED);
+					return true;
+				});
+		}
+
+		CALL_WIN32_RV_IGNORE_ERROR(VirtualUnlock(const_cast<char*>(GetData()) + start, end - start), ERROR_NOT_LOCKED);
+		return true;
+	}
+
+	template<FileAccessMode Access>
+	bool BasicFileView<Access>::Prefetch(FileRange range)
+	{
+		if (!ClampRange(range))
+		{
+			std::cerr << "FileView::Prefetch > Range starts past end of Mapped View\n";
+			return false;
+		}
+
+		if (range.size == 0)
+		{
+			return true;
+		}
+
+		RAPIDIO_TRACE_SCOPE("Prefetch", range.offset, range.size);
+
+		// The Win32 equivalent of MADV_WILLNEED, the reads are issued asynchronously
+		WIN32_MEMORY_RANGE_ENTRY entry{ const_cast<char*>(GetData()) + range.offset, range.size };
+		return CALL_WIN32_RV(PrefetchVirtualMemory(GetCurrentProcess(), 1, &entry, 0)) != 0;
+	}
+
+	template<FileAccessMode Access>
+	ChunkView<Access> BasicFileView<Access>::Chunks(size_t chunkSize, bool releaseConsumedChunks /* = true */)
+	{
+		if (chunkSize == 0)
+		{
+			std::cerr << "FileView::Chunks > Chunk size cannot be 0\n";
+			return {};
+		}
+
+		// Growing the mapping while iterating would move the chunks that have already been handed out
+		if (!Reserve(m_filesize))
+		{
+			return {};
+		}
+
+		return ChunkView<Access>{ *this, m_filesize, chunkSize, releaseConsumedChunks };
+	}
+
+	template<FileAccessMode Access>
+	double BasicFileView<Access>::ResidentFraction(FileRange range /* = {} */) const
+	{
+		const std::vector<bool> bitmap = ResidencyBitmap(range);
+		if (bitmap.empty())
+		{
+			return 0.0;
+		}
+
+		const size_t nrOfResidentPages = std::count(bitmap.cbegin(), bitmap.cend(), true);
+		return static_cast<double>(nrOfResidentPages) / static_cast<double>(bitmap.size());
+	}
+
+	template<FileAccessMode Access>
+	std::vector<bool> BasicFileView<Access>::ResidencyBitmap(FileRange range /* = {} */) const
+	{
+		if (!ClampRange(range) || range.size == 0)
+		{
+			return {};
+		}
+
+		const size_t pageSize = GetSystemPageSize();
+		const size_t firstPage = range.offset / pageSize;
+		const size_t nrOfPages = (range.offset + range.size + pageSize - 1) / pageSize - firstPage;
+		const char* const data = GetData();
+
+		std::vector<bool> bitmap(nrOfPages);
+
+		// QueryWorkingSetEx() takes one entry per page, so query in batches to keep the scratch buffer small
+		constexpr size_t BatchSize = 4096;
+		std::vector<PSAPI_WORKING_SET_EX_INFORMATION> entries(std::min(BatchSize, nrOfPages));
+
+		for (size_t batchStart{}; batchStart < nrOfPages; batchStart += BatchSize)
+		{
+			const size_t batchSize = std::min(BatchSize, nrOfPages - batchStart);
+
+			for (size_t i{}; i < batchSize; ++i)
+			{
+				entries[i].VirtualAddress = const_cast<char*>(data) + (firstPage + batchStart + i) * pageSize;
+			}
+
+			if (CALL_WIN32_RV(QueryWorkingSetEx(GetCurrentProcess(), entries.data(), static_cast<DWORD>(batchSize * sizeof(PSAPI_WORKING_SET_EX_INFORMATION)))) == 0)
+			{
+				std::cerr << "FileView::ResidencyBitmap > Could not query the working set\n";
+				return {};
+			}
+
+			for (size_t i{}; i < batchSize; ++i)
+			{
+				bitmap[batchStart + i] = entries[i].VirtualAttributes.Valid != 0;
+			}
+		}
+
+		return bitmap;
+	}
+
+	template<FileAccessMode Access>
+	bool BasicFileView<Access>::Warm(FileRange range /* = {} */, size_t nrOfThreads /* = 0 */, const std::function<void(size_t, size_t)>& progress /* = {} */)
+	{
+		if (!ClampRange(range))
+		{
+			std::cerr << "FileView::Warm > Range starts past end of Mapped View\n";
+			return false;
+		}
+
+		std::vector<FileRange> chunks;
+		chunks.reserve(range.size / detail::WarmChunkSize + 1);
+
+		for (size_t offset{}; offset < range.size; offset += detail::WarmChunkSize)
+		{
+			chunks.push_back({ range.offset + offset, std::min(detail::WarmChunkSize, range.size - offset) });
+		}
+
+		return WarmRanges(chunks, nrOfThreads, progress);
+	}
+
+	template<FileAccessMode Access>
+	bool BasicFileView<Access>::SaveResidency(const std::filesystem::path& sidecarPath) const
+	{
+		const std::vector<bool> bitmap = ResidencyBitmap();
+		if (bitmap.empty())
+		{
+			std::cerr << "FileView::SaveResidency > Could not query residency of " << m_filepath << "\n";
+			return false;
+		}
+
+		detail::ResidencySidecarHeader header{};
+		std::memcpy(header.magic, detail::ResidencySidecarMagic, sizeof(header.magic));
+		header.version = detail::ResidencySidecarVersion;
+		header.pageSize = static_cast<uint32_t>(GetSystemPageSize());
+		header.mappedSize = GetMappedSize();
+		header.nrOfPages = bitmap.size();
+
+		// One bit per page
+		std::string data(sizeof(header) + (bitmap.size() + 7) / 8, '\0');
+		std::memcpy(data.data(), &header, sizeof(header));
+
+		for (size_t i{}; i < bitmap.size(); ++i)
+		{
+			if (bitmap[i])
+			{
+				data[sizeof(header) + i / 8] |= static_cast<char>(1 << (i % 8));
+			}
+		}
+
+		if (PathUtils::DoesFileExist(sidecarPath))
+		{
+			std::filesystem::remove(sidecarPath);
+		}
+
+		std::optional<FileView> sidecar = FileView::CreateViewForNewFile(sidecarPath, data.size());
+		return sidecar && sidecar->Write(data, 0, false, false);
+	}
+
+	template<FileAccessMode Access>
+	bool BasicFileView<Access>::ReplayResidency(const std::filesystem::path& sidecarPath, size_t nrOfThreads /* = 0 */,
+		const std::function<void(size_t, size_t)>& progress /* = {} */)
+	{
+		std::optional<ReadOnlyFileView> sidecar = ReadOnlyFileView::CreateViewFromExistingFile(sidecarPath, FileOpenMode::OpenExisting);
+		if (!sidecar)
+		{
+			return false;
+		}
+
+		const std::string headerData = sidecar->Read(sizeof(detail::ResidencySidecarHeader));
+		if (headerData.size() != sizeof(detail::ResidencySidecarHeader))
+		{
+			std::cerr << "FileView::ReplayResidency > " << sidecarPath << " is not a residency sidecar file\n";
+			return false;
+		}
+
+		detail::ResidencySidecarHeader header;
+		std::memcpy(&header, headerData.data(), sizeof(header));
+
+		if (std::memcmp(header.magic, detail::ResidencySidecarMagic, sizeof(header.magic)) != 0 || header.version != detail::ResidencySidecarVersion)
+		{
+			std::cerr << "FileView::ReplayResidency > " << sidecarPath << " is not a residency sidecar file\n";
+			return false;
+		}
+
+		if (header.pageSize != GetSystemPageSize() || header.mappedSize != GetMappedSize())
+		{
+			std::cerr << "FileView::ReplayResidency > " << sidecarPath << " was recorded for a different mapping\n";
+			return false;
+		}
+
+		const std::string bitmap = sidecar->Read((header.nrOfPages + 7) / 8);
+		if (bitmap.size() != (header.nrOfPages + 7) / 8)
+		{
+			std::cerr << "FileView::ReplayResidency > " << sidecarPath << " is truncated\n";
+			return false;
+		}
+
+		// Merge runs of resident pages, splitting them into chunks so they can be spread over threads
+		const size_t pageSize = header.pageSize;
+		const size_t pagesPerChunk = std::max<size_t>(1, detail::WarmChunkSize / pageSize);
+		std::vector<FileRange> ranges;
+
+		for (size_t page{}; page < header.nrOfPages;)
+		{
+			if (!(bitmap[page / 8] & (1 << (page % 8))))
+			{
+				++page;
+				continue;
+			}
+
+			const size_t firstPage = page;
+			while (page < header.nrOfPages && page - firstPage < pagesPerChunk && (bitmap[page / 8] & (1 << (page % 8))))
+			{
+				++page;
+			}
+
+			const size_t offset = firstPage * pageSize;
+			ranges.push_back({ offset, std::min((page - firstPage) * pageSize, GetMappedSize() - offset) });
+		}
+
+		return WarmRanges(ranges, nrOfThreads, progress);
+	}
+
+	template<FileAccessMode Access>
+	bool BasicFileView<Access>::ReallocateFileMapping(size_t newSize)
+	{
+		if (!PathUtils::DoesFileExist(m_filepath))
+		{
+			std::cerr << "Can only grow file mapping of existing files\n";
+			return false;
+		}
+
+		if constexpr (Access == FileAccessMode::ReadWrite)
+		{
+			if (IsAddressStable())
+			{
+				RAPIDIO_TRACE_SCOPE("Grow", GetMappedSize(), newSize - std::min(newSize, GetMappedSize()));
+
+				// Inside the reservation only the new bytes are mapped, past it the view moves into a reservation twice the size
+				const bool isGrown = newSize <= m_placeholderMapping.GetReservedSize() ? m_placeholderMapping.Extend(newSize) :
+					MapIntoReservation(std::max(newSize, m_placeholderMapping.GetReservedSize() * 2), newSize);
+
+				if (!isGrown)
+				{
+					std::cerr << "Could not grow FileMapping\n";
+					return false;
+				}
+
+				m_fileMappingSize = std::max(m_fileMappingSize, newSize);
+				m_mappedViewSize = std::max(m_mappedViewSize, newSize);
+				return true;
+			}
+		}
+
+		RAPIDIO_TRACE_SCOPE("Remap", 0, newSize);
+
+		// Release our Map and MapView
+		m_mappedViewHandle.Release();
+		m_fileMappingHandle.Release();
 
 		CreateFileMappingHandle(newSize);
 		CreateMapViewOfFile(0, 0);
@@ -405,7 +1609,8 @@ namespace rapidio
 		return true;
 	}
 
-	bool FileView::ReallocateMappedViewOfFile(size_t newSize)
+	template<FileAccessMode Access>
+	bool BasicFileView<Access>::ReallocateMappedViewOfFile(size_t newSize)
 	{
 		if (newSize > m_filesize)
 		{
@@ -424,4 +1629,207 @@ namespace rapidio
 
 		return true;
 	}
+
+	template<FileAccessMode Access>
+	bool BasicFileView<Access>::MapIntoReservation(size_t reservationSize, size_t mappedSize)
+		requires (Access == FileAccessMode::ReadWrite)
+	{
+		PlaceholderMapping placeholderMapping;
+		if (!placeholderMapping.Reserve(m_fileHandle.Get(), m_filesize, reservationSize) || !placeholderMapping.Extend(mappedSize))
+		{
+			return false;
+		}
+
+		// The old views are only released once the new ones are in place. The file is not trimmed, the new views still cover its padding
+		m_placeholderMapping.Release(false);
+		m_placeholderMapping = std::move(placeholderMapping);
+
+		m_mappedViewHandle.Release();
+		m_fileMappingHandle.Release();
+		m_fileMappingSize = mappedSize;
+		m_mappedViewSize = mappedSize;
+		return true;
+	}
+
+	template<FileAccessMode Access>
+	char* BasicFileView<Access>::GetData() requires (Access == FileAccessMode::ReadWrite)
+	{
+		return IsAddressStable() ? m_placeholderMapping.GetBase() : static_cast<char*>(m_mappedViewHandle.Get());
+	}
+
+	template<FileAccessMode Access>
+	const char* BasicFileView<Access>::GetData() const
+	{
+		return IsAddressStable() ? m_placeholderMapping.GetBase() : static_cast<const char*>(m_mappedViewHandle.Get());
+	}
+
+	template<FileAccessMode Access>
+	bool BasicFileView<Access>::IsReadOnly() const
+	{
+		if constexpr (Access == FileAccessMode::ReadOnly)
+		{
+			return true;
+		}
+		else
+		{
+			return m_accessMode == FileAccessMode::ReadOnly;
+		}
+	}
+
+	template<FileAccessMode Access>
+	bool BasicFileView<Access>::IsAddressStable() const
+	{
+		// Address space can only be reserved for writable views
+		if constexpr (Access == FileAccessMode::ReadOnly)
+		{
+			return false;
+		}
+		else
+		{
+			return m_placeholderMapping.IsReserved();
+		}
+	}
+
+	template<FileAccessMode Access>
+	size_t BasicFileView<Access>::GetMappedSize() const
+	{
+		return m_mappedViewSize;
+	}
+
+	template<FileAccessMode Access>
+	bool BasicFileView<Access>::ClampRange(FileRange& range) const
+	{
+		const size_t mappedSize = GetMappedSize();
+		if (range.offset > mappedSize)
+		{
+			return false;
+		}
+
+		range.size = std::min(range.size, mappedSize - range.offset);
+		return true;
+	}
+
+	template<FileAccessMode Access>
+	bool BasicFileView<Access>::WarmRanges(const std::vector<FileRange>& ranges, size_t nrOfThreads, const std::function<void(size_t, size_t)>& progress)
+	{
+		size_t totalBytes{};
+		for (const FileRange& range : ranges)
+		{
+			totalBytes += range.size;
+		}
+
+		RAPIDIO_TRACE_SCOPE("Warm", 0, totalBytes);
+
+		const size_t pageSize = GetSystemPageSize();
+		const char* const data = GetData();
+		std::atomic<size_t> warmedBytes{ 0 };
+		std::mutex progressMutex;
+
+		ParallelFor(ranges.size(), nrOfThreads, [&](size_t i)
+			{
+				const FileRange& range = ranges[i];
+
+				// Let the OS issue large reads for the whole range up front, instead of one fault per page
+				WIN32_MEMORY_RANGE_ENTRY entry{ const_cast<char*>(data) + range.offset, range.size };
+				CALL_WIN32(PrefetchVirtualMemory(GetCurrentProcess(), 1, &entry, 0));
+
+				// Touching every page makes sure it is actually part of our working set afterwards
+				const size_t firstPage = range.offset / pageSize * pageSize;
+				for (size_t offset = firstPage; offset < range.offset + range.size; offset += pageSize)
+				{
+					static_cast<void>(*static_cast<const volatile char*>(data + offset));
+				}
+
+				warmedBytes.fetch_add(range.size, std::memory_order_relaxed);
+				if (progress)
+				{
+					std::lock_guard lock(progressMutex);
+					progress(warmedBytes.load(std::memory_order_relaxed), totalBytes);
+				}
+			});
+
+		return true;
+	}
+
+	template<FileAccessMode Access>
+	ChunkIterator<Access>::ChunkIterator(BasicFileView<Access>* view, size_t size, size_t chunkSize, bool releaseConsumedChunks)
+		: m_view(view)
+		, m_size(size)
+		, m_chunkSize(chunkSize)
+		, m_releaseConsumedChunks(releaseConsumedChunks)
+	{
+		// The first chunk is needed right away, the one after it is read while the first is being processed
+		m_view->Prefetch({ 0, m_chunkSize * 2 });
+	}
+
+	template<FileAccessMode Access>
+	std::span<const char> ChunkIterator<Access>::operator*() const
+	{
+		const BasicFileView<Access>& view = *m_view;
+		return { view.GetData() + m_offset, std::min(m_chunkSize, m_size - m_offset) };
+	}
+
+	template<FileAccessMode Access>
+	ChunkIterator<Access>& ChunkIterator<Access>::operator++()
+	{
+		m_offset = std::min(m_size, m_offset + m_chunkSize);
+
+		// The page the new chunk starts on is kept, it can still hold the end of the chunk we just moved past
+		if (m_releaseConsumedChunks)
+		{
+			const size_t pageSize = BasicFileView<Access>::GetSystemPageSize();
+			const size_t releaseEnd = m_offset / pageSize * pageSize;
+
+			if (releaseEnd > m_releasedSize)
+			{
+				m_view->Discard({ m_releasedSize, releaseEnd - m_releasedSize });
+				m_releasedSize = releaseEnd;
+			}
+		}
+
+		if (m_offset + m_chunkSize < m_size)
+		{
+			m_view->Prefetch({ m_offset + m_chunkSize, m_chunkSize });
+		}
+
+		return *this;
+	}
+
+	template<FileAccessMode Access>
+	void ChunkIterator<Access>::operator++(int)
+	{
+		++*this;
+	}
+
+	template<FileAccessMode Access>
+	bool ChunkIterator<Access>::operator==(std::default_sentinel_t) const
+	{
+		return m_offset >= m_size;
+	}
+
+	template<FileAccessMode Access>
+	ChunkView<Access>::ChunkView(BasicFileView<Access>& view, size_t size, size_t chunkSize, bool releaseConsumedChunks)
+		: m_view(&view)
+		, m_size(size)
+		, m_chunkSize(chunkSize)
+		, m_releaseConsumedChunks(releaseConsumedChunks)
+	{
+	}
+
+	template<FileAccessMode Access>
+	ChunkIterator<Access> ChunkView<Access>::begin() const
+	{
+		if (!m_view || m_size == 0)
+		{
+			return {};
+		}
+
+		return ChunkIterator<Access>{ m_view, m_size, m_chunkSize, m_releaseConsumedChunks };
+	}
+
+	template<FileAccessMode Access>
+	std::default_sentinel_t ChunkView<Access>::end() const
+	{
+		return std::default_sentinel;
+	}
 } // namespace rapidio
\ No newline at end of file
@@ -4,9 +4,25 @@
 #include "PathUtils.hpp"
 
 #include <rapidio.hpp>
+#include <BlockChecksums.hpp>
+#include <DelimitedReader.hpp>
+#include <ExternalSort.hpp>
+#include <FollowView.hpp>
+#include <LineIndex.hpp>
+#include <FileBackedMemoryResource.hpp>
+#include <MappedArena.hpp>
+#include <PackFile.hpp>
+#include <SortedTable.hpp>
+#include <StreamReader.hpp>
+#include <WindowCache.hpp>
+#include <WriteBatch.hpp>
 
 #include <gtest/gtest.h>
 #include <fstream>
+#include <functional>
+#include <memory_resource>
+#include <unordered_map>
+#include <thread>
 
 namespace
 {
@@ -319,4 +335,1561 @@ namespace
 
 		EXPECT_TRUE(BigFileData.substr(allocationGranularity, allocationGranularity) == data);
 	}
+
+	TEST_F(RapidIOFixture, TestStreamReaderMapsRegularFile)
+	{
+		StreamReader reader = StreamReader::CreateFromFile(TmpDir / SIMPLE_FILE).value();
+
+		EXPECT_TRUE(reader.IsMapped());
+		EXPECT_EQ(reader.Read(5), "Hello");
+		EXPECT_EQ(reader.Read(666), " World!");
+		EXPECT_EQ(reader.Read(1), "");
+	}
+
+	TEST_F(RapidIOFixture, TestStreamReaderFromPipe)
+	{
+		const std::string pipeName = "\\\\.\\pipe\\rapidiotest" + std::to_string(rand());
+		HANDLE pipe = CreateNamedPipeA(pipeName.c_str(), PIPE_ACCESS_OUTBOUND, PIPE_TYPE_BYTE | PIPE_WAIT, 1, 4096, 4096, 0, nullptr);
+		ASSERT_NE(pipe, INVALID_HANDLE_VALUE);
+
+		std::string expected;
+		for (int i{}; i < 100'000; ++i)
+		{
+			expected += std::to_string(i);
+		}
+
+		std::thread writer([pipe, &expected]()
+			{
+				if (ConnectNamedPipe(pipe, nullptr) || GetLastError() == ERROR_PIPE_CONNECTED)
+				{
+					// Write in small, odd-sized pieces so reads straddle the read-ahead buffers
+					for (size_t offset{}; offset < expected.size(); offset += 1000)
+					{
+						DWORD written{};
+						WriteFile(pipe, expected.data() + offset, static_cast<DWORD>(std::min<size_t>(1000, expected.size() - offset)), &written, nullptr);
+					}
+
+					FlushFileBuffers(pipe);
+					DisconnectNamedPipe(pipe);
+				}
+			});
+
+		{
+			// Small buffers force the ring to wrap around many times
+			StreamReader reader = StreamReader::CreateFromFile(pipeName, 1024, 3).value();
+			EXPECT_FALSE(reader.IsMapped());
+
+			std::string actual;
+			while (true)
+			{
+				const std::string data = reader.Read(777);
+				if (data.empty())
+				{
+					break;
+				}
+
+				actual += data;
+			}
+
+			EXPECT_TRUE(actual == expected);
+		}
+
+		writer.join();
+		CloseHandle(pipe);
+	}
+
+	TEST_F(RapidIOFixtureBigFile, TestWarmFileView)
+	{
+		FileView view = FileView::CreateViewFromExistingFile(TmpDir / BIG_FILE, FileAccessMode::ReadOnly, FileOpenMode::OpenExisting).value();
+
+		size_t lastWarmed{};
+		size_t total{};
+		EXPECT_TRUE(view.Warm({}, 4, [&lastWarmed, &total](size_t warmed, size_t totalBytes)
+			{
+				EXPECT_GE(warmed, lastWarmed);
+				lastWarmed = warmed;
+				total = totalBytes;
+			}));
+
+		EXPECT_EQ(total, BIG_FILE_SIZE);
+		EXPECT_EQ(lastWarmed, BIG_FILE_SIZE);
+		EXPECT_EQ(view.ResidentFraction(), 1.0);
+		EXPECT_EQ(view.ResidencyBitmap({ 0, BIG_FILE_SIZE / 2 }).size(), BIG_FILE_SIZE / 2 / FileView::GetSystemPageSize());
+	}
+
+	TEST_F(RapidIOFixtureBigFile, TestReplayResidency)
+	{
+		{
+			FileView view = FileView::CreateViewFromExistingFile(TmpDir / BIG_FILE, FileAccessMode::ReadOnly, FileOpenMode::OpenExisting).value();
+			ASSERT_TRUE(view.Warm({ 0, BIG_FILE_SIZE / 4 }));
+			EXPECT_TRUE(view.SaveResidency(TmpDir / "BigFile.residency"));
+		}
+
+		FileView view = FileView::CreateViewFromExistingFile(TmpDir / BIG_FILE, FileAccessMode::ReadOnly, FileOpenMode::OpenExisting).value();
+		EXPECT_TRUE(view.ReplayResidency(TmpDir / "BigFile.residency"));
+		EXPECT_EQ(view.ResidentFraction({ 0, BIG_FILE_SIZE / 4 }), 1.0);
+
+		// A sidecar recorded for another file must be rejected
+		{
+			std::ofstream file{ TmpDir / SIMPLE_FILE };
+			file << "Hello World!";
+		}
+
+		FileView simpleView = FileView::CreateViewFromExistingFile(TmpDir / SIMPLE_FILE, FileAccessMode::ReadOnly, FileOpenMode::OpenExisting).value();
+		EXPECT_FALSE(simpleView.ReplayResidency(TmpDir / "BigFile.residency"));
+	}
+
+	struct ArenaTestRoot
+	{
+		ArenaVector<uint64_t> numbers;
+		ArenaVector<ArenaString> names;
+		ArenaString title;
+		ArenaHashMap<ArenaString, uint64_t> index;
+	};
+
+	constexpr uint64_t ARENA_TEST_LAYOUT = ComputeLayoutHash<ArenaTestRoot, ArenaString, ArenaHashMap<ArenaString, uint64_t>::Slot>();
+
+	// Without any types only the seed is hashed
+	static_assert(ComputeLayoutHash<>(1) != ComputeLayoutHash<>(2));
+
+	TEST_F(RapidIOFixture, TestMappedArenaRoundTrip)
+	{
+		constexpr uint64_t nrOfEntries = 10'000;
+
+		{
+			// Start tiny, so the arena has to grow and re-map many times while the graph is built
+			MappedArena arena = MappedArena::Create(TmpDir / "Arena.bin", 1, ARENA_TEST_LAYOUT, 256).value();
+
+			ArenaTestRoot* root = arena.New<ArenaTestRoot>();
+			ASSERT_NE(root, nullptr);
+			arena.SetRoot(root);
+
+			ASSERT_TRUE(root->title.Assign(arena, "Arena Test"));
+
+			for (uint64_t i{}; i < nrOfEntries; ++i)
+			{
+				const std::string name = "entry" + std::to_string(i);
+
+				ASSERT_TRUE(arena.GetRoot<ArenaTestRoot>()->numbers.PushBack(arena, i * 3));
+				ASSERT_TRUE(arena.GetRoot<ArenaTestRoot>()->names.PushBack(arena, ArenaString{}));
+				ASSERT_TRUE(arena.GetRoot<ArenaTestRoot>()->names[i].Assign(arena, name));
+				// The key lives inside the arena, which the insert may re-map while the map grows
+				ASSERT_TRUE(arena.GetRoot<ArenaTestRoot>()->index.Insert(arena, arena.GetRoot<ArenaTestRoot>()->names[i], i));
+			}
+
+			EXPECT_GT(arena.GetCapacity(), 256);
+		}
+
+		// Copy the arena so both can be mapped at the same time, guaranteeing two different base addresses
+		fs::copy_file(TmpDir / "Arena.bin", TmpDir / "ArenaCopy.bin");
+
+		MappedArena arena = MappedArena::Open(TmpDir / "Arena.bin", 1, ARENA_TEST_LAYOUT).value();
+		MappedArena arenaCopy = MappedArena::Open(TmpDir / "ArenaCopy.bin", 1, ARENA_TEST_LAYOUT).value();
+
+		for (MappedArena* current : { &arena, &arenaCopy })
+		{
+			const ArenaTestRoot* root = current->GetRoot<ArenaTestRoot>();
+			ASSERT_NE(root, nullptr);
+
+			EXPECT_EQ(root->title.View(), "Arena Test");
+			ASSERT_EQ(root->numbers.Size(), nrOfEntries);
+			ASSERT_EQ(root->names.Size(), nrOfEntries);
+			EXPECT_EQ(root->index.Size(), nrOfEntries);
+
+			for (uint64_t i{}; i < nrOfEntries; ++i)
+			{
+				const std::string name = "entry" + std::to_string(i);
+
+				ASSERT_EQ(root->numbers[i], i * 3);
+				ASSERT_EQ(root->names[i].View(), name);
+
+				const uint64_t* value = root->index.Find(std::string_view{ name });
+				ASSERT_NE(value, nullptr);
+				ASSERT_EQ(*value, i);
+			}
+
+			EXPECT_EQ(root->index.Find(std::string_view{ "missing" }), nullptr);
+		}
+	}
+
+	TEST_F(RapidIOFixture, TestMappedArenaRejectsIncompatibleLayout)
+	{
+		{
+			MappedArena arena = MappedArena::Create(TmpDir / "Arena.bin", 1, ARENA_TEST_LAYOUT).value();
+			arena.SetRoot(arena.New<ArenaTestRoot>());
+		}
+
+		EXPECT_EQ(MappedArena::Open(TmpDir / "Arena.bin", 2, ARENA_TEST_LAYOUT), std::nullopt);
+		EXPECT_EQ(MappedArena::Open(TmpDir / "Arena.bin", 1, ComputeLayoutHash<ArenaTestRoot>()), std::nullopt);
+		EXPECT_EQ(MappedArena::Open(TmpDir / SIMPLE_FILE, 1, ARENA_TEST_LAYOUT), std::nullopt);
+		EXPECT_NE(MappedArena::Open(TmpDir / "Arena.bin", 1, ARENA_TEST_LAYOUT), std::nullopt);
+	}
+
+	TEST_F(RapidIOFixture, TestFileBackedMemoryResource)
+	{
+		{
+			FileBackedMemoryResource::Options options;
+			options.directory = TmpDir.GetPath();
+			options.segmentSize = 1024 * 1024 * 4; // Small segments, so the containers below need many of them
+			FileBackedMemoryResource resource(options);
+
+			std::pmr::vector<uint64_t> numbers(&resource);
+			std::pmr::unordered_map<uint64_t, std::pmr::string> names(&resource);
+
+			for (uint64_t i{}; i < 1'000'000; ++i)
+			{
+				numbers.push_back(i);
+			}
+
+			for (uint64_t i{}; i < 10'000; ++i)
+			{
+				names.emplace(i, "a name that is too long for the small string optimisation " + std::to_string(i));
+			}
+
+			for (uint64_t i{}; i < numbers.size(); ++i)
+			{
+				ASSERT_EQ(numbers[i], i);
+			}
+
+			for (uint64_t i{}; i < 10'000; ++i)
+			{
+				ASSERT_EQ(std::string_view{ names.at(i) }, "a name that is too long for the small string optimisation " + std::to_string(i));
+			}
+
+			EXPECT_EQ(resource.GetHeapBytes(), 0);
+			EXPECT_GT(resource.GetSpilledBytes(), options.segmentSize);
+		}
+
+		// Spill files are removed together with the resource
+		for (const auto& entry : fs::directory_iterator(TmpDir.GetPath()))
+		{
+			EXPECT_EQ(entry.path().filename(), SIMPLE_FILE);
+		}
+	}
+
+	TEST_F(RapidIOFixture, TestFileBackedMemoryResourceHybrid)
+	{
+		FileBackedMemoryResource::Options options;
+		options.directory = TmpDir.GetPath();
+		options.heapThreshold = 1024 * 64;
+		FileBackedMemoryResource resource(options);
+
+		std::pmr::vector<char> small(1024, 'a', &resource);
+		EXPECT_EQ(resource.GetHeapBytes(), 1024);
+		EXPECT_EQ(resource.GetSpilledBytes(), 0);
+
+		std::pmr::vector<char> big(1024 * 1024, 'b', &resource);
+		EXPECT_EQ(resource.GetHeapBytes(), 1024);
+		EXPECT_GT(resource.GetSpilledBytes(), 0);
+
+		EXPECT_EQ(std::count(small.begin(), small.end(), 'a'), 1024);
+		EXPECT_EQ(std::count(big.begin(), big.end(), 'b'), 1024 * 1024);
+
+		small = {};
+		small.shrink_to_fit();
+		EXPECT_EQ(resource.GetHeapBytes(), 0);
+	}
+
+	TEST_F(RapidIOFixture, TestReadVAndWriteV)
+	{
+		{
+			FileView view = FileView::CreateViewFromExistingFile(TmpDir / SIMPLE_FILE, FileAccessMode::ReadOnly, FileOpenMode::OpenExisting, 5).value();
+
+			char hello[5]{};
+			char world[6]{};
+			const IoRange ranges[]{ { 6, 6, world }, { 0, 5, hello } };
+			EXPECT_FALSE(view.ReadV(ranges, false));
+			ASSERT_TRUE(view.ReadV(ranges));
+			EXPECT_EQ(std::string_view(hello, 5), "Hello");
+			EXPECT_EQ(std::string_view(world, 6), "World!");
+
+			// One range past EOF fails the whole batch
+			char tooFar[4]{};
+			const IoRange badRanges[]{ { 0, 4, tooFar }, { 10, 4, tooFar } };
+			EXPECT_FALSE(view.ReadV(badRanges));
+			EXPECT_EQ(std::string_view(tooFar, 4), std::string_view("\0\0\0\0", 4));
+
+			// A range whose end overflows must not wrap around into the file
+			const IoRange overflowingRanges[]{ { 4, std::numeric_limits<size_t>::max(), tooFar } };
+			EXPECT_FALSE(view.ReadV(overflowingRanges));
+		}
+
+		{
+			FileView view = FileView::CreateViewFromExistingFile(TmpDir / SIMPLE_FILE, FileAccessMode::ReadWrite, FileOpenMode::OpenExisting).value();
+
+			const ConstIoRange ranges[]{ { 0, 5, "HELLO" }, { 20, 4, "tail" } };
+			const ConstIoRange overflowingRanges[]{ { 4, std::numeric_limits<size_t>::max(), "x" } };
+			EXPECT_FALSE(view.WriteV(overflowingRanges));
+
+			EXPECT_FALSE(view.WriteV(ranges, false));
+			ASSERT_TRUE(view.WriteV(ranges));
+		}
+
+		EXPECT_EQ(fs::file_size(TmpDir / SIMPLE_FILE), 24);
+
+		std::ifstream file{ TmpDir / SIMPLE_FILE, std::ios::binary };
+		const std::string contents{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+		EXPECT_EQ(contents, "HELLO World!"s + std::string(8, '\0') + "tail");
+	}
+
+	TEST_F(RapidIOFixture, TestFilesizeAfterGrowing)
+	{
+		{
+			// A new file is as large as requested right away, so all of it can be read back
+			FileView view = FileView::CreateViewForNewFile(TmpDir / "Grown.bin", 16).value();
+			char start[16]{ 'x' };
+			const IoRange startRanges[]{ { 0, 16, start } };
+			ASSERT_TRUE(view.ReadV(startRanges));
+			EXPECT_EQ(std::string_view(start, 16), std::string(16, '\0'));
+
+			// Bytes appended by an auto-growing Write() are part of the file as well
+			ASSERT_TRUE(view.Write("grown"s, 30));
+			char grown[5]{};
+			const IoRange grownRanges[]{ { 30, 5, grown } };
+			ASSERT_TRUE(view.ReadV(grownRanges));
+			EXPECT_EQ(std::string_view(grown, 5), "grown");
+		}
+
+		// A read-only view can map the whole file
+		const size_t fileSize = fs::file_size(TmpDir / "Grown.bin");
+		ReadOnlyFileView view = ReadOnlyFileView::CreateViewFromExistingFile(TmpDir / "Grown.bin", FileOpenMode::OpenExisting, fileSize).value();
+		EXPECT_EQ(view.GetMappedSize(), fileSize);
+		EXPECT_EQ(view.ReadView(fileSize).substr(30), "grown");
+	}
+
+	TEST_F(RapidIOFixtureBigFile, TestParallelReadV)
+	{
+		FileView view = FileView::CreateViewFromExistingFile(TmpDir / BIG_FILE, FileAccessMode::ReadOnly, FileOpenMode::OpenExisting).value();
+
+		std::string first(BIG_FILE_SIZE / 4, '\0');
+		std::string last(BIG_FILE_SIZE / 4, '\0');
+		const IoRange ranges[]{ { 0, first.size(), first.data() }, { BIG_FILE_SIZE - last.size(), last.size(), last.data() } };
+		ASSERT_TRUE(view.ReadV(ranges, true, 4));
+
+		EXPECT_TRUE(first == BigFileData.substr(0, first.size()));
+		EXPECT_TRUE(last == BigFileData.substr(BIG_FILE_SIZE - last.size()));
+	}
+
+	TEST_F(RapidIOFixture, TestWriteBatchCoalescesWrites)
+	{
+		WriteBatch batch;
+		batch.Add("World"s, 6);
+		batch.Add("Hello"s, 0);
+		batch.Add("J"s, 0); // Overlaps and was added later, so it wins
+		batch.Add(" "s, 5); // Adjacent to both neighbours
+		batch.Add("!"s, 30);
+
+		const std::vector<ConstIoRange>& ranges = batch.GetCoalescedRanges();
+		ASSERT_EQ(ranges.size(), 2);
+		EXPECT_EQ(ranges[0].offset, 0);
+		EXPECT_EQ(std::string_view(static_cast<const char*>(ranges[0].buffer), ranges[0].size), "Jello World");
+		EXPECT_EQ(ranges[1].offset, 30);
+
+		{
+			FileView view = FileView::CreateViewFromExistingFile(TmpDir / SIMPLE_FILE, FileAccessMode::ReadWrite, FileOpenMode::OpenExisting).value();
+			ASSERT_TRUE(batch.Commit(view, true));
+			EXPECT_TRUE(batch.IsEmpty());
+		}
+
+		std::ifstream file{ TmpDir / SIMPLE_FILE, std::ios::binary };
+		const std::string contents{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+		EXPECT_EQ(contents, "Jello World!"s + std::string(18, '\0') + "!");
+	}
+
+	TEST_F(RapidIOFixture, TestStreamingCopyKernels)
+	{
+		std::string source(1024 * 64 + 77, '\0');
+		for (size_t i{}; i < source.size(); ++i)
+		{
+			source[i] = static_cast<char>(i * 31 + 7);
+		}
+
+		for (const CopyKernel kernel : { CopyKernel::Memcpy, CopyKernel::SSE2, CopyKernel::AVX2, CopyKernel::AVX512 })
+		{
+			if (!IsCopyKernelSupported(kernel))
+			{
+				continue;
+			}
+
+			// Misaligned source and destination, so both the head and the tail of every kernel are exercised
+			for (size_t misalignment : { 0, 1, 13, 63 })
+			{
+				std::string destination(source.size(), '\0');
+				const size_t size = source.size() - misalignment;
+				StreamingCopy(destination.data() + misalignment, source.data() + (63 - misalignment), size - (63 - misalignment), kernel);
+
+				EXPECT_TRUE(std::string_view(destination).substr(misalignment, size - (63 - misalignment)) ==
+					std::string_view(source).substr(63 - misalignment, size - (63 - misalignment))) << GetCopyKernelName(kernel);
+			}
+		}
+	}
+
+	TEST_F(RapidIOFixtureBigFile, TestStreamingRead)
+	{
+		FileView view = FileView::CreateViewFromExistingFile(TmpDir / BIG_FILE, FileAccessMode::ReadOnly, FileOpenMode::OpenExisting).value();
+
+		ASSERT_GE(BIG_FILE_SIZE, GetStreamingCopyThreshold());
+		EXPECT_TRUE(view.Read(BIG_FILE_SIZE) == BigFileData);
+	}
+
+	TEST_F(RapidIOFixture, TestThreadPoolParallelFor)
+	{
+		ThreadPool pool{ 3 };
+		std::vector<std::atomic<size_t>> counts(1000);
+
+		// Nested jobs must not deadlock, even when every worker is busy with an outer task
+		pool.ParallelFor(10, 0, [&pool, &counts](size_t outer)
+			{
+				pool.ParallelFor(100, 4, [&counts, outer](size_t inner) { ++counts[outer * 100 + inner]; });
+			});
+
+		EXPECT_TRUE(std::all_of(counts.begin(), counts.end(), [](const std::atomic<size_t>& count) { return count == 1; }));
+	}
+
+	TEST_F(RapidIOFixtureBigFile, TestParallelWrite)
+	{
+		constexpr size_t offset = 12345;
+
+		{
+			FileView view = FileView::CreateViewForNewFile(TmpDir / NON_EXISTING_FILE, 4096).value();
+			EXPECT_FALSE(view.ParallelWrite(BigFileData, offset, 4, false));
+			ASSERT_TRUE(view.ParallelWrite(BigFileData, offset, 4));
+		}
+
+		EXPECT_EQ(fs::file_size(TmpDir / NON_EXISTING_FILE), offset + BIG_FILE_SIZE);
+
+		FileView view = FileView::CreateViewFromExistingFile(TmpDir / NON_EXISTING_FILE, FileAccessMode::ReadOnly, FileOpenMode::OpenExisting).value();
+		ASSERT_TRUE(view.Seek(offset));
+		EXPECT_TRUE(view.Read(BIG_FILE_SIZE) == BigFileData);
+	}
+
+	TEST_F(RapidIOFixtureBigFile, TestChecksum)
+	{
+		FileView view = FileView::CreateViewFromExistingFile(TmpDir / BIG_FILE, FileAccessMode::ReadOnly, FileOpenMode::OpenExisting).value();
+
+		// Known CRC32C check value
+		EXPECT_EQ(Crc32c("123456789", 9), 0xE3069283);
+
+		// The parallel checksum is stitched together from per-block checksums, so it has to match a single pass
+		const uint32_t expected = Crc32c(BigFileData.data() + 1000, BIG_FILE_SIZE - 2000);
+		EXPECT_EQ(view.Checksum({ 1000, BIG_FILE_SIZE - 2000 }, 4), expected);
+		EXPECT_EQ(view.Checksum({ 1000, BIG_FILE_SIZE - 2000 }, 1), expected);
+		EXPECT_EQ(view.Checksum({ BIG_FILE_SIZE + 1, 10 }), std::nullopt);
+	}
+
+	TEST_F(RapidIOFixture, TestBlockChecksums)
+	{
+		{
+			FileView view = FileView::CreateViewFromExistingFile(TmpDir / SIMPLE_FILE, FileAccessMode::ReadWrite, FileOpenMode::OpenExisting).value();
+			BlockChecksums checksums = BlockChecksums::Create(view, TmpDir / "SimpleFile.crc", 4).value();
+			EXPECT_EQ(checksums.GetNrOfBlocks(), 3);
+			EXPECT_TRUE(checksums.Verify(view));
+
+			// Writing through the checksums keeps them up to date, also when the file grows
+			ASSERT_TRUE(checksums.Write(view, "Jolly Good World!"s, 6));
+			EXPECT_EQ(checksums.GetDataSize(), 23);
+			EXPECT_TRUE(checksums.Verify(view));
+
+			// A write that bypasses the checksums is only detected in the blocks it touched
+			ASSERT_TRUE(view.Write("X"s, 1));
+			EXPECT_FALSE(checksums.Verify(view, { 0, 4 }));
+			EXPECT_TRUE(checksums.Verify(view, { 4, 19 }));
+			ASSERT_TRUE(checksums.Update(view, { 1, 1 }));
+			EXPECT_TRUE(checksums.Verify(view));
+		}
+
+		FileView view = FileView::CreateViewFromExistingFile(TmpDir / SIMPLE_FILE, FileAccessMode::ReadOnly, FileOpenMode::OpenExisting).value();
+		const BlockChecksums checksums = BlockChecksums::Open(TmpDir / "SimpleFile.crc").value();
+		EXPECT_TRUE(checksums.Verify(view));
+		EXPECT_EQ(BlockChecksums::Open(TmpDir / SIMPLE_FILE), std::nullopt);
+	}
+
+	TEST_F(RapidIOFixture, TestBlockChecksumsReadOnlyView)
+	{
+		const ReadOnlyFileView view = ReadOnlyFileView::CreateViewFromExistingFile(TmpDir / SIMPLE_FILE, FileOpenMode::OpenExisting).value();
+		BlockChecksums checksums = BlockChecksums::Create(view, TmpDir / "SimpleFile.crc", 4).value();
+		EXPECT_TRUE(checksums.Verify(view));
+
+		// A write through another view is visible in the read-only one
+		{
+			FileView writer = FileView::CreateViewFromExistingFile(TmpDir / SIMPLE_FILE, FileAccessMode::ReadWrite, FileOpenMode::OpenExisting).value();
+			ASSERT_TRUE(writer.Write("X"s, 5));
+		}
+
+		EXPECT_FALSE(checksums.Verify(view, { 4, 4 }));
+		EXPECT_TRUE(checksums.Verify(view, { 8, 4 }));
+		ASSERT_TRUE(checksums.Update(view, { 5, 1 }));
+		EXPECT_TRUE(checksums.Verify(view));
+	}
+
+	TEST_F(RapidIOFixture, TestDelimitedReader)
+	{
+		// The quoted field contains delimiters, newlines and escaped quotes, and is long enough to span multiple 64 byte blocks
+		const std::string quoted = "\"" + std::string(100, 'x') + ",\n\"\"y\"\"\"";
+		const std::string csv = "id,name,comment\r\n1,Alice,plain\r\n2,Bob," + quoted + "\r\n3,,\r\n4,Dave,last";
+
+		{
+			std::ofstream file{ TmpDir / "Data.csv", std::ios::binary };
+			file << csv;
+		}
+
+		FileView view = FileView::CreateViewFromExistingFile(TmpDir / "Data.csv", FileAccessMode::ReadOnly, FileOpenMode::OpenExisting).value();
+		DelimitedReader reader{ view };
+		ASSERT_EQ(reader.GetNrOfRows(), 5);
+
+		std::vector<std::string_view> fields;
+		ASSERT_TRUE(reader.ReadRow(fields));
+		EXPECT_EQ(fields, (std::vector<std::string_view>{ "id", "name", "comment" }));
+		ASSERT_TRUE(reader.ReadRow(fields));
+		EXPECT_EQ(fields, (std::vector<std::string_view>{ "1", "Alice", "plain" }));
+
+		ASSERT_TRUE(reader.ReadRow(fields));
+		ASSERT_EQ(fields.size(), 3);
+		EXPECT_EQ(DelimitedReader::Unescape(fields[2]), std::string(100, 'x') + ",\n\"y\"");
+
+		ASSERT_TRUE(reader.ReadRow(fields));
+		EXPECT_EQ(fields, (std::vector<std::string_view>{ "3", "", "" }));
+		ASSERT_TRUE(reader.ReadRow(fields));
+		EXPECT_EQ(fields, (std::vector<std::string_view>{ "4", "Dave", "last" }));
+		EXPECT_FALSE(reader.ReadRow(fields));
+
+		// Indexing in parallel chunks has to carry the quote state over chunk boundaries
+		std::string big;
+		for (int i{}; i < 200000; ++i)
+		{
+			big += std::to_string(i) + ",\"quoted,\nfield " + std::to_string(i) + "\"\n";
+		}
+
+		DelimitedReader bigReader{ big, DelimitedReader::Options{ ',', '"', 4 } };
+		ASSERT_EQ(bigReader.GetNrOfRows(), 200000);
+		ASSERT_TRUE(bigReader.GetRow(123456, fields));
+		EXPECT_EQ(fields, (std::vector<std::string_view>{ "123456", "quoted,\nfield 123456" }));
+	}
+
+	TEST_F(RapidIOFixture, TestDelimitedReaderReadOnlyView)
+	{
+		{
+			std::ofstream file{ TmpDir / "Data.csv", std::ios::binary };
+			file << "id,name\n1,\"Alice, A.\"\n2,Bob";
+		}
+
+		const ReadOnlyFileView view = ReadOnlyFileView::CreateViewFromExistingFile(TmpDir / "Data.csv", FileOpenMode::OpenExisting).value();
+		DelimitedReader reader{ view, DelimitedReader::Options{ ',', '"', 2 } };
+		ASSERT_EQ(reader.GetNrOfRows(), 3);
+
+		std::vector<std::string_view> fields;
+		ASSERT_TRUE(reader.GetRow(1, fields));
+		EXPECT_EQ(fields, (std::vector<std::string_view>{ "1", "Alice, A." }));
+		ASSERT_TRUE(reader.GetRow(2, fields));
+		EXPECT_EQ(fields, (std::vector<std::string_view>{ "2", "Bob" }));
+	}
+
+	TEST_F(RapidIOFixtureBigFile, TestFindOnMappedView)
+	{
+		// Plant needles in the big file, including one crossing the boundary between two search chunks
+		constexpr size_t chunkBoundary = 1024 * 1024 * 4;
+		const std::vector<size_t> needleOffsets{ 10, 1000, chunkBoundary - 3, BIG_FILE_SIZE / 2 + 1, BIG_FILE_SIZE - 7 };
+
+		{
+			FileView view = FileView::CreateViewFromExistingFile(TmpDir / BIG_FILE, FileAccessMode::ReadWrite, FileOpenMode::OpenExisting).value();
+			for (const size_t offset : needleOffsets)
+			{
+				ASSERT_TRUE(view.Write("NEEDLE!"s, offset));
+			}
+
+			ASSERT_TRUE(view.Write("HAYSTACK"s, 5000));
+		}
+
+		FileView view = FileView::CreateViewFromExistingFile(TmpDir / BIG_FILE, FileAccessMode::ReadOnly, FileOpenMode::OpenExisting).value();
+
+		EXPECT_EQ(view.Find("NEEDLE!"), 10);
+		EXPECT_EQ(view.Find("NEEDLE!", 11), 1000);
+		EXPECT_EQ(view.Find("NEEDLE!", 1001, 4), chunkBoundary - 3);
+		EXPECT_EQ(view.Find("NEEDLE!", BIG_FILE_SIZE / 2 + 2, 4), BIG_FILE_SIZE - 7);
+		EXPECT_EQ(view.Find("NOT THERE", 0, 4), std::nullopt);
+
+		EXPECT_EQ(view.FindAll("NEEDLE!", {}, 4), needleOffsets);
+		EXPECT_EQ(view.FindAll("NEEDLE!", { 11, BIG_FILE_SIZE / 2 - 11 }, 4), (std::vector<size_t>{ 1000, chunkBoundary - 3 }));
+
+		const std::string_view patterns[]{ "HAYSTACK", "NEEDLE", "EDLE!" };
+		const std::vector<PatternMatch> matches = view.FindAny(patterns, { 0, chunkBoundary + 100 }, 4);
+		EXPECT_EQ(matches, (std::vector<PatternMatch>{ { 10, 1 }, { 12, 2 }, { 1000, 1 }, { 1002, 2 }, { 5000, 0 }, { chunkBoundary - 3, 1 }, { chunkBoundary - 1, 2 } }));
+
+		// Matches are offsets that can be passed straight to Seek
+		ASSERT_TRUE(view.Seek(matches[4].offset));
+		EXPECT_EQ(view.ReadView(8), "HAYSTACK");
+	}
+
+	TEST_F(RapidIOFixture, TestLineIndex)
+	{
+		constexpr size_t nrOfLines = 300000;
+		const fs::path logPath = TmpDir / "Log.txt";
+		const fs::path indexPath = TmpDir / "Log.txt.lines";
+
+		{
+			std::ofstream file{ logPath, std::ios::binary };
+			for (size_t i{}; i < nrOfLines; ++i)
+			{
+				file << "line " << i << (i % 3 == 0 ? "\r\n" : "\n");
+			}
+		}
+
+		{
+			FileView view = FileView::CreateViewFromExistingFile(logPath, FileAccessMode::ReadOnly, FileOpenMode::OpenExisting).value();
+			LineIndex index = LineIndex::Open(view, indexPath, 100, 4).value();
+
+			ASSERT_EQ(index.GetNrOfLines(), nrOfLines);
+			EXPECT_EQ(index.GetLine(0), "line 0");
+			EXPECT_EQ(index.GetLine(123456), "line 123456");
+			EXPECT_EQ(index.GetLine(nrOfLines - 1), "line " + std::to_string(nrOfLines - 1));
+			EXPECT_EQ(index.GetLine(nrOfLines), std::nullopt);
+			EXPECT_EQ(index.GetLines(199, 3), (std::vector<std::string_view>{ "line 199", "line 200", "line 201" }));
+		}
+
+		// Append to the file, reopening has to pick up the new lines, including the unterminated last one
+		{
+			std::ofstream file{ logPath, std::ios::binary | std::ios::app };
+			file << "appended\nlast";
+		}
+
+		{
+			FileView view = FileView::CreateViewFromExistingFile(logPath, FileAccessMode::ReadOnly, FileOpenMode::OpenExisting).value();
+			LineIndex index = LineIndex::Open(view, indexPath, 100, 4).value();
+
+			ASSERT_EQ(index.GetNrOfLines(), nrOfLines + 2);
+			EXPECT_EQ(index.GetLine(nrOfLines), "appended");
+			EXPECT_EQ(index.GetLine(nrOfLines + 1), "last");
+			EXPECT_EQ(index.GetLine(250000), "line 250000");
+		}
+
+		// An edit in the middle that keeps the file size must invalidate the stored index as well
+		{
+			size_t lineEnd{};
+			for (size_t i{}; i <= 150000; ++i)
+			{
+				lineEnd += ("line " + std::to_string(i)).size() + (i % 3 == 0 ? 2 : 1);
+			}
+
+			// Line 150000 ends with "\r\n", overwrite it with two spaces
+			std::fstream file{ logPath, std::ios::binary | std::ios::in | std::ios::out };
+			file.seekp(static_cast<std::streamoff>(lineEnd - 2));
+			file << "  ";
+		}
+
+		{
+			FileView view = FileView::CreateViewFromExistingFile(logPath, FileAccessMode::ReadOnly, FileOpenMode::OpenExisting).value();
+			LineIndex index = LineIndex::Open(view, indexPath, 100, 4).value();
+
+			ASSERT_EQ(index.GetNrOfLines(), nrOfLines + 1);
+			EXPECT_EQ(index.GetLine(150000), "line 150000  line 150001");
+			EXPECT_EQ(index.GetLine(250000), "line 250001");
+		}
+
+		// Rewriting the file must invalidate the stored index
+		{
+			std::ofstream file{ logPath, std::ios::binary };
+			file << "a\nb\nc\n";
+		}
+
+		FileView view = FileView::CreateViewFromExistingFile(logPath, FileAccessMode::ReadOnly, FileOpenMode::OpenExisting).value();
+		LineIndex index = LineIndex::Open(view, indexPath, 100).value();
+		ASSERT_EQ(index.GetNrOfLines(), 3);
+		EXPECT_EQ(index.GetLine(2), "c");
+	}
+
+	TEST_F(RapidIOFixture, TestLineIndexReadOnlyView)
+	{
+		const fs::path logPath = TmpDir / "Log.txt";
+		const fs::path indexPath = TmpDir / "Log.txt.lines";
+
+		{
+			std::ofstream file{ logPath, std::ios::binary };
+			file << "first\r\nsecond\nthird";
+		}
+
+		{
+			const ReadOnlyFileView view = ReadOnlyFileView::CreateViewFromExistingFile(logPath, FileOpenMode::OpenExisting).value();
+			LineIndex index = LineIndex::Open(view, indexPath, 2).value();
+			ASSERT_EQ(index.GetNrOfLines(), 3);
+			EXPECT_EQ(index.GetLine(0), "first");
+			EXPECT_EQ(index.GetLine(2), "third");
+		}
+
+		{
+			std::ofstream file{ logPath, std::ios::binary | std::ios::app };
+			file << "\nfourth\n";
+		}
+
+		// The stored index is reused and extended with the appended lines
+		const ReadOnlyFileView view = ReadOnlyFileView::CreateViewFromExistingFile(logPath, FileOpenMode::OpenExisting).value();
+		LineIndex index = LineIndex::Open(view, indexPath, 2).value();
+		ASSERT_EQ(index.GetNrOfLines(), 4);
+		EXPECT_EQ(index.GetLine(3), "fourth");
+		EXPECT_TRUE(index.Update(view));
+	}
+
+	TEST_F(RapidIOFixture, TestFollowView)
+	{
+		const std::filesystem::path logPath = TmpDir / "Follow.log";
+		std::ofstream writer{ logPath, std::ios::binary };
+		writer << "existing\n" << std::flush;
+
+		FollowView follower = FollowView::Create(logPath).value();
+
+		// Data already in the file is handed out first
+		std::span<const char> data = follower.WaitForData(std::chrono::seconds(5));
+		EXPECT_EQ(std::string_view(data.data(), data.size()), "existing\n");
+		EXPECT_TRUE(follower.WaitForData(std::chrono::milliseconds(10)).empty());
+
+		writer << "appended\n" << std::flush;
+		data = follower.WaitForData(std::chrono::seconds(5));
+		EXPECT_EQ(std::string_view(data.data(), data.size()), "appended\n");
+		EXPECT_EQ(follower.GetOffset(), 18);
+
+		// With a callback, every append is delivered on the watcher thread with its offset
+		std::mutex mutex;
+		std::condition_variable delivered;
+		std::string received;
+		size_t nextOffset = 9;
+
+		{
+			FollowView callbackFollower = FollowView::Create(logPath, [&](std::span<const char> appended, size_t offset)
+				{
+					std::lock_guard lock(mutex);
+					EXPECT_EQ(offset, nextOffset);
+					nextOffset = offset + appended.size();
+					received.append(appended.data(), appended.size());
+					delivered.notify_all();
+				}, 9).value();
+
+			std::string expected = "appended\n";
+			for (int i{}; i < 100; ++i)
+			{
+				const std::string line = "line " + std::to_string(i) + "\n";
+				expected += line;
+				writer << line << std::flush;
+			}
+
+			std::unique_lock lock(mutex);
+			EXPECT_TRUE(delivered.wait_for(lock, std::chrono::seconds(5), [&]() { return received.size() == expected.size(); }));
+			EXPECT_EQ(received, expected);
+		}
+	}
+
+	TEST_F(RapidIOFixture, TestAddressStableGrowth)
+	{
+		const std::filesystem::path path = TmpDir / "Growing.bin";
+		std::string expected = "header";
+
+		{
+			FileView view = FileView::CreateViewForNewFile(path, expected.size()).value();
+			ASSERT_TRUE(view.Write(expected));
+			ASSERT_TRUE(view.ReserveAddressSpace(1024 * 1024 * 4));
+			EXPECT_GE(view.GetReservedAddressSpace(), 1024 * 1024 * 4);
+
+			const char* const base = view.GetData();
+			EXPECT_EQ(std::string_view(base, expected.size()), expected);
+
+			// Appending in odd-sized pieces crosses many allocation granularity boundaries without ever moving the view
+			for (int i{}; expected.size() < 1024 * 1024 * 3; ++i)
+			{
+				const std::string line = "line " + std::to_string(i) + "\n";
+				ASSERT_TRUE(view.Write(line, expected.size()));
+				expected += line;
+				ASSERT_EQ(view.GetData(), base);
+			}
+
+			EXPECT_EQ(view.GetMappedSize(), expected.size());
+			EXPECT_EQ(std::string_view(base, expected.size()), expected);
+			EXPECT_TRUE(view.Flush());
+
+			// Growing past the reservation moves the view once, into a bigger reservation
+			const std::string tail(1024 * 1024 * 2, 'x');
+			ASSERT_TRUE(view.Write(tail, expected.size()));
+			expected += tail;
+			EXPECT_GE(view.GetReservedAddressSpace(), 1024 * 1024 * 8);
+			EXPECT_EQ(std::string_view(view.GetData(), view.GetMappedSize()), expected);
+		}
+
+		// The padding up to the allocation granularity is cut off once the view is gone
+		EXPECT_EQ(std::filesystem::file_size(path), expected.size());
+
+		FileView view = FileView::CreateViewFromExistingFile(path, FileAccessMode::ReadOnly, FileOpenMode::OpenExisting).value();
+		EXPECT_TRUE(view.Read(expected.size()) == expected);
+		EXPECT_FALSE(view.ReserveAddressSpace(1024 * 1024));
+	}
+
+	// Writing to a read-only view must not compile
+	template<typename View>
+	concept IsWritableView = requires (View& view, std::string data, std::span<const ConstIoRange> ranges)
+	{
+		{ view.Write(data) };
+		{ view.ParallelWrite(data) };
+		{ view.WriteV(ranges) };
+		{ view.ReserveAddressSpace(size_t{}) };
+		{ View::CreateViewForNewFile(std::filesystem::path{}, size_t{}) };
+		{ view.GetData() } -> std::same_as<char*>;
+	};
+
+	static_assert(IsWritableView<FileView>);
+	static_assert(!IsWritableView<ReadOnlyFileView>);
+
+	TEST_F(RapidIOFixture, TestReadOnlyFileView)
+	{
+		EXPECT_EQ(ReadOnlyFileView::CreateViewFromExistingFile(TmpDir / NON_EXISTING_FILE, FileOpenMode::OpenExisting), std::nullopt);
+		EXPECT_EQ(ReadOnlyFileView::CreateViewFromExistingFile(TmpDir / SIMPLE_FILE, FileOpenMode::CreateAlways), std::nullopt);
+
+		ReadOnlyFileView view = ReadOnlyFileView::CreateViewFromExistingFile(TmpDir / SIMPLE_FILE, FileOpenMode::OpenExisting, 5).value();
+		EXPECT_EQ(view.Read(5), "Hello");
+
+		// Reading past the mapped size still grows the mapping, up to the end of the file
+		EXPECT_EQ(view.ReadView(100), " World!");
+		EXPECT_EQ(view.GetMappedSize(), SIMPLE_FILE_SIZE);
+		EXPECT_EQ(view.Read(1), "");
+
+		EXPECT_TRUE(view.Seek(6));
+		EXPECT_EQ(view.Read(5), "World");
+		EXPECT_EQ(view.Find("World"), 6);
+		EXPECT_EQ(view.Checksum(), FileView::CreateViewFromExistingFile(TmpDir / SIMPLE_FILE, FileAccessMode::ReadOnly,
+			FileOpenMode::OpenExisting).value().Checksum());
+
+		char hello[5]{};
+		const IoRange ranges[]{ { 0, 5, hello } };
+		EXPECT_TRUE(view.ReadV(ranges));
+		EXPECT_EQ(std::string_view(hello, 5), "Hello");
+
+		EXPECT_TRUE(view.Warm());
+		EXPECT_TRUE(view.Discard({}));
+		EXPECT_FALSE(view.Reserve(SIMPLE_FILE_SIZE * 2));
+	}
+
+	TEST_F(RapidIOFixture, TestTracing)
+	{
+		ClearTrace();
+
+		{
+			FileView view = FileView::CreateViewFromExistingFile(TmpDir / SIMPLE_FILE, FileAccessMode::ReadWrite, FileOpenMode::OpenExisting).value();
+			EXPECT_EQ(view.Read(5), "Hello");
+			EXPECT_TRUE(view.Write("Hello Tracing!"s, 0));
+			EXPECT_TRUE(view.Flush());
+		}
+
+		if constexpr (!IsTracingEnabled())
+		{
+			EXPECT_FALSE(DumpTrace(TmpDir / "rapidio.trace.json"));
+			return;
+		}
+
+		// Events are recorded on every thread, including ones that have exited since
+		std::thread([]() { RAPIDIO_TRACE_SCOPE("Worker", 1, 2); }).join();
+
+		ASSERT_TRUE(DumpTrace(TmpDir / "rapidio.trace.json"));
+
+		std::ifstream file(TmpDir / "rapidio.trace.json");
+		const std::string trace((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+		EXPECT_TRUE(trace.starts_with("{\"displayTimeUnit\":\"ns\",\"traceEvents\":["));
+		EXPECT_TRUE(trace.ends_with("]}\n"));
+
+		for (const char* name : { "Open", "CreateFileMapping", "Map", "Read", "Write", "Remap", "Flush", "Worker" })
+		{
+			EXPECT_NE(trace.find("{\"name\":\""s + name + "\""), std::string::npos) << name;
+		}
+
+		EXPECT_NE(trace.find("\"name\":\"Read\",\"cat\":\"rapidio\",\"ph\":\"X\""), std::string::npos);
+		EXPECT_NE(trace.find("\"args\":{\"offset\":0,\"size\":14}"), std::string::npos);
+		EXPECT_NE(trace.find("\"args\":{\"offset\":1,\"size\":2}"), std::string::npos);
+
+		ClearTrace();
+		ASSERT_TRUE(DumpTrace(TmpDir / "rapidio.trace.json"));
+		EXPECT_EQ(fs::file_size(TmpDir / "rapidio.trace.json"), std::string_view("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n]}\n").size());
+	}
+
+	TEST_F(RapidIOFixture, TestSortedTable)
+	{
+		using namespace rapidio;
+
+		static_assert(std::forward_iterator<SortedTableReader::Iterator>);
+
+		const std::filesystem::path tablePath = TmpDir / "table.rio";
+		constexpr int nrOfEntries = 10000;
+
+		const auto makeKey = [](int i)
+			{
+				std::string key = std::to_string(i);
+				return "key" + std::string(5 - key.size(), '0') + key;
+			};
+
+		{
+			// Small blocks so lookups have to go through the index
+			SortedTableWriter writer = SortedTableWriter::Create(tablePath, { .blockSize = 256 }).value();
+			for (int i{}; i < nrOfEntries; ++i)
+			{
+				ASSERT_TRUE(writer.Add(makeKey(i), "value" + std::to_string(i)));
+			}
+
+			EXPECT_FALSE(writer.Add(makeKey(5), "out of order"));
+			EXPECT_FALSE(writer.Add(makeKey(nrOfEntries - 1), "duplicate"));
+			EXPECT_EQ(writer.GetNrOfEntries(), nrOfEntries);
+
+			ASSERT_TRUE(writer.Finish());
+			EXPECT_FALSE(writer.Add("zzz", "finished"));
+		}
+
+		const SortedTableReader reader = SortedTableReader::Open(tablePath).value();
+		EXPECT_EQ(reader.GetNrOfEntries(), nrOfEntries);
+
+		for (int i{}; i < nrOfEntries; ++i)
+		{
+			const std::optional<std::string_view> value = reader.Get(makeKey(i));
+			ASSERT_TRUE(value.has_value()) << i;
+			EXPECT_EQ(*value, "value" + std::to_string(i));
+		}
+
+		EXPECT_FALSE(reader.Get("key").has_value());
+		EXPECT_FALSE(reader.Get("key000005").has_value());
+		EXPECT_FALSE(reader.Get("a").has_value());
+		EXPECT_FALSE(reader.Get("zzz").has_value());
+
+		int nrOfFalsePositives{};
+		for (int i{}; i < nrOfEntries; ++i)
+		{
+			nrOfFalsePositives += reader.MayContain("missing" + std::to_string(i));
+		}
+
+		EXPECT_LT(nrOfFalsePositives, nrOfEntries / 20);
+
+		int nrOfIterated{};
+		for (const SortedTableEntry& entry : reader)
+		{
+			EXPECT_EQ(entry.key, makeKey(nrOfIterated));
+			++nrOfIterated;
+		}
+
+		EXPECT_EQ(nrOfIterated, nrOfEntries);
+
+		EXPECT_EQ((*reader.LowerBound("key01234a")).key, "key01235");
+		EXPECT_EQ(reader.LowerBound("zzz"), reader.end());
+		EXPECT_EQ(reader.LowerBound(""), reader.begin());
+
+		const auto range = reader.Range("key00100", "key00200");
+		EXPECT_EQ(std::ranges::distance(range), 100);
+		EXPECT_EQ((*range.begin()).key, "key00100");
+		EXPECT_TRUE(reader.Range("key00200", "key00100").empty());
+
+		const auto prefix = reader.Prefix("key0123");
+		EXPECT_EQ(std::ranges::distance(prefix), 10);
+		EXPECT_EQ((*prefix.begin()).key, "key01230");
+		EXPECT_EQ(std::ranges::distance(reader.Prefix("key")), nrOfEntries);
+		EXPECT_TRUE(reader.Prefix("nope").empty());
+
+		// Empty tables and tables without a filter
+		{
+			SortedTableWriter writer = SortedTableWriter::Create(TmpDir / "empty.rio", { .bloomBitsPerKey = 0 }).value();
+			ASSERT_TRUE(writer.Finish());
+		}
+
+		const SortedTableReader emptyReader = SortedTableReader::Open(TmpDir / "empty.rio").value();
+		EXPECT_EQ(emptyReader.GetNrOfEntries(), 0);
+		EXPECT_EQ(emptyReader.begin(), emptyReader.end());
+		EXPECT_FALSE(emptyReader.Get("key").has_value());
+		EXPECT_TRUE(emptyReader.Prefix("").empty());
+
+		EXPECT_FALSE(SortedTableReader::Open(TmpDir / SIMPLE_FILE).has_value());
+	}
+
+	TEST_F(RapidIOFixture, TestSortedTableCorruptFooter)
+	{
+		const fs::path tablePath = TmpDir / "table.rio";
+		{
+			SortedTableWriter writer = SortedTableWriter::Create(tablePath, { .blockSize = 64 }).value();
+			for (int i{}; i < 100; ++i)
+			{
+				ASSERT_TRUE(writer.Add("key" + std::to_string(1000 + i), "value" + std::to_string(i)));
+			}
+
+			ASSERT_TRUE(writer.Finish());
+		}
+
+		ASSERT_TRUE(SortedTableReader::Open(tablePath).has_value());
+
+		// Opens a copy of the table with 'corrupt' applied to its footer
+		auto openCorrupted = [&](const std::function<void(detail::SortedTableFooter&)>& corrupt)
+			{
+				const fs::path corruptPath = TmpDir / "corrupt.rio";
+				fs::copy_file(tablePath, corruptPath, fs::copy_options::overwrite_existing);
+				{
+					FileView view = FileView::CreateViewFromExistingFile(corruptPath, FileAccessMode::ReadWrite, FileOpenMode::OpenExisting).value();
+					char* const footerData = view.GetData() + view.GetMappedSize() - sizeof(detail::SortedTableFooter);
+
+					detail::SortedTableFooter footer;
+					std::memcpy(&footer, footerData, sizeof(footer));
+					corrupt(footer);
+					std::memcpy(footerData, &footer, sizeof(footer));
+				}
+
+				return SortedTableReader::Open(corruptPath);
+			};
+
+		// Moving the index and the filter by 2^63 still satisfies sums that wrap around
+		constexpr uint64_t halfRange = uint64_t{ 1 } << 63;
+		EXPECT_FALSE(openCorrupted([](detail::SortedTableFooter& footer)
+			{
+				footer.indexOffset += halfRange;
+				footer.bloomOffset += halfRange;
+				footer.nrOfBloomBlocks += halfRange / detail::BloomBlockSize;
+			}).has_value());
+
+		EXPECT_FALSE(openCorrupted([](detail::SortedTableFooter& footer) { footer.nrOfBlocks = std::numeric_limits<uint64_t>::max() / 8; }).has_value());
+		EXPECT_FALSE(openCorrupted([](detail::SortedTableFooter& footer) { footer.bloomOffset = std::numeric_limits<uint64_t>::max(); }).has_value());
+		EXPECT_FALSE(openCorrupted([](detail::SortedTableFooter& footer) { footer.indexOffset = footer.bloomOffset + 1; }).has_value());
+		EXPECT_TRUE(openCorrupted([](detail::SortedTableFooter&) {}).has_value());
+	}
+
+	TEST_F(RapidIOFixture, TestCopyRange)
+	{
+		using namespace rapidio;
+
+		std::string data(1024 * 1024 + 123, '\0');
+		for (size_t i{}; i < data.size(); ++i)
+		{
+			data[i] = static_cast<char>('a' + i % 26);
+		}
+
+		FileView::CreateViewForNewFile(TmpDir / "source.txt", data.size()).value().Write(data);
+
+		ReadOnlyFileView source = ReadOnlyFileView::CreateViewFromExistingFile(TmpDir / "source.txt", FileOpenMode::OpenExisting).value();
+		FileView destination = FileView::CreateViewForNewFile(TmpDir / "destination.txt", 1).value();
+
+		ASSERT_TRUE(source.CopyTo(destination));
+		ASSERT_EQ(destination.GetMappedSize(), data.size());
+		EXPECT_EQ(std::string_view(destination.GetData(), data.size()), data);
+
+		// Unaligned offsets, and past the end of the destination
+		ASSERT_TRUE(source.CopyRange(4097, destination, 10, 70000));
+		EXPECT_EQ(std::string_view(destination.GetData(), 10), std::string_view(data).substr(0, 10));
+		EXPECT_EQ(std::string_view(destination.GetData() + 10, 70000), std::string_view(data).substr(4097, 70000));
+		EXPECT_EQ(std::string_view(destination.GetData() + 70010, 100), std::string_view(data).substr(70010, 100));
+
+		ASSERT_TRUE(source.CopyRange(1000, destination, data.size() + 5, 5000, false));
+		ASSERT_GE(destination.GetMappedSize(), data.size() + 5005);
+		EXPECT_EQ(std::string_view(destination.GetData() + data.size() + 5, 5000), std::string_view(data).substr(1000, 5000));
+
+		EXPECT_TRUE(source.CopyRange(data.size(), destination, 0, 0));
+		EXPECT_FALSE(source.CopyRange(data.size() - 10, destination, 0, 11));
+		EXPECT_FALSE(destination.CopyRange(0, destination, 100, 10));
+
+		// Copies between writable views see what has not been flushed yet
+		ASSERT_TRUE(destination.Write("Hello World!"s, 0));
+		FileView copy = FileView::CreateViewForNewFile(TmpDir / "copy.txt", 1).value();
+		ASSERT_TRUE(destination.CopyRange(0, copy, 0, 12));
+		EXPECT_EQ(copy.Read(12), "Hello World!");
+	}
+
+	TEST_F(RapidIOFixture, TestWindowCache)
+	{
+		using namespace rapidio;
+
+		const size_t windowSize = FileView::GetSystemAllocationGranularity();
+		constexpr int nrOfFiles = 6;
+
+		std::vector<std::string> contents;
+		for (int i{}; i < nrOfFiles; ++i)
+		{
+			std::string data(windowSize * 3 + 100 * i + 1, '\0');
+			for (size_t j{}; j < data.size(); ++j)
+			{
+				data[j] = static_cast<char>('a' + (i + j) % 26);
+			}
+
+			FileView::CreateViewForNewFile(TmpDir / ("window" + std::to_string(i) + ".txt"), data.size()).value().Write(data);
+			contents.push_back(std::move(data));
+		}
+
+		WindowCache cache{ { .windowSize = windowSize, .maxMappedBytes = windowSize * 4, .maxWindows = 8, .maxOpenFiles = 2 } };
+		EXPECT_EQ(cache.GetWindowSize(), windowSize);
+		EXPECT_FALSE(cache.AddFile(TmpDir / "missing.txt").has_value());
+
+		std::vector<uint32_t> fileIds;
+		for (int i{}; i < nrOfFiles; ++i)
+		{
+			fileIds.push_back(cache.AddFile(TmpDir / ("window" + std::to_string(i) + ".txt")).value());
+		}
+
+		EXPECT_EQ(cache.GetNrOfOpenFiles(), 0);
+		EXPECT_EQ(cache.GetFileSize(fileIds[2]), contents[2].size());
+
+		for (int i{}; i < nrOfFiles; ++i)
+		{
+			// Spans every window of the file, including the smaller last one
+			std::string buffer(contents[i].size() - 10, '\0');
+			ASSERT_TRUE(cache.Read(fileIds[i], 5, buffer.data(), buffer.size()));
+			EXPECT_EQ(buffer, contents[i].substr(5, buffer.size()));
+
+			EXPECT_LE(cache.GetMappedBytes(), windowSize * 4);
+			EXPECT_LE(cache.GetNrOfOpenFiles(), 2);
+		}
+
+		char byte{};
+		EXPECT_FALSE(cache.Read(fileIds[0], contents[0].size() - 1, &byte, 2));
+		EXPECT_FALSE(cache.Pin(fileIds[0], contents[0].size()).IsValid());
+		EXPECT_FALSE(cache.Pin(nrOfFiles, 0).IsValid());
+
+		{
+			const WindowCache::PinnedWindow window = cache.Pin(fileIds[1], windowSize + 7);
+			ASSERT_TRUE(window.IsValid());
+			EXPECT_EQ(window.GetOffset(), windowSize);
+			EXPECT_EQ(window.GetData(), std::string_view(contents[1]).substr(windowSize, windowSize));
+		}
+
+		// Pinned windows are never evicted, so once the entire budget is pinned nothing else can be mapped
+		{
+			std::vector<WindowCache::PinnedWindow> pinned;
+			for (size_t i{}; i < 3; ++i)
+			{
+				pinned.push_back(cache.Pin(fileIds[3], i * windowSize));
+				ASSERT_TRUE(pinned.back().IsValid());
+			}
+
+			pinned.push_back(cache.Pin(fileIds[4], 0));
+			ASSERT_TRUE(pinned.back().IsValid());
+
+			EXPECT_FALSE(cache.Pin(fileIds[5], 0).IsValid());
+			EXPECT_TRUE(cache.Pin(fileIds[3], 0).IsValid());
+
+			pinned.pop_back();
+			EXPECT_TRUE(cache.Pin(fileIds[5], 0).IsValid());
+		}
+
+		std::vector<std::thread> threads;
+		std::atomic<int> nrOfMismatches{};
+
+		for (int t{}; t < 4; ++t)
+		{
+			threads.emplace_back([&, t]()
+				{
+					std::string buffer;
+					for (size_t i{}; i < 2000; ++i)
+					{
+						const int file = static_cast<int>((i * 7 + t) % nrOfFiles);
+						const size_t offset = (i * 4099 + t * 13) % (contents[file].size() - 200);
+
+						buffer.assign(200, '\0');
+						if (!cache.Read(fileIds[file], offset, buffer.data(), buffer.size()) || buffer != std::string_view(contents[file]).substr(offset, 200))
+						{
+							++nrOfMismatches;
+						}
+					}
+				});
+		}
+
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+
+		EXPECT_EQ(nrOfMismatches, 0);
+		EXPECT_LE(cache.GetMappedBytes(), windowSize * 4);
+		EXPECT_LE(cache.GetNrOfOpenFiles(), 2);
+	}
+
+	TEST_F(RapidIOFixtureBigFile, TestChunks)
+	{
+		static_assert(std::ranges::view<ChunkView<FileAccessMode::ReadOnly>>);
+		static_assert(std::ranges::input_range<ChunkView<FileAccessMode::ReadWrite>>);
+
+		ReadOnlyFileView view = ReadOnlyFileView::CreateViewFromExistingFile(TmpDir / BIG_FILE, FileOpenMode::OpenExisting, 4096).value();
+
+		// Not a multiple of the page size, so chunks start and end inside pages
+		constexpr size_t chunkSize = 1024 * 1024 * 5 + 123;
+		size_t offset{};
+
+		for (const std::span<const char> chunk : view.Chunks(chunkSize))
+		{
+			ASSERT_EQ(chunk.size(), std::min(chunkSize, BigFileData.size() - offset));
+			ASSERT_TRUE(std::string_view(chunk.data(), chunk.size()) == std::string_view(BigFileData).substr(offset, chunkSize));
+			offset += chunk.size();
+		}
+
+		EXPECT_EQ(offset, BigFileData.size());
+
+		// Every call to begin() starts a new scan, and chunks work with the standard range adaptors
+		const ChunkView<FileAccessMode::ReadOnly> chunks = view.Chunks(chunkSize, false);
+		EXPECT_EQ(std::ranges::distance(chunks), static_cast<std::ptrdiff_t>((BigFileData.size() + chunkSize - 1) / chunkSize));
+
+		size_t nrOfBytes{};
+		for (const std::span<const char> chunk : chunks | std::views::take(2))
+		{
+			nrOfBytes += chunk.size();
+		}
+
+		EXPECT_EQ(nrOfBytes, chunkSize * 2);
+
+		EXPECT_TRUE(view.Prefetch({ 0, 4096 }));
+		EXPECT_FALSE(view.Prefetch({ BigFileData.size() + 1, 1 }));
+		EXPECT_TRUE(view.Chunks(0).begin() == std::default_sentinel);
+	}
+
+	TEST_F(RapidIOFixture, TestExternalSort)
+	{
+		using namespace rapidio;
+
+		struct Record
+		{
+			uint64_t key;
+			uint64_t sequence;
+		};
+
+		constexpr size_t nrOfRecords = 200'000;
+
+		std::vector<Record> records(nrOfRecords);
+		uint64_t state = 42;
+		for (size_t i{}; i < nrOfRecords; ++i)
+		{
+			state = state * 6364136223846793005ull + 1442695040888963407ull;
+			records[i] = { (state >> 33) % 5'000, i }; // Plenty of equal keys, to check the sort is stable
+		}
+
+		const fs::path unsortedPath = TmpDir / "records.bin";
+		{
+			FileView unsorted = FileView::CreateViewForNewFile(unsortedPath, sizeof(Record) * nrOfRecords).value();
+			std::memcpy(unsorted.GetData(), records.data(), sizeof(Record) * nrOfRecords);
+		}
+
+		auto getKey = [](std::span<const char> record)
+		{
+			uint64_t key;
+			std::memcpy(&key, record.data(), sizeof(key));
+			return key;
+		};
+
+		auto readRecords = [](const fs::path& path)
+		{
+			ReadOnlyFileView view = ReadOnlyFileView::CreateViewFromExistingFile(path, FileOpenMode::OpenExisting).value();
+			std::vector<Record> result(view.GetMappedSize() / sizeof(Record));
+			std::memcpy(result.data(), view.GetData(), view.GetMappedSize());
+			return result;
+		};
+
+		std::vector<Record> expected = records;
+		std::stable_sort(expected.begin(), expected.end(), [](const Record& lhs, const Record& rhs) { return lhs.key < rhs.key; });
+
+		auto isExpected = [&expected](const std::vector<Record>& sorted)
+		{
+			return sorted.size() == expected.size() && std::equal(sorted.begin(), sorted.end(), expected.begin(),
+				[](const Record& lhs, const Record& rhs) { return lhs.key == rhs.key && lhs.sequence == rhs.sequence; });
+		};
+
+		// A budget this small forces many runs, which are radix sorted in parallel and merged
+		const fs::path radixSortedPath = TmpDir / "radix.bin";
+		ASSERT_TRUE(ExternalSort(unsortedPath, sizeof(Record), getKey, 1024 * 1024 * 2, { .outputPath = radixSortedPath, .nrOfThreads = 4 }));
+		EXPECT_TRUE(isExpected(readRecords(radixSortedPath)));
+
+		// Keys that are not unsigned integers are sorted by comparison, here every run fits in the budget at once
+		auto getBytesKey = [](std::span<const char> record)
+		{
+			std::array<unsigned char, 8> key;
+			for (size_t i{}; i < key.size(); ++i)
+			{
+				key[i] = static_cast<unsigned char>(record[key.size() - 1 - i]); // Big-endian, so it orders like the integer
+			}
+
+			return key;
+		};
+
+		const fs::path comparisonSortedPath = TmpDir / "comparison.bin";
+		ASSERT_TRUE(ExternalSort(unsortedPath, sizeof(Record), getBytesKey, 1024 * 1024 * 512, { .outputPath = comparisonSortedPath }));
+		EXPECT_TRUE(isExpected(readRecords(comparisonSortedPath)));
+
+		// Without an output path the file is sorted in place
+		ASSERT_TRUE(ExternalSort(unsortedPath, sizeof(Record), getKey, 1024 * 1024 * 4, { .nrOfThreads = 2 }));
+		EXPECT_TRUE(isExpected(readRecords(unsortedPath)));
+
+		EXPECT_FALSE(ExternalSort(unsortedPath, sizeof(Record) + 1, getKey, 1024 * 1024));
+		EXPECT_FALSE(ExternalSort(unsortedPath, 0, getKey, 1024 * 1024));
+		EXPECT_FALSE(ExternalSort(unsortedPath, sizeof(Record), getKey, 1024 * 16));
+		EXPECT_FALSE(ExternalSort(TmpDir / NON_EXISTING_FILE, sizeof(Record), getKey, 1024 * 1024));
+
+		// Runs and partially sorted files never outlive the sort
+		size_t nrOfFiles{};
+		for ([[maybe_unused]] const fs::directory_entry& entry : fs::directory_iterator{ TmpDir.GetPath() })
+		{
+			++nrOfFiles;
+		}
+
+		EXPECT_EQ(nrOfFiles, 4); // SimpleFile.txt, records.bin, radix.bin and comparison.bin
+	}
+
+	TEST_F(RapidIOFixture, TestPackFile)
+	{
+		using namespace rapidio;
+
+		const fs::path packPath = TmpDir / "assets.pack";
+		constexpr int nrOfEntries = 5'000;
+
+		auto getName = [](int i) { return "config/" + std::to_string(i) + ".json"; };
+		auto getData = [](int i) { return std::string(static_cast<size_t>(i % 97), static_cast<char>('a' + i % 26)); };
+
+		// Larger than the pending data, so it is written straight from the mapped file
+		const std::string largeData(1024 * 1024 * 5, 'x');
+		{
+			FileView largeFile = FileView::CreateViewForNewFile(TmpDir / "model.bin", largeData.size()).value();
+			largeFile.Write(largeData);
+		}
+
+		{
+			EXPECT_FALSE(PackWriter::Create(packPath, { .alignment = 48 }).has_value());
+
+			PackWriter writer = PackWriter::Create(packPath, { .alignment = 16 }).value();
+			for (int i{}; i < nrOfEntries; ++i)
+			{
+				ASSERT_TRUE(writer.Add(getName(i), getData(i)));
+			}
+
+			EXPECT_FALSE(writer.Add(getName(42), "duplicate"));
+			EXPECT_TRUE(writer.AddFile("models/model.bin", TmpDir / "model.bin"));
+			EXPECT_FALSE(writer.AddFile("models/missing.bin", TmpDir / NON_EXISTING_FILE));
+			EXPECT_TRUE(writer.AddFile("hello.txt", TmpDir / SIMPLE_FILE));
+
+			EXPECT_EQ(writer.GetNrOfEntries(), nrOfEntries + 2);
+			ASSERT_TRUE(writer.Finish());
+			EXPECT_FALSE(writer.Add("late.txt", "too late"));
+		}
+
+		const PackReader reader = PackReader::Open(packPath).value();
+		ASSERT_EQ(reader.GetNrOfEntries(), nrOfEntries + 2);
+
+		for (int i{}; i < nrOfEntries; ++i)
+		{
+			const std::optional<std::string_view> data = reader.Get(getName(i));
+			ASSERT_TRUE(data.has_value());
+			EXPECT_EQ(*data, getData(i));
+			EXPECT_EQ(reinterpret_cast<uintptr_t>(data->data()) % 16, 0);
+		}
+
+		EXPECT_EQ(reader.Get("models/model.bin"), largeData);
+		EXPECT_EQ(reader.Get("hello.txt"), "Hello World!");
+		EXPECT_EQ(reader.GetEntry(1), (PackEntry{ getName(1), getData(1) }));
+		EXPECT_EQ(reader.GetEntry(nrOfEntries + 1).name, "hello.txt");
+
+		for (int i = nrOfEntries; i < nrOfEntries * 2; ++i)
+		{
+			EXPECT_FALSE(reader.Contains(getName(i)));
+		}
+
+		EXPECT_FALSE(reader.Contains("models/missing.bin"));
+		EXPECT_FALSE(reader.Contains(""));
+
+		// An empty pack is still a valid pack
+		const fs::path emptyPackPath = TmpDir / "empty.pack";
+		ASSERT_TRUE(PackWriter::Create(emptyPackPath).value().Finish());
+		const PackReader emptyReader = PackReader::Open(emptyPackPath).value();
+		EXPECT_EQ(emptyReader.GetNrOfEntries(), 0);
+		EXPECT_FALSE(emptyReader.Get("config/0.json").has_value());
+
+		EXPECT_FALSE(PackReader::Open(TmpDir / SIMPLE_FILE).has_value());
+		EXPECT_FALSE(PackReader::Open(TmpDir / NON_EXISTING_FILE).has_value());
+	}
+
+	TEST_F(RapidIOFixture, TestPackFileCorruptFooter)
+	{
+		const fs::path packPath = TmpDir / "assets.pack";
+		{
+			PackWriter writer = PackWriter::Create(packPath).value();
+			ASSERT_TRUE(writer.Add("a.txt", "first"));
+			ASSERT_TRUE(writer.Add("b.txt", "second"));
+			ASSERT_TRUE(writer.Finish());
+		}
+
+		ASSERT_TRUE(PackReader::Open(packPath).has_value());
+
+		// Opens a copy of the pack with 'corrupt' applied to its footer
+		auto openCorrupted = [&](const std::function<void(detail::PackFooter&)>& corrupt)
+			{
+				const fs::path corruptPath = TmpDir / "corrupt.pack";
+				fs::copy_file(packPath, corruptPath, fs::copy_options::overwrite_existing);
+				{
+					FileView view = FileView::CreateViewFromExistingFile(corruptPath, FileAccessMode::ReadWrite, FileOpenMode::OpenExisting).value();
+					char* const footerData = view.GetData() + view.GetMappedSize() - sizeof(detail::PackFooter);
+
+					detail::PackFooter footer;
+					std::memcpy(&footer, footerData, sizeof(footer));
+					corrupt(footer);
+					std::memcpy(footerData, &footer, sizeof(footer));
+				}
+
+				return PackReader::Open(corruptPath);
+			};
+
+		// Moving every table by 2^63 still satisfies sums that wrap around
+		constexpr uint64_t halfRange = uint64_t{ 1 } << 63;
+		EXPECT_FALSE(openCorrupted([](detail::PackFooter& footer)
+			{
+				footer.entriesOffset += halfRange;
+				footer.slotsOffset += halfRange;
+				footer.displacementsOffset += halfRange;
+				footer.namesOffset += halfRange;
+				footer.namesSize -= halfRange;
+			}).has_value());
+
+		EXPECT_FALSE(openCorrupted([](detail::PackFooter& footer) { footer.namesSize = std::numeric_limits<uint64_t>::max(); }).has_value());
+		EXPECT_FALSE(openCorrupted([](detail::PackFooter& footer) { footer.entriesOffset = std::numeric_limits<uint64_t>::max() - 7; }).has_value());
+		EXPECT_FALSE(openCorrupted([](detail::PackFooter& footer) { footer.nrOfSlots += 1; }).has_value());
+		EXPECT_TRUE(openCorrupted([](detail::PackFooter&) {}).has_value());
+	}
+
+	TEST_F(RapidIOFixture, TestValidateUtf8)
+	{
+		using namespace rapidio;
+
+		// Decodes every code point, independently of the lookup tables of the SIMD validator
+		auto findInvalid = [](std::string_view text) -> size_t
+		{
+			for (size_t position{}; position < text.size();)
+			{
+				const unsigned char lead = static_cast<unsigned char>(text[position]);
+				const size_t length = lead < 0x80 ? 1 : lead >= 0xC2 && lead <= 0xDF ? 2 : lead >= 0xE0 && lead <= 0xEF ? 3 : lead >= 0xF0 && lead <= 0xF4 ? 4 : 0;
+				if (length == 0 || text.size() - position < length)
+				{
+					return position;
+				}
+
+				uint32_t codePoint = length == 1 ? lead : lead & (0x7F >> length);
+				for (size_t i{ 1 }; i < length; ++i)
+				{
+					const unsigned char byte = static_cast<unsigned char>(text[position + i]);
+					if ((byte & 0xC0) != 0x80)
+					{
+						return position;
+					}
+
+					codePoint = (codePoint << 6) | (byte & 0x3F);
+				}
+
+				constexpr uint32_t minCodePoints[]{ 0, 0, 0x80, 0x800, 0x10000 };
+				if (codePoint < minCodePoints[length] || (codePoint >= 0xD800 && codePoint <= 0xDFFF) || codePoint > 0x10FFFF)
+				{
+					return position;
+				}
+
+				position += length;
+			}
+
+			return std::string_view::npos;
+		};
+
+		EXPECT_EQ(FindInvalidUtf8(""), std::string_view::npos);
+		EXPECT_EQ(FindInvalidUtf8("Hello World!"), std::string_view::npos);
+		EXPECT_EQ(FindInvalidUtf8("h\xC3\xA9llo \xE2\x82\xAC \xF0\x9F\x98\x80"), std::string_view::npos);
+		EXPECT_EQ(FindInvalidUtf8("ab\xC0\xAF"), 2); // Overlong
+		EXPECT_EQ(FindInvalidUtf8("a\xED\xA0\x80"), 1); // Surrogate
+		EXPECT_EQ(FindInvalidUtf8("\xF4\x90\x80\x80"), 0); // Past U+10FFFF
+		EXPECT_EQ(FindInvalidUtf8("abc\xE2\x82"), 3); // Cut off
+		EXPECT_EQ(FindInvalidUtf8("abc\x80"), 3); // Stray continuation
+
+		// Random text of every sequence length, with a few random bytes overwritten, long enough to cross several SIMD blocks
+		const std::string_view pieces[]{ "a", "Z", "\xC3\xA9", "\xDF\xBF", "\xE2\x82\xAC", "\xED\x9F\xBF", "\xEF\xBF\xBF", "\xF0\x9F\x98\x80", "\xF4\x8F\xBF\xBF" };
+		uint64_t state = 42;
+		auto random = [&state]()
+		{
+			state = state * 6364136223846793005ull + 1442695040888963407ull;
+			return static_cast<size_t>(state >> 33);
+		};
+
+		for (int i{}; i < 5'000; ++i)
+		{
+			std::string text;
+			const size_t nrOfPieces = random() % 100;
+			for (size_t j{}; j < nrOfPieces; ++j)
+			{
+				text += pieces[random() % std::size(pieces)];
+			}
+
+			for (size_t j = random() % 3; j > 0 && !text.empty(); --j)
+			{
+				text[random() % text.size()] = static_cast<char>(random() % 256);
+			}
+
+			ASSERT_EQ(FindInvalidUtf8(text), findInvalid(text)) << "Iteration " << i;
+		}
+
+		// Sequences cross the boundaries of the chunks that are validated in parallel
+		std::string text;
+		while (text.size() < 1024 * 1024 * 3)
+		{
+			text += "a\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80";
+		}
+
+		{
+			FileView view = FileView::CreateViewForNewFile(TmpDir / "utf8.txt", text.size()).value();
+			view.Write(text);
+
+			EXPECT_EQ(view.ValidateUtf8(), std::nullopt);
+			EXPECT_EQ(view.ValidateUtf8({}, 4), std::nullopt);
+			EXPECT_EQ(view.ValidateUtf8({ 1, 1024 * 1024 * 2 }, 4), std::nullopt);
+			EXPECT_EQ(view.ValidateUtf8({ 2, 100 }), 2); // Starts in the middle of a sequence
+
+			// Errors in several chunks, on and next to a chunk boundary, only the first counts
+			for (const size_t offset : { 1024 * 1024 * 2 + 3, 1024 * 1024 * 2 - 1, 1024 * 1024 + 1 })
+			{
+				text[offset] = '\xFF';
+				view.Write(std::string(1, '\xFF'), offset);
+
+				EXPECT_EQ(view.ValidateUtf8({}, 4), findInvalid(text));
+			}
+
+			EXPECT_EQ(view.ValidateUtf8({ 1024 * 1024 * 2, 1024 * 1024 }, 4), 1024 * 1024 * 2 + findInvalid(std::string_view(text).substr(1024 * 1024 * 2)));
+			EXPECT_EQ(view.ValidateUtf8({ text.size() + 1, 10 }), text.size() + 1);
+		}
+	}
+
+	TEST_F(RapidIOFixture, TestNormalizeLineEndings)
+	{
+		using namespace rapidio;
+
+		// Line endings cross the boundaries of the chunks that are normalized in parallel, some CRs are not part of a line ending
+		std::string text;
+		for (int i{}; text.size() < 1024 * 1024 * 3; ++i)
+		{
+			text += "line " + std::to_string(i) + (i % 7 == 0 ? "\r" : "") + (i % 13 == 0 ? "\n" : "\r\n");
+		}
+
+		text += "\r";
+
+		std::string expected;
+		for (size_t i{}; i < text.size(); ++i)
+		{
+			if (text[i] != '\r' || i + 1 == text.size() || text[i + 1] != '\n')
+			{
+				expected += text[i];
+			}
+		}
+
+		ReadOnlyFileView source = [&]()
+		{
+			FileView::CreateViewForNewFile(TmpDir / "crlf.txt", text.size()).value().Write(text);
+			return ReadOnlyFileView::CreateViewFromExistingFile(TmpDir / "crlf.txt", FileOpenMode::OpenExisting).value();
+		}();
+
+		{
+			FileView destination = FileView::CreateViewForNewFile(TmpDir / "lf.txt", 1).value();
+			EXPECT_EQ(source.NormalizeLineEndings(destination, 0, {}, 4), expected.size());
+			EXPECT_EQ(std::string_view(destination.GetData(), expected.size()), expected);
+		}
+
+		EXPECT_EQ(fs::file_size(TmpDir / "lf.txt"), expected.size());
+
+		{
+			// A CRLF split by the end of the range keeps its CR
+			FileView destination = FileView::CreateViewForNewFile(TmpDir / "prefix.txt", 1).value();
+			EXPECT_EQ(source.NormalizeLineEndings(destination, 5, { 0, 7 }), 7);
+			EXPECT_EQ(std::string_view(destination.GetData() + 5, 7), "line 0\r");
+			EXPECT_EQ(source.NormalizeLineEndings(destination, 5, { 0, 8 }), 7);
+			EXPECT_EQ(std::string_view(destination.GetData() + 5, 7), "line 0\n");
+
+			EXPECT_EQ(source.NormalizeLineEndings(destination, 0, { text.size() - 1, 1 }), 1);
+			EXPECT_EQ(source.NormalizeLineEndings(destination, 0, { text.size(), 1 }), 0);
+			EXPECT_FALSE(source.NormalizeLineEndings(destination, 0, { text.size() + 1, 1 }).has_value());
+		}
+	}
 }
\ No newline at end of file
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstdint>
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+#ifdef _WIN32
+#	define WIN32_LEAN_AND_MEAN
+#	include <Windows.h>
+#	include <psapi.h>
+#endif // _WIN32
+
+// Counters of the whole process, so work done on helper threads is included
+struct PerfCounterValues
+{
+	uint64_t PageFaults = 0;
+	uint64_t Cycles = 0;
+};
+
+// Samples counters around every run of a benchmark case and sums them, so they can be reported per MB processed.
+// Windows gives user mode no access to the PMU, so instructions, dTLB and LLC misses cannot be sampled, and page faults are soft and hard faults combined
+class PerfCounters
+{
+public:
+	explicit PerfCounters(bool InEnabled)
+		: Enabled(InEnabled)
+	{
+	}
+
+	bool IsEnabled() const
+	{
+		return Enabled;
+	}
+
+	void Reset()
+	{
+		Total = {};
+		Available = true;
+	}
+
+	void Start()
+	{
+		if (Enabled)
+		{
+			Available = Sample(StartValues) && Available;
+		}
+	}
+
+	void Stop()
+	{
+		PerfCounterValues StopValues;
+		if (!Enabled || !Sample(StopValues))
+		{
+			Available = false;
+			return;
+		}
+
+		Total.PageFaults += StopValues.PageFaults - StartValues.PageFaults;
+		Total.Cycles += StopValues.Cycles - StartValues.Cycles;
+	}
+
+	// Returns an empty string if counters are disabled
+	std::string Report(uint64_t BytesProcessed) const
+	{
+		if (!Enabled)
+		{
+			return {};
+		}
+
+		if (!Available || BytesProcessed == 0)
+		{
+			return "    Counters: unavailable\n";
+		}
+
+		const double MegaBytes = static_cast<double>(BytesProcessed) / (1024 * 1024);
+
+		std::ostringstream Stream;
+		Stream << std::fixed << std::setprecision(2)
+			<< "    Counters per MB: " << Total.PageFaults / MegaBytes << " page faults, "
+			<< Total.Cycles / MegaBytes << " cycles (" << static_cast<double>(Total.Cycles) / BytesProcessed << " cycles/byte)"
+			<< " | instructions, dTLB and LLC misses: unavailable\n";
+
+		return Stream.str();
+	}
+
+private:
+	static bool Sample(PerfCounterValues& Values)
+	{
+		#ifdef _WIN32
+		PROCESS_MEMORY_COUNTERS MemoryCounters{};
+		ULONG64 CycleTime{};
+
+		if (!GetProcessMemoryInfo(GetCurrentProcess(), &MemoryCounters, sizeof(MemoryCounters)) || !QueryProcessCycleTime(GetCurrentProcess(), &CycleTime))
+		{
+			return false;
+		}
+
+		Values.PageFaults = MemoryCounters.PageFaultCount;
+		Values.Cycles = CycleTime;
+		return true;
+		#else
+		static_cast<void>(Values);
+		return false;
+		#endif // _WIN32
+	}
+
+	bool Enabled;
+	bool Available = true;
+	PerfCounterValues StartValues;
+	PerfCounterValues Total;
+};